@@ -321,6 +321,7 @@ LOCAL_MODULE_STEM := kfld
 LOCAL_C_INCLUDES += $(addprefix $(LOCAL_PATH)/,avb)
 LOCAL_C_INCLUDES += $(addprefix $(LOCAL_PATH)/,avb/libavb)
 LOCAL_C_INCLUDES += $(addprefix $(LOCAL_PATH)/,avb/libavb_ab)
+LOCAL_C_INCLUDES += $(addprefix $(LOCAL_PATH)/,libkernelflinger/fatfs/source)
 ifeq ($(TARGET_UEFI_ARCH),x86_64)
     ELF_OUTPUT := elf64-x86-64
 else
@@ -421,6 +422,8 @@ LOCAL_C_INCLUDES += \
 
 LOCAL_C_INCLUDES += \
 	$(addprefix $(LOCAL_PATH)/,libsslsupport)
+LOCAL_C_INCLUDES += \
+	$(addprefix $(LOCAL_PATH)/,libxbc)
 include $(BUILD_SBL_EXECUTABLE)
 
 include $(CLEAR_VARS)
@@ -475,6 +478,8 @@ LOCAL_C_INCLUDES += \
 
 LOCAL_C_INCLUDES += \
 	$(addprefix $(LOCAL_PATH)/,libsslsupport)
+LOCAL_C_INCLUDES += \
+	$(addprefix $(LOCAL_PATH)/,libxbc)
 include $(BUILD_SBL_EXECUTABLE)
 
 endif  #KERNELFLINGER_SUPPORT_NON_EFI_BOOT
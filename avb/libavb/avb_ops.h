@@ -308,6 +308,38 @@ struct AvbOps {
                                         const char* name,
                                         size_t value_size,
                                         const uint8_t* value);
+
+  /* Checks whether the first |image_size| bytes of the partition
+   * |partition| (NUL-terminated UTF-8 string, including any A/B
+   * suffix) are known to hash to the |digest_size| bytes |digest|
+   * because they have been verified and not written since. The
+   * result is returned in |out_is_cached|.
+   *
+   * When the digest is cached, the hash of the partition data is
+   * not computed again; the vbmeta signature is still verified.
+   * Implementations must never report a cached digest on a locked
+   * device.
+   *
+   * This function pointer can be set to NULL.
+   */
+  AvbIOResult (*read_cached_digest)(AvbOps* ops,
+                                    const char* partition,
+                                    uint64_t image_size,
+                                    const uint8_t* digest,
+                                    size_t digest_size,
+                                    bool* out_is_cached);
+
+  /* Records that the first |image_size| bytes of the partition
+   * |partition| have been verified to hash to the |digest_size|
+   * bytes |digest|.
+   *
+   * This function pointer can be set to NULL.
+   */
+  AvbIOResult (*write_cached_digest)(AvbOps* ops,
+                                     const char* partition,
+                                     uint64_t image_size,
+                                     const uint8_t* digest,
+                                     size_t digest_size);
 };
 
 #ifdef __cplusplus
@@ -386,6 +386,24 @@ static AvbSlotVerifyResult load_and_verify_hash_partition(
     goto out;
   }
 
+  /* Persistent digests are not part of the signed metadata, only
+   * consult the cache for digests found in the descriptor.
+   */
+  if (hash_desc.digest_len != 0 && ops->read_cached_digest != NULL) {
+    bool is_cached = false;
+    io_ret = ops->read_cached_digest(ops,
+                                     part_name,
+                                     hash_desc.image_size,
+                                     desc_digest,
+                                     hash_desc.digest_len,
+                                     &is_cached);
+    if (io_ret == AVB_IO_RESULT_OK && is_cached) {
+      avb_debugv(part_name, ": Digest is cached, skipping hash.\n", NULL);
+      ret = AVB_SLOT_VERIFY_RESULT_OK;
+      goto out;
+    }
+  }
+
   if (avb_strcmp((const char*)hash_desc.hash_algorithm, "sha256") == 0) {
     AvbSHA256Ctx sha256_ctx;
     avb_sha256_init(&sha256_ctx);
@@ -441,6 +459,11 @@ static AvbSlotVerifyResult load_and_verify_hash_partition(
     goto out;
   }
 
+  if (hash_desc.digest_len != 0 && ops->write_cached_digest != NULL) {
+    ops->write_cached_digest(
+        ops, part_name, hash_desc.image_size, digest, digest_len);
+  }
+
   ret = AVB_SLOT_VERIFY_RESULT_OK;
 
 out:
@@ -31,6 +31,7 @@
 #include "lib.h"
 #include "log.h"
 #include "security.h"
+#include "digest_cache.h"
 #ifdef USE_TPM
 #include "tpm2_security.h"
 #endif
@@ -307,6 +308,31 @@ static AvbIOResult read_is_device_unlocked(__attribute__((unused)) AvbOps* ops,
   return AVB_IO_RESULT_OK;
 }
 
+static AvbIOResult read_cached_digest(__attribute__((unused)) AvbOps* ops,
+                                      const char* partition,
+                                      uint64_t image_size,
+                                      const uint8_t* digest,
+                                      size_t digest_size,
+                                      bool* out_is_cached) {
+  *out_is_cached = digest_cache_lookup(partition, image_size,
+                                       digest, digest_size);
+  return AVB_IO_RESULT_OK;
+}
+
+static AvbIOResult write_cached_digest(__attribute__((unused)) AvbOps* ops,
+                                       const char* partition,
+                                       uint64_t image_size,
+                                       const uint8_t* digest,
+                                       size_t digest_size) {
+  EFI_STATUS ret;
+
+  ret = digest_cache_store(partition, image_size, digest, digest_size);
+  if (EFI_ERROR(ret)) {
+    return AVB_IO_RESULT_ERROR_IO;
+  }
+  return AVB_IO_RESULT_OK;
+}
+
 static void set_hex(char* buf, uint8_t value) {
   char hex_digits[17] = "0123456789abcdef";
   buf[0] = hex_digits[value >> 4];
@@ -394,7 +420,12 @@ AvbOps* uefi_avb_ops_new(void) {
       return NULL;
   }
 
-  data = avb_calloc(sizeof(UEFIAvbOpsData));
+  /* The AvbOps are cached and outlive the boot-scoped arena. */
+  data = AllocateZeroPool(sizeof(UEFIAvbOpsData));
+  if (!data) {
+      avb_error("Failed to allocate AvbOps.\n");
+      return NULL;
+  }
   data->ops.user_data = data;
   data->ops.ab_ops = NULL;
   data->block_io = gparti.bio;
@@ -407,11 +438,13 @@ AvbOps* uefi_avb_ops_new(void) {
   data->ops.write_rollback_index = write_rollback_index;
   data->ops.read_is_device_unlocked = read_is_device_unlocked;
   data->ops.get_unique_guid_for_partition = get_unique_guid_for_partition;
+  data->ops.read_cached_digest = read_cached_digest;
+  data->ops.write_cached_digest = write_cached_digest;
 
   return &data->ops;
 }
 
 void uefi_avb_ops_free(AvbOps* ops) {
   UEFIAvbOpsData* data = ops->user_data;
-  avb_free(data);
+  FreePool(data);
 }
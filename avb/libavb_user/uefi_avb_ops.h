@@ -41,4 +41,11 @@ AvbOps* uefi_avb_ops_new(void);
 /* Frees the AvbOps allocated with uefi_avb_ops_new(). */
 void uefi_avb_ops_free(AvbOps* ops);
 
+/* Serves the libavb allocations from a boot-scoped arena until
+ * avb_arena_release() is called.  Nothing allocated by libavb in the
+ * meantime may be used after the release. */
+EFI_STATUS avb_arena_init(void);
+void avb_arena_release(void);
+UINTN avb_arena_high_water(void);
+
 #endif /* UEFI_AVB_OPS_H_ */
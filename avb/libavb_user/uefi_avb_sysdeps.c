@@ -28,6 +28,7 @@
 
 #include <libavb/libavb.h>
 
+#include "uefi_avb_ops.h"
 #include "uefi_avb_util.h"
 #include "lib.h"
 #include "log.h"
@@ -105,10 +106,95 @@ void avb_printv_ui(const char* message, ...) {
 }
 #endif
 
+/* Boot-scoped arena.
+ *
+ * libavb makes many small allocations (vbmeta copies, descriptors,
+ * command line fragments, slot data) which live until the kernel is
+ * started or the boot fails.  While the arena is active they are served
+ * by a bump allocator reserved once with AllocatePages() and released in
+ * one step by avb_arena_release().  Requests larger than
+ * AVB_ARENA_MAX_ALLOC, such as loaded partitions, or which do not fit
+ * anymore go to the pool.  The arena is EfiBootServicesData memory so
+ * the OS reclaims it at handover like the pool.
+ */
+#ifndef AVB_ARENA_PAGES
+#define AVB_ARENA_PAGES 256
+#endif
+#define AVB_ARENA_MAX_ALLOC (64 * 1024)
+#define AVB_ARENA_ALIGN 16
+
+static struct {
+  EFI_PHYSICAL_ADDRESS base;
+  UINTN size;
+  UINTN top;
+  UINTN last;
+  UINTN high_water;
+} arena;
+
+static bool in_arena(void* ptr) {
+  return arena.base && (UINTN)ptr >= arena.base &&
+         (UINTN)ptr < arena.base + arena.size;
+}
+
+EFI_STATUS avb_arena_init(void) {
+  EFI_STATUS err;
+
+  if (arena.base) {
+    return EFI_ALREADY_STARTED;
+  }
+
+  err = uefi_call_wrapper(BS->AllocatePages, 4, AllocateAnyPages,
+                          EfiBootServicesData, AVB_ARENA_PAGES, &arena.base);
+  if (EFI_ERROR(err)) {
+    arena.base = 0;
+    return err;
+  }
+
+  arena.size = EFI_PAGES_TO_SIZE(AVB_ARENA_PAGES);
+  arena.top = 0;
+  arena.last = arena.size;
+  arena.high_water = 0;
+  return EFI_SUCCESS;
+}
+
+void avb_arena_release(void) {
+  if (!arena.base) {
+    return;
+  }
+
+  debug(L"avb arena high-water mark: %ld/%ld bytes",
+        arena.high_water, arena.size);
+  uefi_call_wrapper(BS->FreePages, 2, arena.base, AVB_ARENA_PAGES);
+  arena.base = 0;
+}
+
+UINTN avb_arena_high_water(void) {
+  return arena.high_water;
+}
+
+static void* arena_alloc(size_t size) {
+  UINTN top = (arena.top + AVB_ARENA_ALIGN - 1) & ~(UINTN)(AVB_ARENA_ALIGN - 1);
+
+  if (!arena.base || size > AVB_ARENA_MAX_ALLOC ||
+      size > arena.size - min(top, arena.size)) {
+    return NULL;
+  }
+
+  arena.last = top;
+  arena.top = top + size;
+  arena.high_water = max(arena.high_water, arena.top);
+  return (void*)(UINTN)(arena.base + top);
+}
+
 void* avb_malloc_(size_t size) {
   EFI_STATUS err;
   void* x;
 
+  x = arena_alloc(size);
+  if (x) {
+    return x;
+  }
+
   err = uefi_call_wrapper(
       BS->AllocatePool, 3, EfiBootServicesData, (UINTN)size, &x);
   if (EFI_ERROR(err)) {
@@ -120,6 +206,16 @@ void* avb_malloc_(size_t size) {
 
 void avb_free(void* ptr) {
   EFI_STATUS err;
+
+  if (in_arena(ptr)) {
+    /* Only the most recent allocation can be given back */
+    if ((UINTN)ptr == arena.base + arena.last) {
+      arena.top = arena.last;
+      arena.last = arena.size;
+    }
+    return;
+  }
+
   err = uefi_call_wrapper(BS->FreePool, 1, ptr);
 
   if (EFI_ERROR(err)) {
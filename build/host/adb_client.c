@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/*
+ * Host adb client, see adb_client.h.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "adb_client.h"
+
+#define MKID(a, b, c, d) ((a) | ((b) << 8) | ((c) << 16) | ((d) << 24))
+
+#define A_CNXN MKID('C', 'N', 'X', 'N')
+#define A_OPEN MKID('O', 'P', 'E', 'N')
+#define A_OKAY MKID('O', 'K', 'A', 'Y')
+#define A_CLSE MKID('C', 'L', 'S', 'E')
+#define A_WRTE MKID('W', 'R', 'T', 'E')
+
+#define ID_RECV MKID('R', 'E', 'C', 'V')
+#define ID_DATA MKID('D', 'A', 'T', 'A')
+#define ID_DONE MKID('D', 'O', 'N', 'E')
+
+/* The checksum is not used from this version on */
+#define ADB_VERSION 0x01000001
+#define MAX_PAYLOAD (256 * 1024)
+/* Size of the device input buffer, see ADB_MIN_PAYLOAD */
+#define DEVICE_MAX_PAYLOAD 4096
+
+/* Local identifier of the only stream */
+#define LOCAL_ID 1
+
+/* A device which does not answer is a failure, not a hang */
+#define RECV_TIMEOUT_S 10
+
+struct adb_msg {
+	uint32_t command;
+	uint32_t arg0;
+	uint32_t arg1;
+	uint32_t data_length;
+	uint32_t data_check;
+	uint32_t magic;
+};
+
+static unsigned char payload[MAX_PAYLOAD];
+
+static int write_all(int fd, const void *buf, size_t size)
+{
+	const char *p = buf;
+	ssize_t len;
+
+	for (; size; size -= len, p += len) {
+		len = write(fd, p, size);
+		if (len <= 0)
+			return -1;
+	}
+	return 0;
+}
+
+static int read_all(int fd, void *buf, size_t size)
+{
+	char *p = buf;
+	ssize_t len;
+
+	for (; size; size -= len, p += len) {
+		len = read(fd, p, size);
+		if (len <= 0)
+			return -1;
+	}
+	return 0;
+}
+
+static int send_msg(int fd, uint32_t command, uint32_t arg0, uint32_t arg1,
+		    const void *data, size_t size)
+{
+	struct adb_msg msg = {
+		.command = command,
+		.arg0 = arg0,
+		.arg1 = arg1,
+		.data_length = size,
+		.magic = command ^ 0xffffffff
+	};
+	const unsigned char *p = data;
+	size_t i;
+
+	for (i = 0; i < size; i++)
+		msg.data_check += p[i];
+
+	if (write_all(fd, &msg, sizeof(msg)))
+		return -1;
+	return size ? write_all(fd, data, size) : 0;
+}
+
+/* Receive one message, its payload goes to the payload buffer */
+static int recv_msg(int fd, struct adb_msg *msg)
+{
+	if (read_all(fd, msg, sizeof(*msg)) ||
+	    msg->magic != (msg->command ^ 0xffffffff) ||
+	    msg->data_length > sizeof(payload))
+		return -1;
+
+	return read_all(fd, payload, msg->data_length);
+}
+
+int adb_connect(const char *path, int timeout_ms)
+{
+	static const char BANNER[] = "host::";
+	struct sockaddr_un addr = { .sun_family = AF_UNIX };
+	struct timeval tv = { .tv_sec = RECV_TIMEOUT_S };
+	struct adb_msg msg;
+	int fd;
+
+	if (strlen(path) >= sizeof(addr.sun_path))
+		return -1;
+	strcpy(addr.sun_path, path);
+
+	for (;;) {
+		fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0)
+			return -1;
+		if (!connect(fd, (struct sockaddr *)&addr, sizeof(addr)))
+			break;
+		close(fd);
+		if (timeout_ms <= 0)
+			return -1;
+		usleep(10 * 1000);
+		timeout_ms -= 10;
+	}
+
+	if (setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) ||
+	    send_msg(fd, A_CNXN, ADB_VERSION, MAX_PAYLOAD, BANNER, sizeof(BANNER)) ||
+	    recv_msg(fd, &msg) || msg.command != A_CNXN) {
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+void adb_disconnect(int fd)
+{
+	close(fd);
+}
+
+/* Open SERVICE and return the remote identifier of the stream, 0 if
+ * the device refused it or -1 on error */
+static long open_stream(int fd, const char *service)
+{
+	struct adb_msg msg;
+
+	if (send_msg(fd, A_OPEN, LOCAL_ID, 0, service, strlen(service) + 1) ||
+	    recv_msg(fd, &msg) || msg.arg1 != LOCAL_ID)
+		return -1;
+
+	if (msg.command == A_CLSE)
+		return 0;
+	return msg.command == A_OKAY ? (long)msg.arg0 : -1;
+}
+
+static int close_stream(int fd, uint32_t remote)
+{
+	return send_msg(fd, A_CLSE, LOCAL_ID, remote, NULL, 0);
+}
+
+/* Receive the next message of the stream, acknowledging its data.
+ * Return the message command or -1. */
+static long recv_stream(int fd, uint32_t remote, struct adb_msg *msg)
+{
+	if (recv_msg(fd, msg) || msg->arg1 != LOCAL_ID ||
+	    (msg->command != A_CLSE && msg->arg0 != remote))
+		return -1;
+
+	if (msg->command == A_WRTE &&
+	    send_msg(fd, A_OKAY, LOCAL_ID, remote, NULL, 0))
+		return -1;
+
+	return msg->command;
+}
+
+int adb_shell(int fd, const char *command, char *out, size_t size)
+{
+	char service[DEVICE_MAX_PAYLOAD];
+	struct adb_msg msg;
+	size_t len = 0, n;
+	long remote, cmd;
+
+	if (!size || snprintf(service, sizeof(service), "shell:%s", command) >= (int)sizeof(service))
+		return -1;
+
+	remote = open_stream(fd, service);
+	if (remote <= 0)
+		return -1;
+
+	while ((cmd = recv_stream(fd, remote, &msg)) == A_WRTE) {
+		n = msg.data_length < size - 1 - len ? msg.data_length : size - 1 - len;
+		memcpy(out + len, payload, n);
+		len += n;
+	}
+	out[len] = '\0';
+
+	if (cmd != A_CLSE || close_stream(fd, remote))
+		return -1;
+	return len;
+}
+
+/* The sync service answers a RECV request with a stream of DATA
+ * chunks, each a header followed by its data, terminated by DONE.
+ * The stream is cut into WRTE messages without regard for the chunk
+ * boundaries. */
+struct sync_stream {
+	unsigned char header[8];
+	size_t header_len;
+	size_t data_left;
+	unsigned char *buf;
+	size_t size;
+	size_t len;
+	int done;
+};
+
+static int sync_parse(struct sync_stream *st, const unsigned char *p, size_t n)
+{
+	uint32_t id, size;
+	size_t chunk, copy;
+
+	while (n && !st->done) {
+		if (st->data_left) {
+			chunk = n < st->data_left ? n : st->data_left;
+			copy = st->len < st->size ? st->size - st->len : 0;
+			copy = chunk < copy ? chunk : copy;
+			memcpy(st->buf + st->len, p, copy);
+			st->len += chunk;
+			st->data_left -= chunk;
+			p += chunk;
+			n -= chunk;
+			continue;
+		}
+
+		chunk = sizeof(st->header) - st->header_len;
+		chunk = n < chunk ? n : chunk;
+		memcpy(st->header + st->header_len, p, chunk);
+		st->header_len += chunk;
+		p += chunk;
+		n -= chunk;
+		if (st->header_len < sizeof(st->header))
+			break;
+
+		st->header_len = 0;
+		memcpy(&id, st->header, sizeof(id));
+		memcpy(&size, st->header + sizeof(id), sizeof(size));
+		if (id == ID_DONE)
+			st->done = 1;
+		else if (id == ID_DATA)
+			st->data_left = size;
+		else
+			return -1;
+	}
+
+	return 0;
+}
+
+long adb_pull(int fd, const char *path, void *buf, size_t size)
+{
+	unsigned char request[DEVICE_MAX_PAYLOAD];
+	struct sync_stream st = { .buf = buf, .size = size };
+	uint32_t id = ID_RECV, len = strlen(path);
+	struct adb_msg msg;
+	long remote;
+
+	if (sizeof(id) + sizeof(len) + len > sizeof(request))
+		return -1;
+
+	remote = open_stream(fd, "sync:");
+	if (remote <= 0)
+		return -1;
+
+	memcpy(request, &id, sizeof(id));
+	memcpy(request + sizeof(id), &len, sizeof(len));
+	memcpy(request + sizeof(id) + sizeof(len), path, len);
+	if (send_msg(fd, A_WRTE, LOCAL_ID, remote, request, sizeof(id) + sizeof(len) + len))
+		goto err;
+
+	while (!st.done) {
+		switch (recv_stream(fd, remote, &msg)) {
+		case A_OKAY:
+			break;
+		case A_WRTE:
+			if (sync_parse(&st, payload, msg.data_length))
+				goto err;
+			break;
+		default:
+			goto err;
+		}
+	}
+
+	return close_stream(fd, remote) ? -1 : (long)st.len;
+
+err:
+	close_stream(fd, remote);
+	return -1;
+}
+
+int adb_reboot(int fd, const char *target)
+{
+	char service[DEVICE_MAX_PAYLOAD];
+	struct adb_msg msg;
+
+	if (snprintf(service, sizeof(service), "reboot:%s", target) >= (int)sizeof(service) ||
+	    send_msg(fd, A_OPEN, LOCAL_ID, 0, service, strlen(service) + 1))
+		return -1;
+
+	/* The daemon stops as soon as the stream is open, the OKAY may
+	 * not make it before the connection is closed */
+	if (read_all(fd, &msg, sizeof(msg)))
+		return 0;
+	if (msg.command == A_CLSE)
+		return 1;
+	return msg.command == A_OKAY ? 0 : -1;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/*
+ * Minimal host adb client speaking the adb protocol, 24 bytes message
+ * headers followed by their payload, over a Unix socket.  Only one
+ * stream is open at a time.
+ */
+
+#ifndef _ADB_CLIENT_H_
+#define _ADB_CLIENT_H_
+
+#include <stddef.h>
+
+/* Connect to the device listening on PATH, retrying for TIMEOUT_MS
+ * while it starts, and exchange the CNXN messages.  Return the
+ * connection or -1. */
+int adb_connect(const char *path, int timeout_ms);
+void adb_disconnect(int fd);
+
+/* Run the shell COMMAND and copy up to SIZE - 1 bytes of its output,
+ * nul terminated, into OUT.  Return the output length or -1. */
+int adb_shell(int fd, const char *command, char *out, size_t size);
+
+/* Pull the file PATH, a libadb reader path such as "part:boot", with
+ * the sync service and copy up to SIZE bytes of it into BUF.  Return
+ * the file size or -1. */
+long adb_pull(int fd, const char *path, void *buf, size_t size);
+
+/* Open the reboot:TARGET service.  Return 0 when the device accepted
+ * it or closed the connection, 1 when it refused it and -1 on
+ * error. */
+int adb_reboot(int fd, const char *target);
+
+#endif /* _ADB_CLIENT_H_ */
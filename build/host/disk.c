@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/*
+ * File backed block device.  The image file stands for the boot disk
+ * so the GPT, flash and erase code can be run on the host.  Disk I/O 2
+ * requests with an event complete on their own thread, as they would
+ * in the background on a device.
+ *
+ * This file must not include lib.h, see efi_shim.c.
+ */
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <efi.h>
+#include <efilib.h>
+
+#include "host.h"
+#include "protocol/DiskIo2.h"
+
+/* Blocks per optimal transfer, chosen so that it does not divide the
+ * adb partition reader buffer size */
+#define OPTIMAL_TRANSFER_BLOCKS 24
+
+typedef struct host_disk {
+	EFI_BLOCK_IO bio;
+	EFI_BLOCK_IO_MEDIA media;
+	EFI_DISK_IO dio;
+	EFI_DISK_IO2_PROTOCOL dio2;
+	struct {
+		PCI_DEVICE_PATH pci;
+		EFI_DEVICE_PATH end;
+	} __attribute__((packed)) path;
+	int fd;
+} host_disk_t;
+
+#define DISK_FROM_DIO(This) \
+	((host_disk_t *)((UINT8 *)(This) - __builtin_offsetof(host_disk_t, dio)))
+#define DISK_FROM_DIO2(This) \
+	((host_disk_t *)((UINT8 *)(This) - __builtin_offsetof(host_disk_t, dio2)))
+
+struct disk_request {
+	host_disk_t *disk;
+	BOOLEAN write;
+	UINT64 offset;
+	UINTN size;
+	VOID *buffer;
+	EFI_DISK_IO2_TOKEN *token;
+};
+
+static EFI_STATUS disk_access(host_disk_t *disk, BOOLEAN write, UINT64 offset,
+			      UINTN size, VOID *buffer)
+{
+	UINT64 disk_size;
+	ssize_t done;
+
+	disk_size = (disk->media.LastBlock + 1) * disk->media.BlockSize;
+	if (offset > disk_size || size > disk_size - offset)
+		return EFI_INVALID_PARAMETER;
+
+	for (; size; size -= done, offset += done, buffer = (UINT8 *)buffer + done) {
+		done = write ? pwrite(disk->fd, buffer, size, offset) :
+			pread(disk->fd, buffer, size, offset);
+		if (done <= 0)
+			return EFI_DEVICE_ERROR;
+	}
+
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS disk_blocks(EFI_BLOCK_IO *This, BOOLEAN write, UINT32 MediaId,
+			      EFI_LBA LBA, UINTN BufferSize, VOID *Buffer)
+{
+	host_disk_t *disk = (host_disk_t *)This;
+
+	if (MediaId != disk->media.MediaId)
+		return EFI_MEDIA_CHANGED;
+	if (BufferSize % disk->media.BlockSize)
+		return EFI_BAD_BUFFER_SIZE;
+
+	return disk_access(disk, write, LBA * disk->media.BlockSize,
+			   BufferSize, Buffer);
+}
+
+static EFI_STATUS disk_reset(EFI_BLOCK_IO *This, BOOLEAN ExtendedVerification)
+{
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS disk_read_blocks(EFI_BLOCK_IO *This, UINT32 MediaId,
+				   EFI_LBA LBA, UINTN BufferSize, VOID *Buffer)
+{
+	return disk_blocks(This, FALSE, MediaId, LBA, BufferSize, Buffer);
+}
+
+static EFI_STATUS disk_write_blocks(EFI_BLOCK_IO *This, UINT32 MediaId,
+				    EFI_LBA LBA, UINTN BufferSize, VOID *Buffer)
+{
+	return disk_blocks(This, TRUE, MediaId, LBA, BufferSize, Buffer);
+}
+
+static EFI_STATUS disk_flush_blocks(EFI_BLOCK_IO *This)
+{
+	host_disk_t *disk = (host_disk_t *)This;
+
+	return fsync(disk->fd) ? EFI_DEVICE_ERROR : EFI_SUCCESS;
+}
+
+static EFI_STATUS disk_read_disk(EFI_DISK_IO *This, UINT32 MediaId,
+				 UINT64 Offset, UINTN BufferSize, VOID *Buffer)
+{
+	host_disk_t *disk = DISK_FROM_DIO(This);
+
+	if (MediaId != disk->media.MediaId)
+		return EFI_MEDIA_CHANGED;
+
+	return disk_access(disk, FALSE, Offset, BufferSize, Buffer);
+}
+
+static EFI_STATUS disk_write_disk(EFI_DISK_IO *This, UINT32 MediaId,
+				  UINT64 Offset, UINTN BufferSize, VOID *Buffer)
+{
+	host_disk_t *disk = DISK_FROM_DIO(This);
+
+	if (MediaId != disk->media.MediaId)
+		return EFI_MEDIA_CHANGED;
+
+	return disk_access(disk, TRUE, Offset, BufferSize, Buffer);
+}
+
+static void *disk_request_run(void *arg)
+{
+	struct disk_request *req = arg;
+
+	req->token->TransactionStatus = disk_access(req->disk, req->write,
+						    req->offset, req->size,
+						    req->buffer);
+	uefi_call_wrapper(BS->SignalEvent, 1, req->token->Event);
+	FreePool(req);
+	return NULL;
+}
+
+static EFI_STATUS disk_ex(EFI_DISK_IO2_PROTOCOL *This, BOOLEAN write, UINT32 MediaId,
+			  UINT64 Offset, EFI_DISK_IO2_TOKEN *Token,
+			  UINTN BufferSize, VOID *Buffer)
+{
+	host_disk_t *disk = DISK_FROM_DIO2(This);
+	struct disk_request *req;
+	pthread_t thread;
+
+	if (MediaId != disk->media.MediaId)
+		return EFI_MEDIA_CHANGED;
+
+	if (!Token || !Token->Event)
+		return disk_access(disk, write, Offset, BufferSize, Buffer);
+
+	req = AllocatePool(sizeof(*req));
+	if (!req)
+		return EFI_OUT_OF_RESOURCES;
+
+	*req = (struct disk_request) {
+		.disk = disk,
+		.write = write,
+		.offset = Offset,
+		.size = BufferSize,
+		.buffer = Buffer,
+		.token = Token
+	};
+	if (pthread_create(&thread, NULL, disk_request_run, req)) {
+		FreePool(req);
+		return EFI_OUT_OF_RESOURCES;
+	}
+	pthread_detach(thread);
+
+	return EFI_SUCCESS;
+}
+
+/* Requests cannot be aborted once their thread is started */
+static EFI_STATUS disk_cancel_ex(EFI_DISK_IO2_PROTOCOL *This)
+{
+	return EFI_UNSUPPORTED;
+}
+
+static EFI_STATUS disk_read_disk_ex(EFI_DISK_IO2_PROTOCOL *This, UINT32 MediaId,
+				    UINT64 Offset, EFI_DISK_IO2_TOKEN *Token,
+				    UINTN BufferSize, VOID *Buffer)
+{
+	return disk_ex(This, FALSE, MediaId, Offset, Token, BufferSize, Buffer);
+}
+
+static EFI_STATUS disk_write_disk_ex(EFI_DISK_IO2_PROTOCOL *This, UINT32 MediaId,
+				     UINT64 Offset, EFI_DISK_IO2_TOKEN *Token,
+				     UINTN BufferSize, VOID *Buffer)
+{
+	return disk_ex(This, TRUE, MediaId, Offset, Token, BufferSize, Buffer);
+}
+
+static EFI_STATUS disk_flush_disk_ex(EFI_DISK_IO2_PROTOCOL *This,
+				     EFI_DISK_IO2_TOKEN *Token)
+{
+	host_disk_t *disk = DISK_FROM_DIO2(This);
+	EFI_STATUS ret;
+
+	ret = fsync(disk->fd) ? EFI_DEVICE_ERROR : EFI_SUCCESS;
+	if (!Token || !Token->Event)
+		return ret;
+
+	Token->TransactionStatus = ret;
+	uefi_call_wrapper(BS->SignalEvent, 1, Token->Event);
+	return EFI_SUCCESS;
+}
+
+EFI_STATUS host_disk_open(const char *path, UINT32 block_size, EFI_HANDLE *handle)
+{
+	static EFI_GUID dio2_guid = EFI_DISK_IO2_PROTOCOL_GUID;
+	EFI_STATUS ret;
+	host_disk_t *disk;
+	struct stat st;
+
+	if (!path || !block_size || !handle)
+		return EFI_INVALID_PARAMETER;
+
+	disk = AllocateZeroPool(sizeof(*disk));
+	if (!disk)
+		return EFI_OUT_OF_RESOURCES;
+
+	disk->fd = open(path, O_RDWR);
+	if (disk->fd < 0) {
+		ret = EFI_NOT_FOUND;
+		goto free;
+	}
+
+	if (fstat(disk->fd, &st) || st.st_size < block_size) {
+		ret = EFI_NO_MEDIA;
+		goto close;
+	}
+
+	disk->media.MediaPresent = TRUE;
+	disk->media.BlockSize = block_size;
+	disk->media.LastBlock = st.st_size / block_size - 1;
+	disk->media.IoAlign = 0;
+	disk->media.OptimalTransferLengthGranularity = OPTIMAL_TRANSFER_BLOCKS;
+
+	disk->bio.Revision = EFI_BLOCK_IO_PROTOCOL_REVISION3;
+	disk->bio.Media = &disk->media;
+	disk->bio.Reset = disk_reset;
+	disk->bio.ReadBlocks = disk_read_blocks;
+	disk->bio.WriteBlocks = disk_write_blocks;
+	disk->bio.FlushBlocks = disk_flush_blocks;
+
+	disk->dio.ReadDisk = disk_read_disk;
+	disk->dio.WriteDisk = disk_write_disk;
+
+	disk->dio2.Revision = EFI_DISK_IO2_PROTOCOL_REVISION;
+	disk->dio2.Cancel = disk_cancel_ex;
+	disk->dio2.ReadDiskEx = disk_read_disk_ex;
+	disk->dio2.WriteDiskEx = disk_write_disk_ex;
+	disk->dio2.FlushDiskEx = disk_flush_disk_ex;
+
+	disk->path.pci.Header.Type = HARDWARE_DEVICE_PATH;
+	disk->path.pci.Header.SubType = HW_PCI_DP;
+	disk->path.pci.Header.Length[0] = sizeof(disk->path.pci);
+	disk->path.end.Type = END_DEVICE_PATH_TYPE;
+	disk->path.end.SubType = END_ENTIRE_DEVICE_PATH_SUBTYPE;
+	disk->path.end.Length[0] = sizeof(disk->path.end);
+
+	ret = host_install_protocol(disk, &BlockIoProtocol, &disk->bio);
+	if (!EFI_ERROR(ret))
+		ret = host_install_protocol(disk, &DiskIoProtocol, &disk->dio);
+	if (!EFI_ERROR(ret))
+		ret = host_install_protocol(disk, &dio2_guid, &disk->dio2);
+	if (!EFI_ERROR(ret))
+		ret = host_install_protocol(disk, &DevicePathProtocol, &disk->path);
+	if (EFI_ERROR(ret)) {
+		host_uninstall_protocols(disk);
+		goto close;
+	}
+
+	*handle = disk;
+	return EFI_SUCCESS;
+
+close:
+	close(disk->fd);
+free:
+	FreePool(disk);
+	return ret;
+}
+
+VOID host_disk_close(EFI_HANDLE handle)
+{
+	host_disk_t *disk = handle;
+
+	if (!disk)
+		return;
+
+	host_uninstall_protocols(disk);
+	close(disk->fd);
+	FreePool(disk);
+}
@@ -0,0 +1,1121 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Host implementation of the gnu-efi library subset and of the
+ * firmware services used by the modules built on the host.  Boot
+ * and runtime services are backed by the C library: memory comes
+ * from malloc(), variables live in memory for the duration of the
+ * process and resetting the system exits.
+ *
+ * This file must not include lib.h: the C library headers it relies
+ * on declare the string functions with different prototypes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <efi.h>
+#include <efilib.h>
+#include <efigpt.h>
+
+#include "host.h"
+
+EFI_GUID GenericFileInfo = { 0x9576e92, 0x6d3f, 0x11d2, { 0x8e, 0x39, 0x0, 0xa0, 0xc9, 0x69, 0x72, 0x3b } };
+EFI_GUID GraphicsOutputProtocol = { 0x9042a9de, 0x23dc, 0x4a38, { 0x96, 0xfb, 0x7a, 0xde, 0xd0, 0x80, 0x51, 0x6a } };
+EFI_GUID LoadedImageProtocol = { 0x5b1b31a1, 0x9562, 0x11d2, { 0x8e, 0x3f, 0x0, 0xa0, 0xc9, 0x69, 0x72, 0x3b } };
+EFI_GUID BlockIoProtocol = { 0x964e5b21, 0x6459, 0x11d2, { 0x8e, 0x39, 0x0, 0xa0, 0xc9, 0x69, 0x72, 0x3b } };
+EFI_GUID DiskIoProtocol = { 0xce345171, 0xba0b, 0x11d2, { 0x8e, 0x4f, 0x0, 0xa0, 0xc9, 0x69, 0x72, 0x3b } };
+EFI_GUID DevicePathProtocol = { 0x9576e91, 0x6d3f, 0x11d2, { 0x8e, 0x39, 0x0, 0xa0, 0xc9, 0x69, 0x72, 0x3b } };
+EFI_GUID FileSystemProtocol = { 0x964e5b22, 0x6459, 0x11d2, { 0x8e, 0x39, 0x0, 0xa0, 0xc9, 0x69, 0x72, 0x3b } };
+EFI_GUID PciIoProtocol = { 0x4cf5b200, 0x68b8, 0x4ca5, { 0x9e, 0xec, 0xb2, 0x3e, 0x3f, 0x50, 0x2, 0x9a } };
+EFI_GUID NullGuid = { 0, 0, 0, { 0, 0, 0, 0, 0, 0, 0, 0 } };
+EFI_GUID EfiPartTypeSystemPartitionGuid = EFI_PART_TYPE_EFI_SYSTEM_PART_GUID;
+
+/*
+ * Memory
+ */
+VOID *AllocatePool(UINTN Size)
+{
+	return malloc(Size ? Size : 1);
+}
+
+VOID *AllocateZeroPool(UINTN Size)
+{
+	return calloc(1, Size ? Size : 1);
+}
+
+VOID *ReallocatePool(VOID *OldPool, UINTN OldSize, UINTN NewSize)
+{
+	VOID *NewPool;
+
+	NewPool = AllocatePool(NewSize);
+	if (NewPool && OldPool)
+		CopyMem(NewPool, OldPool, OldSize < NewSize ? OldSize : NewSize);
+	FreePool(OldPool);
+	return NewPool;
+}
+
+VOID FreePool(VOID *Buffer)
+{
+	free(Buffer);
+}
+
+/* Like gnu-efi these are plain loops: the memcpy() and memset() of
+ * the program are the lib.c ones, which are built on top of them. */
+VOID ZeroMem(VOID *Buffer, UINTN Size)
+{
+	SetMem(Buffer, Size, 0);
+}
+
+VOID SetMem(VOID *Buffer, UINTN Size, UINT8 Value)
+{
+	volatile UINT8 *pt = Buffer;
+
+	while (Size--)
+		*pt++ = Value;
+}
+
+VOID CopyMem(VOID *Dest, const VOID *Src, UINTN len)
+{
+	UINT8 *d = Dest;
+	const UINT8 *s = Src;
+
+	if (d > s && d < s + len) {
+		while (len--)
+			d[len] = s[len];
+		return;
+	}
+	while (len--)
+		*d++ = *s++;
+}
+
+INTN CompareMem(const VOID *Dest, const VOID *Src, UINTN len)
+{
+	const UINT8 *d = Dest, *s = Src;
+
+	for (; len; len--, d++, s++)
+		if (*d != *s)
+			return *d - *s;
+	return 0;
+}
+
+INTN CompareGuid(const EFI_GUID *Guid1, const EFI_GUID *Guid2)
+{
+	return CompareMem(Guid1, Guid2, sizeof(*Guid1)) ? 1 : 0;
+}
+
+UINT64 DivU64x32(UINT64 Dividend, UINTN Divisor, UINTN *Remainder)
+{
+	if (Remainder)
+		*Remainder = Dividend % Divisor;
+	return Dividend / Divisor;
+}
+
+UINT64 MultU64x32(UINT64 Multiplicand, UINTN Multiplier)
+{
+	return Multiplicand * Multiplier;
+}
+
+/*
+ * Strings
+ */
+UINTN StrLen(const CHAR16 *s1)
+{
+	UINTN len;
+
+	for (len = 0; *s1; s1++, len++)
+		;
+	return len;
+}
+
+UINTN StrSize(const CHAR16 *s1)
+{
+	return (StrLen(s1) + 1) * sizeof(CHAR16);
+}
+
+INTN StrCmp(const CHAR16 *s1, const CHAR16 *s2)
+{
+	while (*s1 && *s1 == *s2) {
+		s1++;
+		s2++;
+	}
+	return *s1 - *s2;
+}
+
+INTN StrnCmp(const CHAR16 *s1, const CHAR16 *s2, UINTN len)
+{
+	for (; len; len--, s1++, s2++)
+		if (*s1 != *s2 || !*s1)
+			return *s1 - *s2;
+	return 0;
+}
+
+VOID StrCpy(CHAR16 *Dest, const CHAR16 *Src)
+{
+	while ((*Dest++ = *Src++))
+		;
+}
+
+VOID StrCat(CHAR16 *Dest, const CHAR16 *Src)
+{
+	StrCpy(Dest + StrLen(Dest), Src);
+}
+
+CHAR16 *StrDuplicate(const CHAR16 *Src)
+{
+	CHAR16 *Dest;
+
+	Dest = AllocatePool(StrSize(Src));
+	if (Dest)
+		StrCpy(Dest, Src);
+	return Dest;
+}
+
+UINTN Atoi(const CHAR16 *str)
+{
+	UINTN u = 0;
+
+	while (*str == ' ')
+		str++;
+	for (; *str >= '0' && *str <= '9'; str++)
+		u = u * 10 + *str - '0';
+	return u;
+}
+
+UINTN xtoi(const CHAR16 *str)
+{
+	UINTN u = 0;
+	CHAR16 c;
+
+	while (*str == ' ')
+		str++;
+	for (;; str++) {
+		c = *str;
+		if (c >= 'a' && c <= 'f')
+			c -= 'a' - 'A';
+		if (c >= '0' && c <= '9')
+			u = (u << 4) | (c - '0');
+		else if (c >= 'A' && c <= 'F')
+			u = (u << 4) | (c - 'A' + 10);
+		else
+			break;
+	}
+	return u;
+}
+
+UINTN strlena(const CHAR8 *s1)
+{
+	UINTN len;
+
+	for (len = 0; *s1; s1++, len++)
+		;
+	return len;
+}
+
+INTN strcmpa(const CHAR8 *s1, const CHAR8 *s2)
+{
+	while (*s1 && *s1 == *s2) {
+		s1++;
+		s2++;
+	}
+	return *s1 - *s2;
+}
+
+INTN strncmpa(const CHAR8 *s1, const CHAR8 *s2, UINTN len)
+{
+	for (; len; len--, s1++, s2++)
+		if (*s1 != *s2 || !*s1)
+			return *s1 - *s2;
+	return 0;
+}
+
+/*
+ * Formatted output, with the gnu-efi conversions: %a is a CHAR8
+ * string, %s a CHAR16 string, %r an EFI_STATUS and %g an EFI_GUID.
+ * Integers are 32-bit unless the 'l' modifier is given.
+ */
+static const char *status_str[] = {
+	"Success", "Load Error", "Invalid Parameter", "Unsupported",
+	"Bad Buffer Size", "Buffer Too Small", "Not Ready", "Device Error",
+	"Write Protected", "Out of Resources", "Volume Corrupt", "Volume Full",
+	"No Media", "Media changed", "Not Found", "Access Denied",
+	"No Response", "No mapping", "Time out", "Not started",
+	"Already started", "Aborted", "ICMP Error", "TFTP Error",
+	"Protocol Error", "Incompatible Version", "Security Violation",
+	"CRC Error", "End of Media", "Reserved (29)", "Reserved (30)",
+	"End of File", "Invalid Language", "Compromised Data"
+};
+
+typedef struct {
+	CHAR16 *str;
+	UINTN len;
+	UINTN max;
+} print_state_t;
+
+static void out_char(print_state_t *ps, CHAR16 c)
+{
+	if (ps->len < ps->max)
+		ps->str[ps->len] = c;
+	ps->len++;
+}
+
+static void out_field(print_state_t *ps, const CHAR8 *s8, const CHAR16 *s16,
+		      UINTN len, UINTN width, BOOLEAN left, CHAR16 pad)
+{
+	UINTN i;
+
+	if (!left)
+		for (i = len; i < width; i++)
+			out_char(ps, pad);
+	for (i = 0; i < len; i++)
+		out_char(ps, s8 ? s8[i] : s16[i]);
+	if (left)
+		for (i = len; i < width; i++)
+			out_char(ps, ' ');
+}
+
+static UINTN num_to_str(CHAR8 *buf, UINT64 value, UINTN base, BOOLEAN neg)
+{
+	static const char digits[] = "0123456789ABCDEF";
+	CHAR8 tmp[24];
+	UINTN len = 0, i = 0;
+
+	do {
+		tmp[len++] = digits[value % base];
+		value /= base;
+	} while (value);
+	if (neg)
+		buf[i++] = '-';
+	while (len)
+		buf[i++] = tmp[--len];
+	buf[i] = '\0';
+	return i;
+}
+
+static UINTN format(CHAR16 *str, UINTN max, const CHAR16 *fmt, va_list args)
+{
+	print_state_t ps = { .str = str, .len = 0, .max = max };
+	CHAR8 buf[64];
+	const CHAR8 *s8;
+	const CHAR16 *s16;
+	EFI_GUID *guid;
+	EFI_STATUS status;
+	UINTN width, precision, len;
+	BOOLEAN left, is_long, has_precision;
+	CHAR16 pad, c;
+	INT64 value;
+
+	for (; *fmt; fmt++) {
+		if (*fmt != '%') {
+			out_char(&ps, *fmt);
+			continue;
+		}
+
+		left = is_long = has_precision = FALSE;
+		pad = ' ';
+		width = precision = 0;
+		for (fmt++; ; fmt++) {
+			c = *fmt;
+			if (c == '-')
+				left = TRUE;
+			else if (c == '0' && !width && !has_precision)
+				pad = '0';
+			else if (c == ',')
+				continue;
+			else if (c == '.')
+				has_precision = TRUE;
+			else if (c == '*') {
+				if (has_precision)
+					precision = va_arg(args, UINTN);
+				else
+					width = va_arg(args, UINTN);
+			} else if (c >= '0' && c <= '9') {
+				if (has_precision)
+					precision = precision * 10 + c - '0';
+				else
+					width = width * 10 + c - '0';
+			} else if (c == 'l')
+				is_long = TRUE;
+			else
+				break;
+		}
+
+		s8 = NULL;
+		s16 = NULL;
+		switch (*fmt) {
+		case 'a':
+			s8 = va_arg(args, CHAR8 *);
+			if (!s8)
+				s8 = (CHAR8 *)"(null)";
+			for (len = 0; s8[len] && (!has_precision || len < precision); len++)
+				;
+			break;
+		case 's':
+			s16 = va_arg(args, CHAR16 *);
+			if (!s16) {
+				s8 = (CHAR8 *)"(null)";
+				len = 6;
+				break;
+			}
+			for (len = 0; s16[len] && (!has_precision || len < precision); len++)
+				;
+			break;
+		case 'c':
+			buf[0] = (CHAR8)va_arg(args, UINTN);
+			s8 = buf;
+			len = 1;
+			break;
+		case 'd':
+			value = is_long ? va_arg(args, INT64) : va_arg(args, INT32);
+			s8 = buf;
+			len = num_to_str(buf, value < 0 ? -(UINT64)value : (UINT64)value,
+					 10, value < 0);
+			break;
+		case 'u':
+			s8 = buf;
+			len = num_to_str(buf, is_long ? va_arg(args, UINT64) :
+					 va_arg(args, UINT32), 10, FALSE);
+			break;
+		case 'p':
+			is_long = TRUE;
+			width = 2 * sizeof(VOID *);
+			pad = '0';
+			/* Fall through */
+		case 'X':
+			if (!width) {
+				width = is_long ? 16 : 8;
+				pad = '0';
+			}
+			/* Fall through */
+		case 'x':
+			s8 = buf;
+			len = num_to_str(buf, is_long ? va_arg(args, UINT64) :
+					 va_arg(args, UINT32), 16, FALSE);
+			break;
+		case 'r':
+			status = va_arg(args, EFI_STATUS);
+			s8 = buf;
+			if ((status & ~EFI_ERROR_MASK) < sizeof(status_str) / sizeof(*status_str))
+				s8 = (const CHAR8 *)status_str[status & ~EFI_ERROR_MASK];
+			else
+				num_to_str(buf, status, 16, FALSE);
+			for (len = 0; s8[len]; len++)
+				;
+			break;
+		case 'g':
+			guid = va_arg(args, EFI_GUID *);
+			len = snprintf((char *)buf, sizeof(buf),
+				       "%08X-%04X-%04X-%02X%02X-%02X%02X%02X%02X%02X%02X",
+				       guid->Data1, guid->Data2, guid->Data3,
+				       guid->Data4[0], guid->Data4[1], guid->Data4[2],
+				       guid->Data4[3], guid->Data4[4], guid->Data4[5],
+				       guid->Data4[6], guid->Data4[7]);
+			s8 = buf;
+			break;
+		case '\0':
+			fmt--;
+			continue;
+		default:
+			buf[0] = (CHAR8)*fmt;
+			s8 = buf;
+			len = 1;
+			break;
+		}
+		out_field(&ps, s8, s16, len, width, left, pad);
+	}
+
+	if (max) {
+		len = ps.len < max ? ps.len : max - 1;
+		str[len] = '\0';
+		return len;
+	}
+	return ps.len;
+}
+
+UINTN VSPrint(CHAR16 *Str, UINTN StrSize, const CHAR16 *fmt, va_list args)
+{
+	/* As in gnu-efi, a zero size means the buffer is large enough */
+	return format(Str, StrSize ? StrSize / sizeof(CHAR16) : (UINTN)-1 / sizeof(CHAR16),
+		      fmt, args);
+}
+
+UINTN SPrint(CHAR16 *Str, UINTN StrSize, const CHAR16 *fmt, ...)
+{
+	va_list args;
+	UINTN len;
+
+	va_start(args, fmt);
+	len = VSPrint(Str, StrSize, fmt, args);
+	va_end(args);
+	return len;
+}
+
+CHAR16 *VPoolPrint(const CHAR16 *fmt, va_list args)
+{
+	CHAR16 *str;
+	va_list copy;
+	UINTN len;
+
+	va_copy(copy, args);
+	len = format(NULL, 0, fmt, copy);
+	va_end(copy);
+
+	str = AllocatePool((len + 1) * sizeof(CHAR16));
+	if (str)
+		format(str, len + 1, fmt, args);
+	return str;
+}
+
+CHAR16 *PoolPrint(const CHAR16 *fmt, ...)
+{
+	va_list args;
+	CHAR16 *str;
+
+	va_start(args, fmt);
+	str = VPoolPrint(fmt, args);
+	va_end(args);
+	return str;
+}
+
+UINTN VPrint(const CHAR16 *fmt, va_list args)
+{
+	CHAR16 *str;
+	UINTN i;
+
+	str = VPoolPrint(fmt, args);
+	if (!str)
+		return 0;
+
+	for (i = 0; str[i]; i++)
+		putchar(str[i] < 0x80 ? str[i] : '?');
+	fflush(stdout);
+	FreePool(str);
+	return i;
+}
+
+UINTN Print(const CHAR16 *fmt, ...)
+{
+	va_list args;
+	UINTN len;
+
+	va_start(args, fmt);
+	len = VPrint(fmt, args);
+	va_end(args);
+	return len;
+}
+
+/*
+ * Protocols.  The host harness installs the protocols of the devices
+ * it emulates, see disk.c, in a small handle database.
+ */
+#define MAX_PROTOCOLS 32
+
+static struct protocol {
+	EFI_HANDLE handle;
+	EFI_GUID *guid;
+	VOID *interface;
+} protocols[MAX_PROTOCOLS];
+
+static struct protocol *find_protocol(EFI_HANDLE Handle, EFI_GUID *Protocol)
+{
+	UINTN i;
+
+	for (i = 0; i < MAX_PROTOCOLS; i++)
+		if (protocols[i].handle && (!Handle || protocols[i].handle == Handle) &&
+		    !CompareGuid(protocols[i].guid, Protocol))
+			return &protocols[i];
+	return NULL;
+}
+
+EFI_STATUS host_install_protocol(EFI_HANDLE Handle, EFI_GUID *Protocol, VOID *Interface)
+{
+	struct protocol *p;
+
+	if (!Handle || find_protocol(Handle, Protocol))
+		return EFI_INVALID_PARAMETER;
+
+	for (p = protocols; p < protocols + MAX_PROTOCOLS; p++)
+		if (!p->handle)
+			break;
+	if (p == protocols + MAX_PROTOCOLS)
+		return EFI_OUT_OF_RESOURCES;
+
+	p->handle = Handle;
+	p->guid = Protocol;
+	p->interface = Interface;
+	return EFI_SUCCESS;
+}
+
+VOID host_uninstall_protocols(EFI_HANDLE Handle)
+{
+	UINTN i;
+
+	for (i = 0; i < MAX_PROTOCOLS; i++)
+		if (protocols[i].handle == Handle)
+			ZeroMem(&protocols[i], sizeof(protocols[i]));
+}
+
+EFI_DEVICE_PATH *DevicePathFromHandle(EFI_HANDLE Handle)
+{
+	struct protocol *p = find_protocol(Handle, &DevicePathProtocol);
+
+	return p ? p->interface : NULL;
+}
+
+UINTN DevicePathSize(EFI_DEVICE_PATH *DevPath)
+{
+	EFI_DEVICE_PATH *p;
+
+	for (p = DevPath; !IsDevicePathEnd(p); p = NextDevicePathNode(p))
+		;
+	return (UINT8 *)p - (UINT8 *)DevPath + DevicePathNodeLength(p);
+}
+
+/* Unlike gnu-efi, only the node types and sub-types are printed */
+CHAR16 *DevicePathToStr(EFI_DEVICE_PATH *DevPath)
+{
+	CHAR16 *str = NULL, *tmp;
+	EFI_DEVICE_PATH *p;
+
+	for (p = DevPath; !IsDevicePathEnd(p); p = NextDevicePathNode(p)) {
+		tmp = PoolPrint(L"%s%sNode(%d,%d)", str ? str : L"",
+				str ? L"/" : L"", DevicePathType(p),
+				DevicePathSubType(p));
+		FreePool(str);
+		str = tmp;
+		if (!str)
+			return NULL;
+	}
+
+	return str ? str : PoolPrint(L"");
+}
+
+EFI_STATUS LibLocateProtocol(EFI_GUID *ProtocolGuid, VOID **Interface)
+{
+	struct protocol *p = find_protocol(NULL, ProtocolGuid);
+
+	*Interface = p ? p->interface : NULL;
+	return p ? EFI_SUCCESS : EFI_NOT_FOUND;
+}
+
+EFI_FILE_HANDLE LibOpenRoot(EFI_HANDLE DeviceHandle)
+{
+	return NULL;
+}
+
+EFI_FILE_INFO *LibFileInfo(EFI_FILE_HANDLE FHand)
+{
+	return NULL;
+}
+
+/*
+ * Boot services
+ */
+static EFI_STATUS host_allocate_pages(EFI_ALLOCATE_TYPE Type, EFI_MEMORY_TYPE MemoryType,
+				      UINTN NoPages, EFI_PHYSICAL_ADDRESS *Memory)
+{
+	VOID *pages;
+
+	if (Type != AllocateAnyPages)
+		return EFI_UNSUPPORTED;
+
+	pages = aligned_alloc(EFI_PAGE_SIZE, NoPages * EFI_PAGE_SIZE);
+	if (!pages)
+		return EFI_OUT_OF_RESOURCES;
+
+	*Memory = (EFI_PHYSICAL_ADDRESS)(UINTN)pages;
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS host_free_pages(EFI_PHYSICAL_ADDRESS Memory, UINTN NoPages)
+{
+	free((VOID *)(UINTN)Memory);
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS host_allocate_pool(EFI_MEMORY_TYPE PoolType, UINTN Size, VOID **Buffer)
+{
+	*Buffer = AllocatePool(Size);
+	return *Buffer ? EFI_SUCCESS : EFI_OUT_OF_RESOURCES;
+}
+
+static EFI_STATUS host_free_pool(VOID *Buffer)
+{
+	FreePool(Buffer);
+	return EFI_SUCCESS;
+}
+
+/* The memory of the host process is not described */
+static EFI_STATUS host_get_memory_map(UINTN *MemoryMapSize, EFI_MEMORY_DESCRIPTOR *MemoryMap,
+				      UINTN *MapKey, UINTN *DescriptorSize,
+				      UINT32 *DescriptorVersion)
+{
+	return EFI_UNSUPPORTED;
+}
+
+/* Events are flags which may be signaled from another thread, as an
+ * asynchronous completion would, notification functions are not
+ * supported. */
+struct host_event {
+	int signaled;
+};
+
+static EFI_STATUS host_create_event(UINT32 Type, EFI_TPL NotifyTpl,
+				    EFI_EVENT_NOTIFY NotifyFunction,
+				    VOID *NotifyContext, EFI_EVENT *Event)
+{
+	if (NotifyFunction)
+		return EFI_UNSUPPORTED;
+	if (!Event)
+		return EFI_INVALID_PARAMETER;
+
+	*Event = AllocateZeroPool(sizeof(struct host_event));
+	return *Event ? EFI_SUCCESS : EFI_OUT_OF_RESOURCES;
+}
+
+static EFI_STATUS host_wait_for_event(UINTN NumberOfEvents, EFI_EVENT *Event,
+				      UINTN *Index)
+{
+	struct host_event *event;
+	UINTN i;
+
+	if (!NumberOfEvents || !Event || !Index)
+		return EFI_INVALID_PARAMETER;
+
+	for (;;) {
+		for (i = 0; i < NumberOfEvents; i++) {
+			event = Event[i];
+			if (__atomic_exchange_n(&event->signaled, 0, __ATOMIC_ACQUIRE)) {
+				*Index = i;
+				return EFI_SUCCESS;
+			}
+		}
+		usleep(10);
+	}
+}
+
+static EFI_STATUS host_signal_event(EFI_EVENT Event)
+{
+	struct host_event *event = Event;
+
+	__atomic_store_n(&event->signaled, 1, __ATOMIC_RELEASE);
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS host_close_event(EFI_EVENT Event)
+{
+	FreePool(Event);
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS host_handle_protocol(EFI_HANDLE Handle, EFI_GUID *Protocol,
+				       VOID **Interface)
+{
+	struct protocol *p;
+
+	if (!Handle)
+		return EFI_INVALID_PARAMETER;
+
+	p = find_protocol(Handle, Protocol);
+	if (!p)
+		return EFI_UNSUPPORTED;
+
+	*Interface = p->interface;
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS host_reinstall_protocol_interface(EFI_HANDLE Handle, EFI_GUID *Protocol,
+						    VOID *OldInterface, VOID *NewInterface)
+{
+	struct protocol *p = find_protocol(Handle, Protocol);
+
+	if (!p || p->interface != OldInterface)
+		return EFI_NOT_FOUND;
+
+	p->interface = NewInterface;
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS host_locate_handle(EFI_LOCATE_SEARCH_TYPE SearchType,
+				     EFI_GUID *Protocol, VOID *SearchKey,
+				     UINTN *BufferSize, EFI_HANDLE *Buffer)
+{
+	UINTN i, nb = 0;
+
+	if (SearchType != ByProtocol)
+		return EFI_UNSUPPORTED;
+
+	for (i = 0; i < MAX_PROTOCOLS; i++) {
+		if (!protocols[i].handle || CompareGuid(protocols[i].guid, Protocol))
+			continue;
+		if (Buffer && (nb + 1) * sizeof(*Buffer) <= *BufferSize)
+			Buffer[nb] = protocols[i].handle;
+		nb++;
+	}
+
+	if (!nb)
+		return EFI_NOT_FOUND;
+
+	i = *BufferSize;
+	*BufferSize = nb * sizeof(*Buffer);
+	return *BufferSize > i ? EFI_BUFFER_TOO_SMALL : EFI_SUCCESS;
+}
+
+static EFI_STATUS host_locate_handle_buffer(EFI_LOCATE_SEARCH_TYPE SearchType,
+					    EFI_GUID *Protocol, VOID *SearchKey,
+					    UINTN *NoHandles, EFI_HANDLE **Buffer)
+{
+	EFI_STATUS ret;
+	UINTN size = sizeof(**Buffer) * MAX_PROTOCOLS;
+
+	*Buffer = AllocatePool(size);
+	if (!*Buffer)
+		return EFI_OUT_OF_RESOURCES;
+
+	ret = host_locate_handle(SearchType, Protocol, SearchKey, &size, *Buffer);
+	if (EFI_ERROR(ret)) {
+		FreePool(*Buffer);
+		*Buffer = NULL;
+		return ret;
+	}
+
+	*NoHandles = size / sizeof(**Buffer);
+	return EFI_SUCCESS;
+}
+
+/* Select the handle supporting PROTOCOL whose device path is the
+ * longest prefix of *DEVICEPATH */
+static EFI_STATUS host_locate_device_path(EFI_GUID *Protocol,
+					  EFI_DEVICE_PATH **DevicePath,
+					  EFI_HANDLE *Device)
+{
+	EFI_DEVICE_PATH *path;
+	UINTN i, size, best = 0;
+
+	if (!Protocol || !DevicePath || !*DevicePath || !Device)
+		return EFI_INVALID_PARAMETER;
+
+	*Device = NULL;
+	for (i = 0; i < MAX_PROTOCOLS; i++) {
+		if (!protocols[i].handle || CompareGuid(protocols[i].guid, Protocol))
+			continue;
+
+		path = DevicePathFromHandle(protocols[i].handle);
+		if (!path)
+			continue;
+
+		size = DevicePathSize(path) - END_DEVICE_PATH_LENGTH;
+		if (size < best || size > DevicePathSize(*DevicePath) ||
+		    CompareMem(path, *DevicePath, size))
+			continue;
+
+		best = size;
+		*Device = protocols[i].handle;
+	}
+
+	if (!*Device)
+		return EFI_NOT_FOUND;
+
+	*DevicePath = (EFI_DEVICE_PATH *)((UINT8 *)*DevicePath + best);
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS host_connect_controller(EFI_HANDLE ControllerHandle,
+					  EFI_HANDLE *DriverImageHandle,
+					  EFI_DEVICE_PATH *RemainingDevicePath,
+					  BOOLEAN Recursive)
+{
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS host_locate_protocol(EFI_GUID *Protocol, VOID *Registration,
+				       VOID **Interface)
+{
+	return LibLocateProtocol(Protocol, Interface);
+}
+
+static EFI_STATUS host_exit(EFI_HANDLE ImageHandle, EFI_STATUS ExitStatus,
+			    UINTN ExitDataSize, CHAR16 *ExitData)
+{
+	fflush(stdout);
+	exit(EFI_ERROR(ExitStatus) ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+static EFI_STATUS host_stall(UINTN Microseconds)
+{
+	usleep(Microseconds);
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS host_set_watchdog_timer(UINTN Timeout, UINT64 WatchdogCode,
+					  UINTN DataSize, CHAR16 *WatchdogData)
+{
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS host_calculate_crc32(VOID *Data, UINTN DataSize, UINT32 *Crc32)
+{
+	const UINT8 *p = Data;
+	UINT32 crc = 0xffffffff;
+	UINTN i, bit;
+
+	if (!Data || !DataSize || !Crc32)
+		return EFI_INVALID_PARAMETER;
+
+	for (i = 0; i < DataSize; i++) {
+		crc ^= p[i];
+		for (bit = 0; bit < 8; bit++)
+			crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
+	}
+
+	*Crc32 = ~crc;
+	return EFI_SUCCESS;
+}
+
+static EFI_BOOT_SERVICES host_boot_services = {
+	.AllocatePages = host_allocate_pages,
+	.FreePages = host_free_pages,
+	.GetMemoryMap = host_get_memory_map,
+	.AllocatePool = host_allocate_pool,
+	.FreePool = host_free_pool,
+	.CreateEvent = host_create_event,
+	.WaitForEvent = host_wait_for_event,
+	.SignalEvent = host_signal_event,
+	.CloseEvent = host_close_event,
+	.HandleProtocol = host_handle_protocol,
+	.ReinstallProtocolInterface = host_reinstall_protocol_interface,
+	.LocateHandle = host_locate_handle,
+	.LocateDevicePath = host_locate_device_path,
+	.LocateHandleBuffer = host_locate_handle_buffer,
+	.ConnectController = host_connect_controller,
+	.LocateProtocol = host_locate_protocol,
+	.Exit = host_exit,
+	.Stall = host_stall,
+	.SetWatchdogTimer = host_set_watchdog_timer,
+	.CalculateCrc32 = host_calculate_crc32
+};
+
+/*
+ * Runtime services.  Variables follow the UEFI rules the callers
+ * depend on: a zero size deletes and an existing variable can only
+ * be rewritten with the same attributes.
+ */
+typedef struct variable {
+	struct variable *next;
+	CHAR16 *name;
+	EFI_GUID guid;
+	UINT32 attributes;
+	UINTN size;
+	VOID *data;
+} variable_t;
+
+static variable_t *variables;
+
+static variable_t **find_variable(CHAR16 *VariableName, EFI_GUID *VendorGuid)
+{
+	variable_t **var;
+
+	for (var = &variables; *var; var = &(*var)->next)
+		if (!StrCmp((*var)->name, VariableName) &&
+		    !CompareGuid(&(*var)->guid, VendorGuid))
+			break;
+	return var;
+}
+
+static EFI_STATUS host_get_time(EFI_TIME *Time, VOID *Capabilities)
+{
+	struct tm tm;
+	time_t now;
+
+	now = time(NULL);
+	if (!gmtime_r(&now, &tm))
+		return EFI_DEVICE_ERROR;
+
+	ZeroMem(Time, sizeof(*Time));
+	Time->Year = tm.tm_year + 1900;
+	Time->Month = tm.tm_mon + 1;
+	Time->Day = tm.tm_mday;
+	Time->Hour = tm.tm_hour;
+	Time->Minute = tm.tm_min;
+	Time->Second = tm.tm_sec;
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS host_get_variable(CHAR16 *VariableName, EFI_GUID *VendorGuid,
+				   UINT32 *Attributes, UINTN *DataSize, VOID *Data)
+{
+	variable_t *var;
+
+	if (!VariableName || !VendorGuid || !DataSize)
+		return EFI_INVALID_PARAMETER;
+
+	var = *find_variable(VariableName, VendorGuid);
+	if (!var)
+		return EFI_NOT_FOUND;
+
+	if (Attributes)
+		*Attributes = var->attributes;
+	if (*DataSize < var->size) {
+		*DataSize = var->size;
+		return EFI_BUFFER_TOO_SMALL;
+	}
+
+	CopyMem(Data, var->data, var->size);
+	*DataSize = var->size;
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS host_get_next_variable_name(UINTN *VariableNameSize,
+					      CHAR16 *VariableName, EFI_GUID *VendorGuid)
+{
+	variable_t *var;
+
+	if (!VariableName[0])
+		var = variables;
+	else {
+		var = *find_variable(VariableName, VendorGuid);
+		if (!var)
+			return EFI_INVALID_PARAMETER;
+		var = var->next;
+	}
+	if (!var)
+		return EFI_NOT_FOUND;
+
+	if (*VariableNameSize < StrSize(var->name)) {
+		*VariableNameSize = StrSize(var->name);
+		return EFI_BUFFER_TOO_SMALL;
+	}
+
+	StrCpy(VariableName, var->name);
+	*VendorGuid = var->guid;
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS host_set_variable(CHAR16 *VariableName, EFI_GUID *VendorGuid,
+				   UINT32 Attributes, UINTN DataSize, VOID *Data)
+{
+	variable_t **link, *var;
+	VOID *data;
+
+	if (!VariableName || !VariableName[0] || !VendorGuid)
+		return EFI_INVALID_PARAMETER;
+
+	link = find_variable(VariableName, VendorGuid);
+	var = *link;
+
+	if (!DataSize || !Attributes) {
+		if (!var)
+			return EFI_NOT_FOUND;
+		*link = var->next;
+		FreePool(var->name);
+		FreePool(var->data);
+		FreePool(var);
+		return EFI_SUCCESS;
+	}
+
+	if (var && var->attributes != Attributes)
+		return EFI_INVALID_PARAMETER;
+
+	data = AllocatePool(DataSize);
+	if (!data)
+		return EFI_OUT_OF_RESOURCES;
+	CopyMem(data, Data, DataSize);
+
+	if (!var) {
+		var = AllocateZeroPool(sizeof(*var));
+		if (!var) {
+			FreePool(data);
+			return EFI_OUT_OF_RESOURCES;
+		}
+		var->name = StrDuplicate(VariableName);
+		if (!var->name) {
+			FreePool(var);
+			FreePool(data);
+			return EFI_OUT_OF_RESOURCES;
+		}
+		var->guid = *VendorGuid;
+		var->attributes = Attributes;
+		var->next = variables;
+		variables = var;
+	}
+
+	FreePool(var->data);
+	var->data = data;
+	var->size = DataSize;
+	return EFI_SUCCESS;
+}
+
+static VOID host_reset_system(EFI_RESET_TYPE ResetType, EFI_STATUS ResetStatus,
+			      UINTN DataSize, VOID *ResetData)
+{
+	fflush(stdout);
+	exit(EFI_ERROR(ResetStatus) ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+static EFI_RUNTIME_SERVICES host_runtime_services = {
+	.GetTime = host_get_time,
+	.GetVariable = host_get_variable,
+	.GetNextVariableName = host_get_next_variable_name,
+	.SetVariable = host_set_variable,
+	.ResetSystem = host_reset_system
+};
+
+/*
+ * Console input: no key is ever pressed.
+ */
+static EFI_STATUS host_input_reset(SIMPLE_INPUT_INTERFACE *This,
+				   BOOLEAN ExtendedVerification)
+{
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS host_read_key_stroke(SIMPLE_INPUT_INTERFACE *This,
+				       EFI_INPUT_KEY *Key)
+{
+	return EFI_NOT_READY;
+}
+
+static SIMPLE_INPUT_INTERFACE host_con_in = {
+	.Reset = host_input_reset,
+	.ReadKeyStroke = host_read_key_stroke
+};
+
+static EFI_SYSTEM_TABLE host_system_table = {
+	.ConIn = &host_con_in,
+	.BootServices = &host_boot_services,
+	.RuntimeServices = &host_runtime_services
+};
+
+EFI_SYSTEM_TABLE *ST = &host_system_table;
+EFI_BOOT_SERVICES *BS = &host_boot_services;
+EFI_RUNTIME_SERVICES *RT = &host_runtime_services;
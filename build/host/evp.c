@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Host replacement of the OpenSSL message digests used by the modules
+ * built on the host.  Only SHA-256 is provided, by libavb.
+ */
+
+#include <efi.h>
+#include <efilib.h>
+#include <openssl/evp.h>
+
+#define AVB_COMPILATION
+#include "libavb/avb_sha.h"
+
+struct env_md_st {
+	int md_size;
+};
+
+static const EVP_MD sha256_md = { AVB_SHA256_DIGEST_SIZE };
+
+const EVP_MD *EVP_sha256(void)
+{
+	return &sha256_md;
+}
+
+int EVP_MD_size(const EVP_MD *md)
+{
+	return md->md_size;
+}
+
+void EVP_MD_CTX_init(EVP_MD_CTX *ctx)
+{
+	ctx->digest = NULL;
+	ctx->md_data = NULL;
+}
+
+int EVP_MD_CTX_cleanup(EVP_MD_CTX *ctx)
+{
+	if (ctx->md_data)
+		FreePool(ctx->md_data);
+	EVP_MD_CTX_init(ctx);
+	return 1;
+}
+
+int EVP_DigestInit_ex(EVP_MD_CTX *ctx, const EVP_MD *type, ENGINE *impl)
+{
+	if (type != &sha256_md)
+		return 0;
+
+	if (!ctx->md_data) {
+		ctx->md_data = AllocatePool(sizeof(AvbSHA256Ctx));
+		if (!ctx->md_data)
+			return 0;
+	}
+
+	ctx->digest = type;
+	avb_sha256_init(ctx->md_data);
+	return 1;
+}
+
+int EVP_DigestUpdate(EVP_MD_CTX *ctx, const void *d, size_t cnt)
+{
+	avb_sha256_update(ctx->md_data, d, cnt);
+	return 1;
+}
+
+int EVP_DigestFinal_ex(EVP_MD_CTX *ctx, unsigned char *md, unsigned int *s)
+{
+	CopyMem(md, avb_sha256_final(ctx->md_data), AVB_SHA256_DIGEST_SIZE);
+	if (s)
+		*s = AVB_SHA256_DIGEST_SIZE;
+	return 1;
+}
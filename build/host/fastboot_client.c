@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/*
+ * Host fastboot client, see fastboot_client.h.
+ */
+
+#include <endian.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "fastboot_client.h"
+
+static const char PROTOCOL_VERSION[4] = "FB01";
+
+static int write_all(int fd, const void *buf, size_t size)
+{
+	const char *p = buf;
+	ssize_t len;
+
+	for (; size; size -= len, p += len) {
+		len = write(fd, p, size);
+		if (len <= 0)
+			return -1;
+	}
+	return 0;
+}
+
+static int read_all(int fd, void *buf, size_t size)
+{
+	char *p = buf;
+	ssize_t len;
+
+	for (; size; size -= len, p += len) {
+		len = read(fd, p, size);
+		if (len <= 0)
+			return -1;
+	}
+	return 0;
+}
+
+static int send_packet(int fd, const void *buf, size_t size)
+{
+	uint64_t len = htobe64(size);
+
+	if (write_all(fd, &len, sizeof(len)))
+		return -1;
+	return write_all(fd, buf, size);
+}
+
+/* Receive one response packet as a nul terminated string */
+static int recv_response(int fd, char response[FB_RESPONSE_MAX + 1])
+{
+	uint64_t len;
+
+	if (read_all(fd, &len, sizeof(len)))
+		return -1;
+
+	len = be64toh(len);
+	if (len < 4 || len > FB_RESPONSE_MAX)
+		return -1;
+
+	if (read_all(fd, response, len))
+		return -1;
+	response[len] = '\0';
+	return 0;
+}
+
+int fb_connect(const char *path, int timeout_ms)
+{
+	struct sockaddr_un addr = { .sun_family = AF_UNIX };
+	char version[sizeof(PROTOCOL_VERSION)];
+	int fd;
+
+	if (strlen(path) >= sizeof(addr.sun_path))
+		return -1;
+	strcpy(addr.sun_path, path);
+
+	for (;;) {
+		fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0)
+			return -1;
+		if (!connect(fd, (struct sockaddr *)&addr, sizeof(addr)))
+			break;
+		close(fd);
+		if (timeout_ms <= 0)
+			return -1;
+		usleep(10 * 1000);
+		timeout_ms -= 10;
+	}
+
+	if (write_all(fd, PROTOCOL_VERSION, sizeof(PROTOCOL_VERSION)) ||
+	    read_all(fd, version, sizeof(version)) ||
+	    memcmp(version, PROTOCOL_VERSION, sizeof(version))) {
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+void fb_disconnect(int fd)
+{
+	close(fd);
+}
+
+/* Wait for the final response of a command, DATA being final for a
+ * download request */
+static int wait_response(int fd, char *reply, size_t *data_size)
+{
+	char response[FB_RESPONSE_MAX + 1];
+	unsigned long size;
+
+	for (;;) {
+		if (recv_response(fd, response))
+			return -1;
+
+		if (!strncmp(response, "INFO", 4)) {
+			fprintf(stderr, "(device) %s\n", response + 4);
+			continue;
+		}
+
+		if (reply)
+			strcpy(reply, response + 4);
+
+		if (!strncmp(response, "OKAY", 4))
+			return 0;
+		if (!strncmp(response, "FAIL", 4))
+			return 1;
+		if (data_size && !strncmp(response, "DATA", 4) &&
+		    sscanf(response + 4, "%08lx", &size) == 1) {
+			*data_size = size;
+			return 0;
+		}
+		return -1;
+	}
+}
+
+int fb_command(int fd, const char *cmd, char *reply)
+{
+	if (send_packet(fd, cmd, strlen(cmd)))
+		return -1;
+	return wait_response(fd, reply, NULL);
+}
+
+int fb_download(int fd, const void *data, size_t size, size_t chunk, char *reply)
+{
+	char cmd[FB_RESPONSE_MAX + 1];
+	const char *p = data;
+	size_t data_size = 0, len;
+	int ret;
+
+	snprintf(cmd, sizeof(cmd), "download:%08zx", size);
+	if (send_packet(fd, cmd, strlen(cmd)))
+		return -1;
+
+	ret = wait_response(fd, reply, &data_size);
+	if (ret)
+		return ret;
+	if (data_size != size)
+		return -1;
+
+	for (; size; size -= len, p += len) {
+		len = size < chunk ? size : chunk;
+		if (send_packet(fd, p, len))
+			return -1;
+	}
+
+	return wait_response(fd, reply, NULL);
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/*
+ * Minimal host fastboot client speaking the fastboot TCP protocol,
+ * the "FB01" handshake followed by packets prefixed with their 64
+ * bits big endian length, over a Unix socket.
+ */
+
+#ifndef _FASTBOOT_CLIENT_H_
+#define _FASTBOOT_CLIENT_H_
+
+#include <stddef.h>
+
+/* Largest response the device sends, see MAGIC_LENGTH */
+#define FB_RESPONSE_MAX 64
+
+/* Connect to the device listening on PATH, retrying for TIMEOUT_MS
+ * while it starts.  Return the connection or -1. */
+int fb_connect(const char *path, int timeout_ms);
+void fb_disconnect(int fd);
+
+/* Run CMD.  The INFO messages are printed on the standard error and
+ * the payload of the final OKAY or FAIL response is copied into
+ * REPLY if not NULL.  Return 0 on OKAY, 1 on FAIL and -1 on error. */
+int fb_command(int fd, const char *cmd, char *reply);
+
+/* Download SIZE bytes of DATA, sent in packets of at most CHUNK
+ * bytes.  Same return values as fb_command(). */
+int fb_download(int fd, const void *data, size_t size, size_t chunk, char *reply);
+
+#endif /* _FASTBOOT_CLIENT_H_ */
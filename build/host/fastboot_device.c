@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/*
+ * Device side of the fastboot host harness: the fastboot engine of
+ * libfastboot runs on the disk image of disk.c and is reached through
+ * the fastboot TCP protocol on the Unix socket of tcp.c.
+ */
+
+#include <efi.h>
+#include <efilib.h>
+
+#include "lib.h"
+#include "fastboot.h"
+#include "host.h"
+
+#define HOST_BLOCK_SIZE 512
+
+EFI_STATUS host_fastboot_serve(const char *disk_path, const char *socket_path)
+{
+	EFI_STATUS ret;
+	EFI_HANDLE disk;
+	void *bootimage = NULL, *efiimage = NULL;
+	UINTN imagesize;
+	enum boot_target target;
+
+	ret = host_disk_open(disk_path, HOST_BLOCK_SIZE, &disk);
+	if (EFI_ERROR(ret)) {
+		efi_perror(ret, L"Failed to open disk image %a", disk_path);
+		return ret;
+	}
+
+	host_tcp_set_path(socket_path);
+
+	ret = fastboot_start(&bootimage, &efiimage, &imagesize, &target);
+	if (EFI_ERROR(ret))
+		efi_perror(ret, L"Fastboot mode failed");
+	else
+		debug(L"Fastboot stopped, boot target %d", target);
+
+	if (bootimage)
+		FreePool(bootimage);
+
+	host_disk_close(disk);
+	return ret;
+}
@@ -0,0 +1,694 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/*
+ * Fastboot and adb host harness.
+ *
+ * Usage: kf-host-fastboot serve <disk image> <socket>
+ *        kf-host-fastboot serve-adb <disk image> <socket>
+ *        kf-host-fastboot test
+ *        kf-host-fastboot test-adb
+ *        kf-host-fastboot bench
+ *
+ * "serve" runs the fastboot engine on the disk image until it is told
+ * to continue or reboot, "serve-adb" the adb daemon until it is told
+ * to reboot.  "test" runs the fastboot engine on a scratch disk image
+ * and drives a session from a fastboot client over the socket:
+ * getvar, GPT, raw and sparse flashing, erase.  "test-adb" lays the
+ * scratch disk out with fastboot, then drives an adb session: shell
+ * command, partition pull and reboot.  "bench" lays the scratch disk
+ * out with fastboot, then times GPT parsing and sparse flashing in
+ * process.  The results are checked on the image and the suite prints
+ * "test Succeeded" or "test Failed".
+ *
+ * This file must not include lib.h, see efi_shim.c.
+ */
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "host.h"
+#include "adb_client.h"
+#include "fastboot_client.h"
+
+#define DISK_SIZE (64 * 1024 * 1024)
+#define SECTOR_SIZE 512
+#define MiB (1024 * 1024)
+
+/* gpt_bin.h layout, as generated by gpt_ini2bin.py */
+#define GPT_BIN_MAGIC 0x6a8b0da1
+
+struct gpt_bin_header {
+	uint32_t magic;
+	uint32_t start_lba;
+	uint32_t npart;
+};
+
+struct gpt_bin_part {
+	int32_t length;
+	uint16_t label[36];
+	uint8_t type[16];
+	uint8_t uuid[16];
+};
+
+/* sparse_format.h layout */
+#define SPARSE_HEADER_MAGIC 0xed26ff3a
+#define CHUNK_TYPE_RAW 0xCAC1
+#define CHUNK_TYPE_FILL 0xCAC2
+#define CHUNK_TYPE_DONT_CARE 0xCAC3
+#define SPARSE_BLOCK_SIZE 4096
+
+struct sparse_header {
+	uint32_t magic;
+	uint16_t major_version;
+	uint16_t minor_version;
+	uint16_t file_hdr_sz;
+	uint16_t chunk_hdr_sz;
+	uint32_t blk_sz;
+	uint32_t total_blks;
+	uint32_t total_chunks;
+	uint32_t image_checksum;
+};
+
+struct chunk_header {
+	uint16_t chunk_type;
+	uint16_t reserved1;
+	uint32_t chunk_sz;
+	uint32_t total_sz;
+};
+
+static const struct {
+	const char *label;
+	int32_t length;
+} PARTITIONS[] = {
+	{ "boot", 8 },
+	{ "system", 16 },
+	{ "misc", 1 },
+	{ "userdata", -1 }
+};
+
+/* Linux filesystem data */
+static const uint8_t LINUX_DATA_GUID[16] = {
+	0xaf, 0x3d, 0xc6, 0x0f, 0x83, 0x84, 0x72, 0x47,
+	0x8e, 0x79, 0x3d, 0x69, 0xd8, 0x47, 0x7d, 0xe4
+};
+
+static const char *suite = "fastboot";
+static int failures;
+
+static void check(const char *name, int ok)
+{
+	printf("%s %s %s\n", suite, name, ok ? "ok" : "failed");
+	if (!ok)
+		failures++;
+}
+
+static uint64_t now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static void fill_pattern(uint8_t *buf, size_t size, unsigned seed)
+{
+	size_t i;
+
+	for (i = 0; i < size; i++)
+		buf[i] = (uint8_t)(i * 31 + seed + (i >> 12));
+}
+
+/* Pattern which does not repeat within the disk, so that data read
+ * from the wrong offset is told apart */
+static void fill_unique(uint8_t *buf, size_t size)
+{
+	size_t i;
+
+	for (i = 0; i < size; i++)
+		buf[i] = (uint8_t)(i * 31 + (((i >> 12) * 2654435761u) >> 24));
+}
+
+/* Look LABEL up in the primary GPT of the disk image */
+static int find_partition(const char *disk, const char *label,
+			  uint64_t *offset, uint64_t *size)
+{
+	uint8_t header[SECTOR_SIZE], entry[128];
+	uint64_t entries_lba, first, last;
+	uint32_t i, count, entry_size;
+	size_t j;
+	int fd, found = 0;
+
+	fd = open(disk, O_RDONLY);
+	if (fd < 0)
+		return -1;
+
+	if (pread(fd, header, sizeof(header), SECTOR_SIZE) != sizeof(header) ||
+	    memcmp(header, "EFI PART", 8))
+		goto out;
+
+	memcpy(&entries_lba, header + 72, sizeof(entries_lba));
+	memcpy(&count, header + 80, sizeof(count));
+	memcpy(&entry_size, header + 84, sizeof(entry_size));
+
+	for (i = 0; i < count && !found; i++) {
+		if (pread(fd, entry, sizeof(entry), entries_lba * SECTOR_SIZE +
+			  (uint64_t)i * entry_size) != sizeof(entry))
+			break;
+
+		for (j = 0; label[j] && entry[56 + 2 * j] == label[j] &&
+			     !entry[57 + 2 * j]; j++)
+			;
+		if (label[j] || entry[56 + 2 * j] || entry[57 + 2 * j])
+			continue;
+
+		memcpy(&first, entry + 32, sizeof(first));
+		memcpy(&last, entry + 40, sizeof(last));
+		*offset = first * SECTOR_SIZE;
+		*size = (last + 1 - first) * SECTOR_SIZE;
+		found = 1;
+	}
+
+out:
+	close(fd);
+	return found ? 0 : -1;
+}
+
+static int disk_matches(const char *disk, uint64_t offset, const void *data, size_t size)
+{
+	uint8_t *buf;
+	int fd, ret = 0;
+
+	buf = malloc(size);
+	fd = open(disk, O_RDONLY);
+	if (buf && fd >= 0 && pread(fd, buf, size, offset) == (ssize_t)size)
+		ret = !memcmp(buf, data, size);
+
+	if (fd >= 0)
+		close(fd);
+	free(buf);
+	return ret;
+}
+
+static int flash(int fd, const char *label, const void *data, size_t size, char *reply)
+{
+	char cmd[FB_RESPONSE_MAX + 1];
+	int ret;
+
+	ret = fb_download(fd, data, size, MiB, reply);
+	if (ret)
+		return ret;
+
+	snprintf(cmd, sizeof(cmd), "flash:%s", label);
+	return fb_command(fd, cmd, reply);
+}
+
+static int getvar_is(int fd, const char *var, const char *expected)
+{
+	char cmd[FB_RESPONSE_MAX + 1], reply[FB_RESPONSE_MAX + 1];
+
+	snprintf(cmd, sizeof(cmd), "getvar:%s", var);
+	return !fb_command(fd, cmd, reply) && !strcmp(reply, expected);
+}
+
+static void test_gpt(int fd, const char *disk)
+{
+	struct {
+		struct gpt_bin_header header;
+		struct gpt_bin_part parts[sizeof(PARTITIONS) / sizeof(PARTITIONS[0])];
+	} gpt;
+	uint64_t offset, size;
+	char reply[FB_RESPONSE_MAX + 1];
+	size_t i, j;
+
+	memset(&gpt, 0, sizeof(gpt));
+	gpt.header.magic = GPT_BIN_MAGIC;
+	gpt.header.npart = sizeof(gpt.parts) / sizeof(gpt.parts[0]);
+	for (i = 0; i < gpt.header.npart; i++) {
+		gpt.parts[i].length = PARTITIONS[i].length;
+		for (j = 0; PARTITIONS[i].label[j]; j++)
+			gpt.parts[i].label[j] = PARTITIONS[i].label[j];
+		memcpy(gpt.parts[i].type, LINUX_DATA_GUID, sizeof(gpt.parts[i].type));
+		gpt.parts[i].uuid[0] = i + 1;
+	}
+
+	check("flash-gpt", !flash(fd, "gpt", &gpt, sizeof(gpt), reply));
+	check("gpt-layout", !find_partition(disk, "boot", &offset, &size) &&
+	      size == 8 * MiB && !find_partition(disk, "userdata", &offset, &size));
+	/* gnu-efi pads %X to the full width of the argument. */
+	check("getvar-partition-size", getvar_is(fd, "partition-size:boot",
+						 "0x0000000000800000"));
+	check("getvar-partition-type", getvar_is(fd, "partition-type:system", "ext4"));
+}
+
+static void test_flash_raw(int fd, const char *disk)
+{
+	const size_t size = 3 * MiB + 123;
+	uint64_t offset, part_size, start, us;
+	char reply[FB_RESPONSE_MAX + 1];
+	uint8_t *data;
+	int ret;
+
+	data = malloc(size);
+	if (!data || find_partition(disk, "boot", &offset, &part_size)) {
+		check("flash-raw", 0);
+		free(data);
+		return;
+	}
+
+	fill_pattern(data, size, 1);
+	start = now_us();
+	ret = flash(fd, "boot", data, size, reply);
+	us = now_us() - start;
+
+	check("flash-raw", !ret && disk_matches(disk, offset, data, size));
+	printf("bench name=fastboot-flash bytes=%zu loops=1 us=%llu kbps=%llu\n",
+	       size, (unsigned long long)us,
+	       (unsigned long long)(us ? size * 1000000ULL / 1024 / us : 0));
+
+	check("flash-too-large", flash(fd, "misc", data, size, reply) == 1);
+	free(data);
+}
+
+static size_t add_chunk(uint8_t *p, uint16_t type, uint32_t blocks,
+			const void *data, size_t size)
+{
+	struct chunk_header chunk = {
+		.chunk_type = type,
+		.chunk_sz = blocks,
+		.total_sz = sizeof(chunk) + size
+	};
+
+	memcpy(p, &chunk, sizeof(chunk));
+	if (size)
+		memcpy(p + sizeof(chunk), data, size);
+	return sizeof(chunk) + size;
+}
+
+static void test_flash_sparse(int fd, const char *disk)
+{
+	const uint32_t fill = 0xdeadbeef;
+	struct sparse_header header = {
+		.magic = SPARSE_HEADER_MAGIC,
+		.major_version = 1,
+		.file_hdr_sz = sizeof(struct sparse_header),
+		.chunk_hdr_sz = sizeof(struct chunk_header),
+		.blk_sz = SPARSE_BLOCK_SIZE,
+		.total_blks = 7,
+		.total_chunks = 4
+	};
+	uint8_t raw[3 * SPARSE_BLOCK_SIZE], expected[7 * SPARSE_BLOCK_SIZE];
+	uint8_t image[sizeof(header) + 4 * sizeof(struct chunk_header) + sizeof(raw) + sizeof(fill)];
+	char reply[FB_RESPONSE_MAX + 1];
+	uint64_t offset, size;
+	size_t len, i;
+
+	fill_pattern(raw, sizeof(raw), 2);
+
+	memcpy(image, &header, sizeof(header));
+	len = sizeof(header);
+	len += add_chunk(image + len, CHUNK_TYPE_RAW, 2, raw, 2 * SPARSE_BLOCK_SIZE);
+	len += add_chunk(image + len, CHUNK_TYPE_DONT_CARE, 1, NULL, 0);
+	len += add_chunk(image + len, CHUNK_TYPE_FILL, 3, &fill, sizeof(fill));
+	len += add_chunk(image + len, CHUNK_TYPE_RAW, 1, raw + 2 * SPARSE_BLOCK_SIZE,
+			 SPARSE_BLOCK_SIZE);
+
+	/* The partition is still blank, the skipped block reads as zero */
+	memset(expected, 0, sizeof(expected));
+	memcpy(expected, raw, 2 * SPARSE_BLOCK_SIZE);
+	for (i = 3 * SPARSE_BLOCK_SIZE; i < 6 * SPARSE_BLOCK_SIZE; i += sizeof(fill))
+		memcpy(expected + i, &fill, sizeof(fill));
+	memcpy(expected + 6 * SPARSE_BLOCK_SIZE, raw + 2 * SPARSE_BLOCK_SIZE,
+	       SPARSE_BLOCK_SIZE);
+
+	check("flash-sparse", !find_partition(disk, "system", &offset, &size) &&
+	      !flash(fd, "system", image, len, reply) &&
+	      disk_matches(disk, offset, expected, sizeof(expected)));
+}
+
+/* Sparse image covering the whole system partition with a repeated
+ * sequence of raw, fill and skipped blocks */
+#define BENCH_SPARSE_GROUPS 256
+
+static uint8_t *make_bench_sparse(size_t *len)
+{
+	const uint32_t fill = 0x5a5aa5a5;
+	struct sparse_header header = {
+		.magic = SPARSE_HEADER_MAGIC,
+		.major_version = 1,
+		.file_hdr_sz = sizeof(struct sparse_header),
+		.chunk_hdr_sz = sizeof(struct chunk_header),
+		.blk_sz = SPARSE_BLOCK_SIZE,
+		.total_blks = 16 * BENCH_SPARSE_GROUPS,
+		.total_chunks = 3 * BENCH_SPARSE_GROUPS
+	};
+	uint8_t raw[4 * SPARSE_BLOCK_SIZE], *image;
+	size_t i;
+
+	image = malloc(sizeof(header) + BENCH_SPARSE_GROUPS *
+		       (3 * sizeof(struct chunk_header) + sizeof(raw) + sizeof(fill)));
+	if (!image)
+		return NULL;
+
+	fill_pattern(raw, sizeof(raw), 4);
+	memcpy(image, &header, sizeof(header));
+	*len = sizeof(header);
+	for (i = 0; i < BENCH_SPARSE_GROUPS; i++) {
+		*len += add_chunk(image + *len, CHUNK_TYPE_RAW, 4, raw, sizeof(raw));
+		*len += add_chunk(image + *len, CHUNK_TYPE_FILL, 4, &fill, sizeof(fill));
+		*len += add_chunk(image + *len, CHUNK_TYPE_DONT_CARE, 8, NULL, 0);
+	}
+
+	return image;
+}
+
+static void test_erase(int fd, const char *disk)
+{
+	char reply[FB_RESPONSE_MAX + 1];
+	uint64_t offset, size;
+	uint8_t *zero;
+
+	zero = calloc(1, 8 * MiB);
+	check("erase", zero && !find_partition(disk, "boot", &offset, &size) &&
+	      !fb_command(fd, "erase:boot", reply) &&
+	      disk_matches(disk, offset, zero, size));
+	free(zero);
+
+	check("erase-unknown", fb_command(fd, "erase:nosuch", reply) == 1);
+}
+
+static int run_session(const char *disk, const char *sock)
+{
+	char reply[FB_RESPONSE_MAX + 1];
+	int fd;
+
+	fd = fb_connect(sock, 10 * 1000);
+	check("connect", fd >= 0);
+	if (fd < 0)
+		return -1;
+
+	check("getvar-version", getvar_is(fd, "version", "0.4"));
+	check("getvar-product", getvar_is(fd, "product", "kernelflinger-host"));
+	check("getvar-unknown", fb_command(fd, "getvar:nosuch", reply) == 1);
+	check("getvar-all", !fb_command(fd, "getvar:all", reply));
+
+	test_gpt(fd, disk);
+	test_flash_raw(fd, disk);
+	test_flash_sparse(fd, disk);
+	test_erase(fd, disk);
+
+	check("continue", !fb_command(fd, "continue", reply));
+	fb_disconnect(fd);
+	return 0;
+}
+
+/* Lay the disk out and flash the boot partition with a pattern for
+ * the adb session to read back */
+static int run_layout(const char *disk, const char *sock,
+		      uint8_t *boot, size_t boot_size)
+{
+	char reply[FB_RESPONSE_MAX + 1];
+	int fd;
+
+	fd = fb_connect(sock, 10 * 1000);
+	check("connect", fd >= 0);
+	if (fd < 0)
+		return -1;
+
+	test_gpt(fd, disk);
+	fill_pattern(boot, boot_size, 3);
+	check("flash-boot", !flash(fd, "boot", boot, boot_size, reply));
+
+	check("continue", !fb_command(fd, "continue", reply));
+	fb_disconnect(fd);
+	return 0;
+}
+
+/* Write the userdata partition of the disk image with a unique
+ * pattern for the adb session to read back in windows */
+static int write_userdata(const char *disk)
+{
+	uint64_t offset, size;
+	uint8_t *buf;
+	int fd, ret = -1;
+
+	if (find_partition(disk, "userdata", &offset, &size))
+		return -1;
+
+	buf = malloc(size);
+	fd = open(disk, O_WRONLY);
+	if (buf && fd >= 0) {
+		fill_unique(buf, size);
+		if (pwrite(fd, buf, size, offset) == (ssize_t)size)
+			ret = 0;
+	}
+
+	if (fd >= 0)
+		close(fd);
+	free(buf);
+	return ret;
+}
+
+/* Pull windows of userdata which start unaligned and cross the 10 MiB
+ * buffers of the adb partition reader, to check its read-ahead */
+static void test_adb_pull_windows(int fd, const char *disk)
+{
+	const uint64_t RB = 10 * MiB;
+	uint64_t offset, size;
+	char path[64];
+	uint8_t *buf;
+	size_t i;
+	long len;
+	int ok;
+
+	ok = !find_partition(disk, "userdata", &offset, &size);
+	buf = ok ? malloc(size) : NULL;
+	if (!buf) {
+		check("adb-pull-windows", 0);
+		return;
+	}
+
+	const struct {
+		uint64_t start;
+		uint64_t len;
+	} WINDOWS[] = {
+		{ 0, size },
+		{ 1, 2 * RB },
+		{ RB - 0x1ff, 0x400 },
+		{ RB - 1, RB + 2 },
+		{ 3 * SECTOR_SIZE + 5, 3 * RB + 0x1234 },
+		{ RB + 0x200, 0x100 },
+		{ size - 0x123, 0x123 }
+	};
+
+	for (i = 0; ok && i < sizeof(WINDOWS) / sizeof(*WINDOWS); i++) {
+		if (WINDOWS[i].start == 0 && WINDOWS[i].len == size)
+			snprintf(path, sizeof(path), "part:userdata");
+		else
+			snprintf(path, sizeof(path), "part:userdata:%llx:%llx",
+				 (unsigned long long)WINDOWS[i].start,
+				 (unsigned long long)WINDOWS[i].len);
+		len = adb_pull(fd, path, buf, size);
+		ok = len == (long)WINDOWS[i].len &&
+			disk_matches(disk, offset + WINDOWS[i].start, buf, len);
+		if (!ok)
+			fprintf(stderr, "%s: got %ld bytes\n", path, len);
+	}
+	check("adb-pull-windows", ok);
+	free(buf);
+}
+
+static int run_adb_session(const char *disk, const char *sock, const uint8_t *boot)
+{
+	const size_t boot_size = 8 * MiB;
+	uint64_t start, us;
+	char out[4096];
+	uint8_t *buf;
+	long len;
+	int fd;
+
+	fd = adb_connect(sock, 10 * 1000);
+	check("adb-connect", fd >= 0);
+	if (fd < 0)
+		return -1;
+
+	check("adb-shell", adb_shell(fd, "lspartition", out, sizeof(out)) > 0 &&
+	      strstr(out, "boot") && strstr(out, "userdata"));
+
+	buf = malloc(boot_size);
+	start = now_us();
+	len = buf ? adb_pull(fd, "part:boot", buf, boot_size) : -1;
+	us = now_us() - start;
+	check("adb-pull", len == (long)boot_size && !memcmp(buf, boot, boot_size));
+	printf("bench name=adb-pull bytes=%zu loops=1 us=%llu kbps=%llu\n",
+	       boot_size, (unsigned long long)us,
+	       (unsigned long long)(us ? boot_size * 1000000ULL / 1024 / us : 0));
+	free(buf);
+
+	test_adb_pull_windows(fd, disk);
+
+	check("adb-reboot", !adb_reboot(fd, "bootloader"));
+	adb_disconnect(fd);
+	return 0;
+}
+
+static void run_bench(const char *disk)
+{
+	uint8_t *sparse;
+	size_t len;
+
+	sparse = make_bench_sparse(&len);
+	fflush(stdout);
+	check("storage-bench", sparse &&
+	      !EFI_ERROR(host_storage_bench(disk, "system", sparse, len)));
+	free(sparse);
+}
+
+enum session {
+	SESSION_FASTBOOT,
+	SESSION_ADB,
+	SESSION_BENCH
+};
+
+/* Run SESSION on a scratch disk image.  The adb and bench sessions
+ * need the disk to be laid out by fastboot first. */
+static int test(enum session session)
+{
+	char dir[] = "/tmp/kf-host-fastboot.XXXXXX";
+	char disk[sizeof(dir) + 16], sock[sizeof(dir) + 16];
+	uint8_t *boot = NULL;
+	int fd, status;
+	pid_t device;
+
+	if (!mkdtemp(dir))
+		return 1;
+	snprintf(disk, sizeof(disk), "%s/disk.img", dir);
+	snprintf(sock, sizeof(sock), "%s/fastboot", dir);
+
+	fd = open(disk, O_RDWR | O_CREAT | O_TRUNC, 0600);
+	if (fd < 0 || ftruncate(fd, DISK_SIZE)) {
+		check("disk", 0);
+		goto out;
+	}
+	close(fd);
+
+	/* The boot partition pulled by adb is the pattern followed by
+	 * the blank end of the partition */
+	if (session != SESSION_FASTBOOT) {
+		boot = calloc(1, 8 * MiB);
+		if (!boot) {
+			check("disk", 0);
+			goto out;
+		}
+	}
+
+	fflush(stdout);
+	device = fork();
+	if (device == 0)
+		_exit(EFI_ERROR(host_fastboot_serve(disk, sock)) ? 1 : 0);
+	check("device", device > 0);
+	if (device < 0)
+		goto out;
+
+	if (session == SESSION_FASTBOOT ? run_session(disk, sock) :
+	    run_layout(disk, sock, boot, 3 * MiB + 123))
+		kill(device, SIGTERM);
+
+	check("device-exit", waitpid(device, &status, 0) == device &&
+	      WIFEXITED(status) && !WEXITSTATUS(status));
+
+	if (session == SESSION_FASTBOOT || failures)
+		goto out;
+
+	if (session == SESSION_BENCH) {
+		run_bench(disk);
+		goto out;
+	}
+
+	check("write-userdata", !write_userdata(disk));
+
+	fflush(stdout);
+	device = fork();
+	if (device == 0)
+		_exit(EFI_ERROR(host_adb_serve(disk, sock)) ? 1 : 0);
+	check("adb-device", device > 0);
+	if (device < 0)
+		goto out;
+
+	if (run_adb_session(disk, sock, boot))
+		kill(device, SIGTERM);
+
+	check("adb-device-exit", waitpid(device, &status, 0) == device &&
+	      WIFEXITED(status) && !WEXITSTATUS(status));
+
+out:
+	free(boot);
+	unlink(disk);
+	unlink(sock);
+	rmdir(dir);
+
+	printf("%s test %s\n", suite, failures ? "Failed" : "Succeeded");
+	return failures ? 1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc == 4 && !strcmp(argv[1], "serve"))
+		return EFI_ERROR(host_fastboot_serve(argv[2], argv[3])) ? 1 : 0;
+
+	if (argc == 4 && !strcmp(argv[1], "serve-adb"))
+		return EFI_ERROR(host_adb_serve(argv[2], argv[3])) ? 1 : 0;
+
+	if (argc == 2 && !strcmp(argv[1], "test"))
+		return test(SESSION_FASTBOOT);
+
+	if (argc == 2 && !strcmp(argv[1], "test-adb")) {
+		suite = "adb";
+		return test(SESSION_ADB);
+	}
+
+	if (argc == 2 && !strcmp(argv[1], "bench")) {
+		suite = "storage";
+		return test(SESSION_BENCH);
+	}
+
+	fprintf(stderr, "Usage: %s serve <disk image> <socket>\n"
+		"       %s serve-adb <disk image> <socket>\n"
+		"       %s test\n"
+		"       %s test-adb\n"
+		"       %s bench\n", argv[0], argv[0], argv[0], argv[0], argv[0]);
+	return 1;
+}
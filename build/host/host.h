@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/*
+ * Interfaces of the host harness emulating the firmware devices the
+ * host build drives: a handle database for the emulated protocols, a
+ * file backed disk and a Unix socket standing for the TCP transport.
+ *
+ * This header is shared between the harness files which use the C
+ * library and the modules built with lib.h, it only relies on efi.h.
+ */
+
+#ifndef _HOST_H_
+#define _HOST_H_
+
+#include <efi.h>
+
+/* Handle database, see efi_shim.c */
+EFI_STATUS host_install_protocol(EFI_HANDLE Handle, EFI_GUID *Protocol, VOID *Interface);
+VOID host_uninstall_protocols(EFI_HANDLE Handle);
+
+/* Disk image file exposed as a block device with the block io, disk
+ * io and device path protocols, see disk.c */
+EFI_STATUS host_disk_open(const char *path, UINT32 block_size, EFI_HANDLE *handle);
+VOID host_disk_close(EFI_HANDLE handle);
+
+/* Path of the Unix socket tcp_start() listens on, see tcp.c */
+VOID host_tcp_set_path(const char *path);
+
+/* Run the fastboot engine on DISK_PATH until it is told to continue
+ * or reboot, see fastboot_device.c */
+EFI_STATUS host_fastboot_serve(const char *disk_path, const char *socket_path);
+
+/* Run the adb daemon on DISK_PATH until it is told to reboot, see
+ * adb_device.c */
+EFI_STATUS host_adb_serve(const char *disk_path, const char *socket_path);
+
+/* Time GPT parsing and the flashing of the SPARSE image to the LABEL
+ * partition of DISK_PATH, see storage_bench.c */
+EFI_STATUS host_storage_bench(const char *disk_path, const char *label,
+			      VOID *sparse, UINTN sparse_size);
+
+#endif /* _HOST_H_ */
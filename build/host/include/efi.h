@@ -0,0 +1,546 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Minimal replacement of the gnu-efi headers for the host build.
+ * Only the types, protocols and services used by the modules built
+ * on the host are declared, with the gnu-efi names and layouts.
+ */
+
+#ifndef _HOST_EFI_H_
+#define _HOST_EFI_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+
+/* lib.h provides its own */
+#undef offsetof
+
+typedef uint8_t UINT8;
+typedef int8_t INT8;
+typedef uint16_t UINT16;
+typedef int16_t INT16;
+typedef uint32_t UINT32;
+typedef int32_t INT32;
+typedef uint64_t UINT64;
+typedef int64_t INT64;
+typedef unsigned long UINTN;
+typedef long INTN;
+typedef unsigned char CHAR8;
+typedef uint16_t CHAR16;
+typedef unsigned char BOOLEAN;
+typedef void VOID;
+
+#ifndef NULL
+#define NULL	((VOID *)0)
+#endif
+
+#define TRUE	((BOOLEAN)1)
+#define FALSE	((BOOLEAN)0)
+
+#define IN
+#define OUT
+#define OPTIONAL
+#define CONST const
+#define EFIAPI
+
+typedef UINTN EFI_STATUS;
+typedef UINTN EFI_TPL;
+typedef UINT64 EFI_LBA;
+typedef UINT64 EFI_PHYSICAL_ADDRESS;
+typedef UINT64 EFI_VIRTUAL_ADDRESS;
+typedef VOID *EFI_HANDLE;
+typedef VOID *EFI_EVENT;
+
+typedef struct {
+	UINT32 Data1;
+	UINT16 Data2;
+	UINT16 Data3;
+	UINT8 Data4[8];
+} EFI_GUID;
+
+#define EFI_ERROR_MASK		0x8000000000000000UL
+#define EFIERR(a)		(EFI_ERROR_MASK | (a))
+#define EFI_ERROR(a)		(((INTN)(a)) < 0)
+
+#define EFI_SUCCESS		0
+#define EFI_LOAD_ERROR		EFIERR(1)
+#define EFI_INVALID_PARAMETER	EFIERR(2)
+#define EFI_UNSUPPORTED		EFIERR(3)
+#define EFI_BAD_BUFFER_SIZE	EFIERR(4)
+#define EFI_BUFFER_TOO_SMALL	EFIERR(5)
+#define EFI_NOT_READY		EFIERR(6)
+#define EFI_DEVICE_ERROR	EFIERR(7)
+#define EFI_WRITE_PROTECTED	EFIERR(8)
+#define EFI_OUT_OF_RESOURCES	EFIERR(9)
+#define EFI_VOLUME_CORRUPTED	EFIERR(10)
+#define EFI_VOLUME_FULL		EFIERR(11)
+#define EFI_NO_MEDIA		EFIERR(12)
+#define EFI_MEDIA_CHANGED	EFIERR(13)
+#define EFI_NOT_FOUND		EFIERR(14)
+#define EFI_ACCESS_DENIED	EFIERR(15)
+#define EFI_NO_RESPONSE		EFIERR(16)
+#define EFI_NO_MAPPING		EFIERR(17)
+#define EFI_TIMEOUT		EFIERR(18)
+#define EFI_NOT_STARTED		EFIERR(19)
+#define EFI_ALREADY_STARTED	EFIERR(20)
+#define EFI_ABORTED		EFIERR(21)
+#define EFI_ICMP_ERROR		EFIERR(22)
+#define EFI_TFTP_ERROR		EFIERR(23)
+#define EFI_PROTOCOL_ERROR	EFIERR(24)
+#define EFI_INCOMPATIBLE_VERSION EFIERR(25)
+#define EFI_SECURITY_VIOLATION	EFIERR(26)
+#define EFI_CRC_ERROR		EFIERR(27)
+#define EFI_END_OF_MEDIA	EFIERR(28)
+#define EFI_END_OF_FILE		EFIERR(31)
+#define EFI_INVALID_LANGUAGE	EFIERR(32)
+#define EFI_COMPROMISED_DATA	EFIERR(33)
+
+#define EFI_PAGE_SIZE		4096
+#define EFI_PAGE_MASK		0xFFF
+#define EFI_PAGE_SHIFT		12
+#define EFI_SIZE_TO_PAGES(a)	(((a) >> EFI_PAGE_SHIFT) + ((a) & EFI_PAGE_MASK ? 1 : 0))
+#define EFI_PAGES_TO_SIZE(a)	((a) << EFI_PAGE_SHIFT)
+
+/* The host calling convention is the native one */
+#define uefi_call_wrapper(func, va_num, ...) func(__VA_ARGS__)
+
+typedef struct {
+	UINT16 Year;
+	UINT8 Month;
+	UINT8 Day;
+	UINT8 Hour;
+	UINT8 Minute;
+	UINT8 Second;
+	UINT8 Pad1;
+	UINT32 Nanosecond;
+	INT16 TimeZone;
+	UINT8 Daylight;
+	UINT8 Pad2;
+} EFI_TIME;
+
+typedef enum {
+	EfiResetCold,
+	EfiResetWarm,
+	EfiResetShutdown,
+	EfiResetPlatformSpecific
+} EFI_RESET_TYPE;
+
+typedef enum {
+	AllocateAnyPages,
+	AllocateMaxAddress,
+	AllocateAddress,
+	MaxAllocateType
+} EFI_ALLOCATE_TYPE;
+
+typedef enum {
+	EfiReservedMemoryType,
+	EfiLoaderCode,
+	EfiLoaderData,
+	EfiBootServicesCode,
+	EfiBootServicesData,
+	EfiRuntimeServicesCode,
+	EfiRuntimeServicesData,
+	EfiConventionalMemory,
+	EfiUnusableMemory,
+	EfiACPIReclaimMemory,
+	EfiACPIMemoryNVS,
+	EfiMemoryMappedIO,
+	EfiMemoryMappedIOPortSpace,
+	EfiPalCode,
+	EfiMaxMemoryType
+} EFI_MEMORY_TYPE;
+
+typedef struct {
+	UINT32 Type;
+	UINT32 Pad;
+	EFI_PHYSICAL_ADDRESS PhysicalStart;
+	EFI_VIRTUAL_ADDRESS VirtualStart;
+	UINT64 NumberOfPages;
+	UINT64 Attribute;
+} EFI_MEMORY_DESCRIPTOR;
+
+#define EFI_VARIABLE_NON_VOLATILE			0x00000001
+#define EFI_VARIABLE_BOOTSERVICE_ACCESS			0x00000002
+#define EFI_VARIABLE_RUNTIME_ACCESS			0x00000004
+#define EFI_VARIABLE_TIME_BASED_AUTHENTICATED_WRITE_ACCESS 0x00000020
+#define EFI_VARIABLE_APPEND_WRITE			0x00000040
+
+/* Console input */
+#define CHAR_NULL		0x0000
+#define CHAR_BACKSPACE		0x0008
+#define CHAR_TAB		0x0009
+#define CHAR_LINEFEED		0x000A
+#define CHAR_CARRIAGE_RETURN	0x000D
+#define SCAN_NULL		0x0000
+#define SCAN_UP			0x0001
+#define SCAN_DOWN		0x0002
+#define SCAN_RIGHT		0x0003
+#define SCAN_LEFT		0x0004
+#define SCAN_HOME		0x0005
+#define SCAN_END		0x0006
+#define SCAN_INSERT		0x0007
+#define SCAN_DELETE		0x0008
+#define SCAN_PAGE_UP		0x0009
+#define SCAN_PAGE_DOWN		0x000A
+#define SCAN_ESC		0x0017
+
+typedef struct {
+	UINT16 ScanCode;
+	CHAR16 UnicodeChar;
+} EFI_INPUT_KEY;
+
+struct _SIMPLE_INPUT_INTERFACE;
+typedef EFI_STATUS (*EFI_INPUT_RESET)(struct _SIMPLE_INPUT_INTERFACE *This,
+				      BOOLEAN ExtendedVerification);
+typedef EFI_STATUS (*EFI_INPUT_READ_KEY)(struct _SIMPLE_INPUT_INTERFACE *This,
+					 EFI_INPUT_KEY *Key);
+
+typedef struct _SIMPLE_INPUT_INTERFACE {
+	EFI_INPUT_RESET Reset;
+	EFI_INPUT_READ_KEY ReadKeyStroke;
+	EFI_EVENT WaitForKey;
+} SIMPLE_INPUT_INTERFACE, EFI_SIMPLE_TEXT_INPUT_PROTOCOL;
+
+/* Graphics output */
+typedef struct {
+	UINT8 Blue;
+	UINT8 Green;
+	UINT8 Red;
+	UINT8 Reserved;
+} EFI_GRAPHICS_OUTPUT_BLT_PIXEL;
+
+typedef enum {
+	EfiBltVideoFill,
+	EfiBltVideoToBltBuffer,
+	EfiBltBufferToVideo,
+	EfiBltVideoToVideo,
+	EfiGraphicsOutputBltOperationMax
+} EFI_GRAPHICS_OUTPUT_BLT_OPERATION;
+
+typedef struct {
+	UINT32 Version;
+	UINT32 HorizontalResolution;
+	UINT32 VerticalResolution;
+	UINT32 PixelFormat;
+	UINT32 PixelInformation[4];
+	UINT32 PixelsPerScanLine;
+} EFI_GRAPHICS_OUTPUT_MODE_INFORMATION;
+
+typedef struct {
+	UINT32 MaxMode;
+	UINT32 Mode;
+	EFI_GRAPHICS_OUTPUT_MODE_INFORMATION *Info;
+	UINTN SizeOfInfo;
+	EFI_PHYSICAL_ADDRESS FrameBufferBase;
+	UINTN FrameBufferSize;
+} EFI_GRAPHICS_OUTPUT_PROTOCOL_MODE;
+
+struct _EFI_GRAPHICS_OUTPUT_PROTOCOL;
+typedef struct _EFI_GRAPHICS_OUTPUT_PROTOCOL {
+	EFI_STATUS (*QueryMode)(struct _EFI_GRAPHICS_OUTPUT_PROTOCOL *This,
+				UINT32 ModeNumber, UINTN *SizeOfInfo,
+				EFI_GRAPHICS_OUTPUT_MODE_INFORMATION **Info);
+	EFI_STATUS (*SetMode)(struct _EFI_GRAPHICS_OUTPUT_PROTOCOL *This,
+			      UINT32 ModeNumber);
+	EFI_STATUS (*Blt)(struct _EFI_GRAPHICS_OUTPUT_PROTOCOL *This,
+			  EFI_GRAPHICS_OUTPUT_BLT_PIXEL *BltBuffer,
+			  EFI_GRAPHICS_OUTPUT_BLT_OPERATION BltOperation,
+			  UINTN SourceX, UINTN SourceY,
+			  UINTN DestinationX, UINTN DestinationY,
+			  UINTN Width, UINTN Height, UINTN Delta);
+	EFI_GRAPHICS_OUTPUT_PROTOCOL_MODE *Mode;
+} EFI_GRAPHICS_OUTPUT_PROTOCOL;
+
+/* Device paths */
+typedef struct _EFI_DEVICE_PATH {
+	UINT8 Type;
+	UINT8 SubType;
+	UINT8 Length[2];
+} EFI_DEVICE_PATH, EFI_DEVICE_PATH_PROTOCOL;
+
+#define HARDWARE_DEVICE_PATH	0x01
+#define HW_PCI_DP		0x01
+#define HW_CONTROLLER_DP	0x05
+#define ACPI_DEVICE_PATH	0x02
+#define ACPI_DP			0x01
+#define MESSAGING_DEVICE_PATH	0x03
+#define MSG_USB_DP		0x05
+#define MSG_SATA_DP		0x12
+#define MEDIA_DEVICE_PATH	0x04
+#define MEDIA_HARDDRIVE_DP	0x01
+#define END_DEVICE_PATH_TYPE	0x7f
+#define END_ENTIRE_DEVICE_PATH_SUBTYPE 0xff
+#define END_DEVICE_PATH_LENGTH	sizeof(EFI_DEVICE_PATH)
+
+typedef struct {
+	EFI_DEVICE_PATH Header;
+	UINT8 Function;
+	UINT8 Device;
+} PCI_DEVICE_PATH;
+
+typedef struct {
+	EFI_DEVICE_PATH Header;
+	UINT32 Controller;
+} CONTROLLER_DEVICE_PATH;
+
+typedef struct {
+	EFI_DEVICE_PATH Header;
+	UINT16 HBAPortNumber;
+	UINT16 PortMultiplierPortNumber;
+	UINT16 Lun;
+} SATA_DEVICE_PATH;
+
+typedef struct {
+	EFI_DEVICE_PATH Header;
+	UINT32 HID;
+	UINT32 UID;
+} ACPI_HID_DEVICE_PATH;
+
+#define PNP_EISA_ID_CONST	0x41d0
+#define EISA_ID(_Name, _Num)	((UINT32)((_Name) | (_Num) << 16))
+#define EISA_PNP_ID(_PNPId)	EISA_ID(PNP_EISA_ID_CONST, (_PNPId))
+#define PNP_EISA_ID_MASK	0xffff
+#define EISA_ID_TO_NUM(_Id)	((_Id) >> 16)
+
+typedef struct {
+	EFI_DEVICE_PATH Header;
+	UINT32 PartitionNumber;
+	UINT64 PartitionStart;
+	UINT64 PartitionSize;
+	UINT8 Signature[16];
+	UINT8 MBRType;
+	UINT8 SignatureType;
+} __attribute__((packed)) HARDDRIVE_DEVICE_PATH;
+
+#define DevicePathType(a)	((a)->Type & 0x7f)
+#define DevicePathSubType(a)	((a)->SubType)
+#define DevicePathNodeLength(a)	((a)->Length[0] | ((a)->Length[1] << 8))
+#define NextDevicePathNode(a)	((EFI_DEVICE_PATH *)((UINT8 *)(a) + DevicePathNodeLength(a)))
+#define IsDevicePathEndType(a)	(DevicePathType(a) == END_DEVICE_PATH_TYPE)
+#define IsDevicePathEnd(a)	(IsDevicePathEndType(a) && \
+				 DevicePathSubType(a) == END_ENTIRE_DEVICE_PATH_SUBTYPE)
+
+/* PCI devices, only their configuration space can be read */
+typedef enum {
+	EfiPciIoWidthUint8,
+	EfiPciIoWidthUint16,
+	EfiPciIoWidthUint32,
+	EfiPciIoWidthUint64
+} EFI_PCI_IO_PROTOCOL_WIDTH;
+
+struct _EFI_PCI_IO;
+typedef struct {
+	EFI_STATUS (*Read)(struct _EFI_PCI_IO *This, EFI_PCI_IO_PROTOCOL_WIDTH Width,
+			   UINT32 Offset, UINTN Count, VOID *Buffer);
+	EFI_STATUS (*Write)(struct _EFI_PCI_IO *This, EFI_PCI_IO_PROTOCOL_WIDTH Width,
+			    UINT32 Offset, UINTN Count, VOID *Buffer);
+} EFI_PCI_IO_PROTOCOL_CONFIG_ACCESS;
+
+typedef struct _EFI_PCI_IO {
+	EFI_PCI_IO_PROTOCOL_CONFIG_ACCESS Pci;
+} EFI_PCI_IO;
+
+/* File system */
+#define EFI_FILE_MODE_READ	0x0000000000000001UL
+#define EFI_FILE_MODE_WRITE	0x0000000000000002UL
+#define EFI_FILE_MODE_CREATE	0x8000000000000000UL
+
+#define EFI_FILE_READ_ONLY	0x0000000000000001UL
+#define EFI_FILE_DIRECTORY	0x0000000000000010UL
+
+typedef struct {
+	UINT64 Size;
+	UINT64 FileSize;
+	UINT64 PhysicalSize;
+	EFI_TIME CreateTime;
+	EFI_TIME LastAccessTime;
+	EFI_TIME ModificationTime;
+	UINT64 Attribute;
+	CHAR16 FileName[1];
+} EFI_FILE_INFO;
+
+struct _EFI_FILE_HANDLE;
+typedef struct _EFI_FILE_HANDLE {
+	UINT64 Revision;
+	EFI_STATUS (*Open)(struct _EFI_FILE_HANDLE *File,
+			   struct _EFI_FILE_HANDLE **NewHandle,
+			   CHAR16 *FileName, UINT64 OpenMode, UINT64 Attributes);
+	EFI_STATUS (*Close)(struct _EFI_FILE_HANDLE *File);
+	EFI_STATUS (*Delete)(struct _EFI_FILE_HANDLE *File);
+	EFI_STATUS (*Read)(struct _EFI_FILE_HANDLE *File, UINTN *BufferSize,
+			   VOID *Buffer);
+	EFI_STATUS (*Write)(struct _EFI_FILE_HANDLE *File, UINTN *BufferSize,
+			    VOID *Buffer);
+	EFI_STATUS (*GetPosition)(struct _EFI_FILE_HANDLE *File, UINT64 *Position);
+	EFI_STATUS (*SetPosition)(struct _EFI_FILE_HANDLE *File, UINT64 Position);
+	EFI_STATUS (*GetInfo)(struct _EFI_FILE_HANDLE *File, EFI_GUID *InformationType,
+			      UINTN *BufferSize, VOID *Buffer);
+	EFI_STATUS (*SetInfo)(struct _EFI_FILE_HANDLE *File, EFI_GUID *InformationType,
+			      UINTN BufferSize, VOID *Buffer);
+	EFI_STATUS (*Flush)(struct _EFI_FILE_HANDLE *File);
+} EFI_FILE, *EFI_FILE_HANDLE;
+
+struct _EFI_FILE_IO_INTERFACE;
+typedef struct _EFI_FILE_IO_INTERFACE {
+	UINT64 Revision;
+	EFI_STATUS (*OpenVolume)(struct _EFI_FILE_IO_INTERFACE *This,
+				 EFI_FILE_HANDLE *Root);
+} EFI_FILE_IO_INTERFACE;
+
+typedef struct {
+	UINT32 Revision;
+	EFI_HANDLE ParentHandle;
+	VOID *SystemTable;
+	EFI_HANDLE DeviceHandle;
+	EFI_DEVICE_PATH *FilePath;
+	VOID *Reserved;
+	UINT32 LoadOptionsSize;
+	VOID *LoadOptions;
+	VOID *ImageBase;
+	UINT64 ImageSize;
+	EFI_MEMORY_TYPE ImageCodeType;
+	EFI_MEMORY_TYPE ImageDataType;
+	VOID *Unload;
+} EFI_LOADED_IMAGE;
+
+/* Block devices */
+typedef struct {
+	UINT32 MediaId;
+	BOOLEAN RemovableMedia;
+	BOOLEAN MediaPresent;
+	BOOLEAN LogicalPartition;
+	BOOLEAN ReadOnly;
+	BOOLEAN WriteCaching;
+	UINT32 BlockSize;
+	UINT32 IoAlign;
+	EFI_LBA LastBlock;
+	EFI_LBA LowestAlignedLba;
+	UINT32 LogicalBlocksPerPhysicalBlock;
+	UINT32 OptimalTransferLengthGranularity;
+} EFI_BLOCK_IO_MEDIA;
+
+#define EFI_BLOCK_IO_PROTOCOL_REVISION3 ((2 << 16) | 31)
+
+struct _EFI_BLOCK_IO;
+typedef struct _EFI_BLOCK_IO {
+	UINT64 Revision;
+	EFI_BLOCK_IO_MEDIA *Media;
+	EFI_STATUS (*Reset)(struct _EFI_BLOCK_IO *This, BOOLEAN ExtendedVerification);
+	EFI_STATUS (*ReadBlocks)(struct _EFI_BLOCK_IO *This, UINT32 MediaId,
+				 EFI_LBA LBA, UINTN BufferSize, VOID *Buffer);
+	EFI_STATUS (*WriteBlocks)(struct _EFI_BLOCK_IO *This, UINT32 MediaId,
+				  EFI_LBA LBA, UINTN BufferSize, VOID *Buffer);
+	EFI_STATUS (*FlushBlocks)(struct _EFI_BLOCK_IO *This);
+} EFI_BLOCK_IO;
+
+struct _EFI_DISK_IO;
+typedef struct _EFI_DISK_IO {
+	UINT64 Revision;
+	EFI_STATUS (*ReadDisk)(struct _EFI_DISK_IO *This, UINT32 MediaId,
+			       UINT64 Offset, UINTN BufferSize, VOID *Buffer);
+	EFI_STATUS (*WriteDisk)(struct _EFI_DISK_IO *This, UINT32 MediaId,
+				UINT64 Offset, UINTN BufferSize, VOID *Buffer);
+} EFI_DISK_IO;
+
+/* Services */
+typedef enum {
+	AllHandles,
+	ByRegisterNotify,
+	ByProtocol
+} EFI_LOCATE_SEARCH_TYPE;
+
+typedef enum {
+	EFI_NATIVE_INTERFACE
+} EFI_INTERFACE_TYPE;
+
+typedef VOID (*EFI_EVENT_NOTIFY)(EFI_EVENT Event, VOID *Context);
+
+typedef struct {
+	EFI_STATUS (*AllocatePages)(EFI_ALLOCATE_TYPE Type, EFI_MEMORY_TYPE MemoryType,
+				    UINTN NoPages, EFI_PHYSICAL_ADDRESS *Memory);
+	EFI_STATUS (*FreePages)(EFI_PHYSICAL_ADDRESS Memory, UINTN NoPages);
+	EFI_STATUS (*GetMemoryMap)(UINTN *MemoryMapSize, EFI_MEMORY_DESCRIPTOR *MemoryMap,
+				   UINTN *MapKey, UINTN *DescriptorSize,
+				   UINT32 *DescriptorVersion);
+	EFI_STATUS (*AllocatePool)(EFI_MEMORY_TYPE PoolType, UINTN Size, VOID **Buffer);
+	EFI_STATUS (*FreePool)(VOID *Buffer);
+	EFI_STATUS (*CreateEvent)(UINT32 Type, EFI_TPL NotifyTpl,
+				  EFI_EVENT_NOTIFY NotifyFunction,
+				  VOID *NotifyContext, EFI_EVENT *Event);
+	EFI_STATUS (*WaitForEvent)(UINTN NumberOfEvents, EFI_EVENT *Event, UINTN *Index);
+	EFI_STATUS (*SignalEvent)(EFI_EVENT Event);
+	EFI_STATUS (*CloseEvent)(EFI_EVENT Event);
+	EFI_STATUS (*HandleProtocol)(EFI_HANDLE Handle, EFI_GUID *Protocol,
+				     VOID **Interface);
+	EFI_STATUS (*ReinstallProtocolInterface)(EFI_HANDLE Handle, EFI_GUID *Protocol,
+						 VOID *OldInterface, VOID *NewInterface);
+	EFI_STATUS (*LocateHandle)(EFI_LOCATE_SEARCH_TYPE SearchType,
+				   EFI_GUID *Protocol, VOID *SearchKey,
+				   UINTN *BufferSize, EFI_HANDLE *Buffer);
+	EFI_STATUS (*LocateDevicePath)(EFI_GUID *Protocol, EFI_DEVICE_PATH **DevicePath,
+				       EFI_HANDLE *Device);
+	EFI_STATUS (*LocateHandleBuffer)(EFI_LOCATE_SEARCH_TYPE SearchType,
+					 EFI_GUID *Protocol, VOID *SearchKey,
+					 UINTN *NoHandles, EFI_HANDLE **Buffer);
+	EFI_STATUS (*ConnectController)(EFI_HANDLE ControllerHandle,
+					EFI_HANDLE *DriverImageHandle,
+					EFI_DEVICE_PATH *RemainingDevicePath,
+					BOOLEAN Recursive);
+	EFI_STATUS (*LocateProtocol)(EFI_GUID *Protocol, VOID *Registration,
+				     VOID **Interface);
+	EFI_STATUS (*Exit)(EFI_HANDLE ImageHandle, EFI_STATUS ExitStatus,
+			   UINTN ExitDataSize, CHAR16 *ExitData);
+	EFI_STATUS (*Stall)(UINTN Microseconds);
+	EFI_STATUS (*SetWatchdogTimer)(UINTN Timeout, UINT64 WatchdogCode,
+				       UINTN DataSize, CHAR16 *WatchdogData);
+	EFI_STATUS (*CalculateCrc32)(VOID *Data, UINTN DataSize, UINT32 *Crc32);
+} EFI_BOOT_SERVICES;
+
+typedef struct {
+	EFI_STATUS (*GetTime)(EFI_TIME *Time, VOID *Capabilities);
+	EFI_STATUS (*GetVariable)(CHAR16 *VariableName, EFI_GUID *VendorGuid,
+				  UINT32 *Attributes, UINTN *DataSize, VOID *Data);
+	EFI_STATUS (*GetNextVariableName)(UINTN *VariableNameSize,
+					  CHAR16 *VariableName, EFI_GUID *VendorGuid);
+	EFI_STATUS (*SetVariable)(CHAR16 *VariableName, EFI_GUID *VendorGuid,
+				  UINT32 Attributes, UINTN DataSize, VOID *Data);
+	VOID (*ResetSystem)(EFI_RESET_TYPE ResetType, EFI_STATUS ResetStatus,
+			    UINTN DataSize, VOID *ResetData);
+} EFI_RUNTIME_SERVICES;
+
+typedef struct {
+	SIMPLE_INPUT_INTERFACE *ConIn;
+	EFI_BOOT_SERVICES *BootServices;
+	EFI_RUNTIME_SERVICES *RuntimeServices;
+} EFI_SYSTEM_TABLE;
+
+#endif /* _HOST_EFI_H_ */
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Host implementation of the gnu-efi library subset used by the
+ * modules built on the host, see efi_shim.c.
+ */
+
+#ifndef _HOST_EFILIB_H_
+#define _HOST_EFILIB_H_
+
+#include <efi.h>
+
+extern EFI_SYSTEM_TABLE *ST;
+extern EFI_BOOT_SERVICES *BS;
+extern EFI_RUNTIME_SERVICES *RT;
+
+extern EFI_GUID GenericFileInfo;
+extern EFI_GUID GraphicsOutputProtocol;
+extern EFI_GUID LoadedImageProtocol;
+extern EFI_GUID BlockIoProtocol;
+extern EFI_GUID DiskIoProtocol;
+extern EFI_GUID DevicePathProtocol;
+extern EFI_GUID FileSystemProtocol;
+extern EFI_GUID PciIoProtocol;
+extern EFI_GUID NullGuid;
+extern EFI_GUID EfiPartTypeSystemPartitionGuid;
+
+VOID *AllocatePool(UINTN Size);
+VOID *AllocateZeroPool(UINTN Size);
+VOID *ReallocatePool(VOID *OldPool, UINTN OldSize, UINTN NewSize);
+VOID FreePool(VOID *Buffer);
+
+VOID ZeroMem(VOID *Buffer, UINTN Size);
+VOID SetMem(VOID *Buffer, UINTN Size, UINT8 Value);
+VOID CopyMem(VOID *Dest, const VOID *Src, UINTN len);
+INTN CompareMem(const VOID *Dest, const VOID *Src, UINTN len);
+INTN CompareGuid(const EFI_GUID *Guid1, const EFI_GUID *Guid2);
+
+UINTN StrLen(const CHAR16 *s1);
+UINTN StrSize(const CHAR16 *s1);
+INTN StrCmp(const CHAR16 *s1, const CHAR16 *s2);
+INTN StrnCmp(const CHAR16 *s1, const CHAR16 *s2, UINTN len);
+VOID StrCpy(CHAR16 *Dest, const CHAR16 *Src);
+VOID StrCat(CHAR16 *Dest, const CHAR16 *Src);
+CHAR16 *StrDuplicate(const CHAR16 *Src);
+UINTN Atoi(const CHAR16 *str);
+UINTN xtoi(const CHAR16 *str);
+
+UINTN strlena(const CHAR8 *s1);
+INTN strcmpa(const CHAR8 *s1, const CHAR8 *s2);
+INTN strncmpa(const CHAR8 *s1, const CHAR8 *s2, UINTN len);
+
+UINT64 DivU64x32(UINT64 Dividend, UINTN Divisor, UINTN *Remainder);
+UINT64 MultU64x32(UINT64 Multiplicand, UINTN Multiplier);
+
+/* The host output is plain ASCII on stdout */
+UINTN Print(const CHAR16 *fmt, ...);
+UINTN VPrint(const CHAR16 *fmt, va_list args);
+UINTN SPrint(CHAR16 *Str, UINTN StrSize, const CHAR16 *fmt, ...);
+UINTN VSPrint(CHAR16 *Str, UINTN StrSize, const CHAR16 *fmt, va_list args);
+CHAR16 *PoolPrint(const CHAR16 *fmt, ...);
+CHAR16 *VPoolPrint(const CHAR16 *fmt, va_list args);
+
+EFI_DEVICE_PATH *DevicePathFromHandle(EFI_HANDLE Handle);
+UINTN DevicePathSize(EFI_DEVICE_PATH *DevPath);
+CHAR16 *DevicePathToStr(EFI_DEVICE_PATH *DevPath);
+EFI_STATUS LibLocateProtocol(EFI_GUID *ProtocolGuid, VOID **Interface);
+EFI_FILE_HANDLE LibOpenRoot(EFI_HANDLE DeviceHandle);
+EFI_FILE_INFO *LibFileInfo(EFI_FILE_HANDLE FHand);
+
+#endif /* _HOST_EFILIB_H_ */
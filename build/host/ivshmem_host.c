@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Run the ivshmem peer of the unittest in a thread of its own, like
+ * the hypervisor side of the shared memory: ringing the doorbell only
+ * wakes the thread up and the guest side has to poll for the
+ * completion.  The peer attach and detach calls are redirected here
+ * with the linker --wrap option.
+ */
+
+#include <pthread.h>
+
+#include <efi.h>
+#include <efilib.h>
+#include "ivshmem.h"
+
+void __real_ivshmem_attach(ivshmem_peer_t *peer);
+void __real_ivshmem_detach(void);
+
+static struct {
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	ivshmem_peer_t *peer;
+	ivshmem_peer_t host;
+	UINT32 vector;
+	BOOLEAN pending;
+	BOOLEAN stop;
+} ivh = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.cond = PTHREAD_COND_INITIALIZER
+};
+
+static void *ivh_thread(__attribute__((__unused__)) void *arg)
+{
+	UINT32 vector;
+
+	pthread_mutex_lock(&ivh.lock);
+	for (;;) {
+		while (!ivh.pending && !ivh.stop)
+			pthread_cond_wait(&ivh.cond, &ivh.lock);
+		if (ivh.stop)
+			break;
+		vector = ivh.vector;
+		ivh.pending = FALSE;
+		pthread_mutex_unlock(&ivh.lock);
+
+		ivh.peer->doorbell(vector);
+
+		pthread_mutex_lock(&ivh.lock);
+	}
+	pthread_mutex_unlock(&ivh.lock);
+
+	return NULL;
+}
+
+static void ivh_doorbell(UINT32 vector)
+{
+	pthread_mutex_lock(&ivh.lock);
+	ivh.vector = vector;
+	ivh.pending = TRUE;
+	pthread_cond_signal(&ivh.cond);
+	pthread_mutex_unlock(&ivh.lock);
+}
+
+void __wrap_ivshmem_attach(ivshmem_peer_t *peer)
+{
+	ivh.peer = peer;
+	ivh.host.page = peer->page;
+	ivh.host.doorbell = ivh_doorbell;
+	ivh.pending = ivh.stop = FALSE;
+
+	if (pthread_create(&ivh.thread, NULL, ivh_thread, NULL)) {
+		error(L"Failed to start the ivshmem host thread");
+		__real_ivshmem_attach(peer);
+		ivh.peer = NULL;
+		return;
+	}
+
+	__real_ivshmem_attach(&ivh.host);
+}
+
+void __wrap_ivshmem_detach(void)
+{
+	__real_ivshmem_detach();
+	if (!ivh.peer)
+		return;
+
+	pthread_mutex_lock(&ivh.lock);
+	ivh.stop = TRUE;
+	pthread_cond_signal(&ivh.cond);
+	pthread_mutex_unlock(&ivh.lock);
+	pthread_join(ivh.thread, NULL);
+	ivh.peer = NULL;
+}
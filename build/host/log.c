@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Host replacement of libkernelflinger/log.c: messages go to the
+ * standard error so that the standard output only carries the test
+ * and benchmark results.
+ */
+
+#include <stdio.h>
+
+#include <efi.h>
+#include <efilib.h>
+#include "log.h"
+
+EFI_STATUS log_flush_to_var(__attribute__((__unused__)) BOOLEAN nonvol)
+{
+	return EFI_SUCCESS;
+}
+
+void vlog(const CHAR16 *fmt, va_list args)
+{
+	CHAR16 *str;
+	UINTN i;
+
+	str = VPoolPrint(fmt, args);
+	if (!str)
+		return;
+
+	for (i = 0; str[i]; i++)
+		fputc(str[i] < 0x80 ? str[i] : '?', stderr);
+	FreePool(str);
+}
+
+void log(const CHAR16 *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	vlog(fmt, args);
+	va_end(args);
+}
@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Host stand-ins for the firmware modules the host build leaves out
+ * but which the built modules refer to.
+ */
+
+#include <efi.h>
+#include <efilib.h>
+
+#include "lib.h"
+#include "vars.h"
+#include "slot.h"
+#include "watchdog.h"
+#include "em.h"
+#include "info.h"
+#include "fastboot_flashing.h"
+#include "libavb_ab/libavb_ab.h"
+#include "uefi_avb_ops.h"
+#include "uefi_utils.h"
+#include "android.h"
+#include "hashes.h"
+#include "bootmgr.h"
+#include "acpi.h"
+
+/* From vars.c, the variables themselves are handled by efi_shim.c */
+const EFI_GUID loader_guid = { 0x4a67b082, 0x0a4c, 0x41cf,
+	{0xb6, 0xc7, 0x44, 0x0b, 0x29, 0xbb, 0x8c, 0x4f} };
+const EFI_GUID fastboot_guid = { 0x1ac80a82, 0x4f0c, 0x456b,
+	{0x9a, 0x99, 0xde, 0xbe, 0xb4, 0x31, 0xfc, 0xc1} };
+
+/* The host device is always unlocked */
+enum device_state get_current_state(void)
+{
+	return UNLOCKED;
+}
+
+const char *get_current_state_string(void)
+{
+	return "unlocked";
+}
+
+BOOLEAN device_is_unlocked(void)
+{
+	return TRUE;
+}
+
+/* The host plays a UEFI firmware, see is_UEFI() in vars.c */
+BOOLEAN is_UEFI(VOID)
+{
+	return TRUE;
+}
+
+/* The digest cache switch is only kept in memory */
+static BOOLEAN vb_digest_cache;
+
+BOOLEAN get_vb_digest_cache(void)
+{
+	return vb_digest_cache;
+}
+
+EFI_STATUS set_vb_digest_cache(BOOLEAN enabled)
+{
+	vb_digest_cache = enabled;
+	return EFI_SUCCESS;
+}
+
+/* and does not use A/B slots, the slot.c functions behave as they do
+ * when slot management is not in use. */
+const CHAR16 *SLOT_STORAGE_PART = MISC_LABEL;
+
+BOOLEAN use_slot(void)
+{
+	return FALSE;
+}
+
+const CHAR16 *slot_label(const CHAR16 *base)
+{
+	return base;
+}
+
+const CHAR16 *slot_base(const CHAR16 *label)
+{
+	return label;
+}
+
+const char *slot_get_active(void)
+{
+	return NULL;
+}
+
+UINTN slot_get_suffixes(char **suffixes_p[])
+{
+	return 0;
+}
+
+const char *slot_get_successful(const char *suffix)
+{
+	return NULL;
+}
+
+const char *slot_get_unbootable(const char *suffix)
+{
+	return NULL;
+}
+
+const char *slot_get_retry_count(const char *suffix)
+{
+	return NULL;
+}
+
+EFI_STATUS slot_reset(void)
+{
+	return EFI_SUCCESS;
+}
+
+EFI_STATUS slot_set_verity_corrupted(BOOLEAN corrupted)
+{
+	return EFI_SUCCESS;
+}
+
+/* The host has no A/B metadata to write back before a reset */
+EFI_STATUS slot_commit(void)
+{
+	return EFI_SUCCESS;
+}
+
+/* nor a virtual A/B snapshot in progress */
+AvbOps *uefi_avb_ops_new(void)
+{
+	static AvbOps ops;
+
+	return &ops;
+}
+
+void uefi_avb_ops_free(AvbOps *ops)
+{
+}
+
+AvbIOResult avb_ab_data_read(AvbABOps *ab_ops, AvbABData *data)
+{
+	return AVB_IO_RESULT_ERROR_IO;
+}
+
+AvbIOResult avb_ab_data_write(AvbABOps *ab_ops, const AvbABData *data)
+{
+	return AVB_IO_RESULT_ERROR_IO;
+}
+
+uint8_t avb_ab_get_snapshot_merge_status(AvbABOps *ab_ops)
+{
+	return NONE;
+}
+
+/* From android.c, which needs the whole boot path */
+UINT32 pagealign(struct boot_img_hdr *hdr, UINT32 blob_size)
+{
+	UINT32 page_mask = hdr->page_size - 1;
+	return (blob_size + page_mask) & (~page_mask);
+}
+
+UINTN bootimage_size(struct boot_img_hdr *aosp_header)
+{
+	UINTN size;
+
+	size = pagealign(aosp_header, aosp_header->kernel_size) +
+		pagealign(aosp_header, aosp_header->ramdisk_size) +
+		pagealign(aosp_header, aosp_header->second_size) +
+		aosp_header->page_size;
+
+	if (aosp_header->header_version >= 1)
+		size += pagealign(aosp_header, aosp_header->recovery_acpio_size);
+
+	if (aosp_header->header_version == 2)
+		size += pagealign(aosp_header, aosp_header->acpi_size);
+
+	return size;
+}
+
+/* From hashes.c, the host EVP stand-in only provides SHA-256 */
+const EVP_MD *get_hash_algorithm(void)
+{
+	return EVP_sha256();
+}
+
+/* The host has no ESP file system and cannot load EFI images, the
+ * ESP and bootloader flash paths fail as on a device without them. */
+EFI_STATUS get_esp_fs(EFI_FILE_IO_INTERFACE **esp_fs)
+{
+	return EFI_NOT_FOUND;
+}
+
+EFI_STATUS uefi_read_file(EFI_FILE_IO_INTERFACE *io, CHAR16 *filename,
+			  void **data, UINTN *size)
+{
+	return EFI_UNSUPPORTED;
+}
+
+EFI_STATUS uefi_write_file_with_dir(EFI_FILE_IO_INTERFACE *io, CHAR16 *filename,
+				    void *data, UINTN size)
+{
+	return EFI_UNSUPPORTED;
+}
+
+EFI_STATUS verify_image(EFI_HANDLE handle, CHAR16 *path)
+{
+	return EFI_UNSUPPORTED;
+}
+
+EFI_STATUS bootmgr_register_entries(CHAR16 *part_label,
+				    load_option_t *load_options,
+				    UINTN load_option_nb)
+{
+	return EFI_UNSUPPORTED;
+}
+
+/* From acpi.c, the host has no ACPI tables */
+EFI_STATUS get_acpi_table(const CHAR8 *signature, VOID **table)
+{
+	return EFI_NOT_FOUND;
+}
+
+/* From info.c, without SMBIOS tables */
+const char *info_bootloader_version(void)
+{
+	return "host";
+}
+
+const char *info_baseband_version(void)
+{
+	return "N/A";
+}
+
+const char *info_variant(void)
+{
+	return "host";
+}
+
+const char *info_product(void)
+{
+	return "kernelflinger-host";
+}
+
+const char *info_hw_revision(void)
+{
+	return "host";
+}
+
+/* No battery */
+EFI_STATUS get_battery_voltage(UINTN *voltage)
+{
+	return EFI_UNSUPPORTED;
+}
+
+/* Locking the device is not supported on the host, the flashing
+ * commands are not registered */
+EFI_STATUS fastboot_flashing_init(void)
+{
+	return EFI_SUCCESS;
+}
+
+void fastboot_flashing_free()
+{
+}
+
+/* nor a TCO watchdog */
+EFI_STATUS start_watchdog(__attribute__((__unused__)) UINT32 seconds)
+{
+	return EFI_UNSUPPORTED;
+}
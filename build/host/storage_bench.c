@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/*
+ * Benchmarks of the storage code on the disk image of disk.c: GPT
+ * parsing and sparse image flashing through the regular flash path.
+ * The results use the format of the unittest "bench" suite.
+ */
+
+#include <efi.h>
+#include <efilib.h>
+
+#include "lib.h"
+#include "gpt.h"
+#include "flash.h"
+#include "timer.h"
+#include "host.h"
+
+#define HOST_BLOCK_SIZE 512
+#define GPT_LOOPS 256
+#define SPARSE_LOOPS 8
+
+static void bench_report(const char *name, UINTN bytes, UINTN loops, UINT64 ticks)
+{
+	UINT64 us = ticks / get_cpu_freq();
+	UINT64 kbps = us ? (UINT64)bytes * loops / 1024 * 1000000 / us : 0;
+
+	Print(L"bench name=%a bytes=%d loops=%d us=%ld kbps=%ld\n",
+	      name, bytes, loops, us, kbps);
+}
+
+/* Parse the GPT from the disk again at each loop */
+static EFI_STATUS bench_gpt(const CHAR16 *label)
+{
+	struct gpt_partition_interface gparti;
+	struct gpt_header *gh;
+	EFI_STATUS ret;
+	UINT64 start, ticks = 0;
+	UINTN i, size;
+
+	for (i = 0; i < GPT_LOOPS; i++) {
+		gpt_free_cache();
+		start = rdtsc();
+		ret = gpt_get_partition_by_label(label, &gparti, LOGICAL_UNIT_USER);
+		ticks += rdtsc() - start;
+		if (EFI_ERROR(ret)) {
+			efi_perror(ret, L"Failed to find partition %s", label);
+			return ret;
+		}
+	}
+
+	ret = gpt_get_header(&gh, &size, LOGICAL_UNIT_USER);
+	if (EFI_ERROR(ret))
+		return ret;
+
+	bench_report("gpt_parse", HOST_BLOCK_SIZE + gh->number_of_entries * gh->size_of_entry,
+		     GPT_LOOPS, ticks);
+	FreePool(gh);
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS bench_sparse(CHAR16 *label, VOID *sparse, UINTN sparse_size)
+{
+	EFI_STATUS ret;
+	UINT64 start, ticks = 0;
+	UINTN i;
+
+	for (i = 0; i < SPARSE_LOOPS; i++) {
+		start = rdtsc();
+		ret = flash(sparse, sparse_size, label);
+		ticks += rdtsc() - start;
+		if (EFI_ERROR(ret)) {
+			efi_perror(ret, L"Failed to flash %s", label);
+			return ret;
+		}
+	}
+
+	bench_report("flash_sparse", sparse_size, SPARSE_LOOPS, ticks);
+	return EFI_SUCCESS;
+}
+
+EFI_STATUS host_storage_bench(const char *disk_path, const char *label,
+			      VOID *sparse, UINTN sparse_size)
+{
+	EFI_STATUS ret;
+	EFI_HANDLE disk;
+	CHAR16 *label16;
+
+	label16 = stra_to_str((CHAR8 *)label);
+	if (!label16)
+		return EFI_OUT_OF_RESOURCES;
+
+	ret = host_disk_open(disk_path, HOST_BLOCK_SIZE, &disk);
+	if (EFI_ERROR(ret)) {
+		efi_perror(ret, L"Failed to open disk image %a", disk_path);
+		goto free;
+	}
+
+	ret = bench_gpt(label16);
+	if (!EFI_ERROR(ret))
+		ret = bench_sparse(label16, sparse, sparse_size);
+
+	gpt_free_cache();
+	host_disk_close(disk);
+free:
+	FreePool(label16);
+	return ret;
+}
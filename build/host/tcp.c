@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/*
+ * Host replacement of libefitcp/tcp.c.  The listening TCP port is a
+ * Unix stream socket so the fastboot TCP protocol of
+ * fastboot_transport.c runs unmodified against a host client.
+ *
+ * Completions are reported from tcp_run() as the EFI TCP4 protocol
+ * signals them from its Poll() function: tcp_read() completes once
+ * the whole buffer has been received and tcp_write() once the whole
+ * buffer has been sent.  Like libefitcp, up to MAX_TOKEN writes can be
+ * queued and they complete in order.  A closed connection is replaced
+ * by the next one accepted on the socket.
+ *
+ * This file must not include lib.h, see efi_shim.c.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <efi.h>
+#include <efilib.h>
+
+#include "host.h"
+#include "tcp.h"
+
+/* Time tcp_run() waits for an event, so the caller does not spin */
+#define POLL_TIMEOUT_MS 10
+
+/* Writes in flight, as the transmit tokens of libefitcp */
+#define MAX_TOKEN 16
+
+static const char *socket_path;
+static int listen_fd = -1;
+static int conn_fd = -1;
+
+static start_callback_t start_callback;
+static data_callback_t rx_callback;
+static data_callback_t tx_callback;
+
+static struct io {
+	char *buf;
+	UINT32 size;
+	UINT32 done;
+	BOOLEAN pending;
+} rx, tx[MAX_TOKEN];
+static UINTN tx_head, tx_count;
+
+VOID host_tcp_set_path(const char *path)
+{
+	socket_path = path;
+}
+
+static void close_connection(void)
+{
+	if (conn_fd >= 0)
+		close(conn_fd);
+	conn_fd = -1;
+	rx.pending = FALSE;
+	tx_head = tx_count = 0;
+}
+
+EFI_STATUS tcp_start(UINT32 port, start_callback_t start_cb,
+		     data_callback_t rx_cb, data_callback_t tx_cb,
+		     EFI_IPv4_ADDRESS *station_address)
+{
+	struct sockaddr_un addr = { .sun_family = AF_UNIX };
+
+	if (!socket_path)
+		return EFI_UNSUPPORTED;
+
+	if (!start_cb || !rx_cb || !tx_cb || !station_address ||
+	    strlen(socket_path) >= sizeof(addr.sun_path))
+		return EFI_INVALID_PARAMETER;
+
+	strcpy(addr.sun_path, socket_path);
+	unlink(socket_path);
+
+	listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+	if (listen_fd < 0)
+		return EFI_DEVICE_ERROR;
+
+	if (bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) ||
+	    listen(listen_fd, 1)) {
+		close(listen_fd);
+		listen_fd = -1;
+		return EFI_DEVICE_ERROR;
+	}
+
+	start_callback = start_cb;
+	rx_callback = rx_cb;
+	tx_callback = tx_cb;
+
+	station_address->Addr[0] = 127;
+	station_address->Addr[1] = 0;
+	station_address->Addr[2] = 0;
+	station_address->Addr[3] = 1;
+
+	return EFI_SUCCESS;
+}
+
+EFI_STATUS tcp_stop(void)
+{
+	close_connection();
+
+	if (listen_fd >= 0) {
+		close(listen_fd);
+		unlink(socket_path);
+	}
+	listen_fd = -1;
+
+	return EFI_SUCCESS;
+}
+
+EFI_STATUS tcp_read(void *buf, UINT32 size)
+{
+	if (conn_fd < 0)
+		return EFI_NOT_STARTED;
+	if (rx.pending)
+		return EFI_NOT_READY;
+
+	rx.buf = buf;
+	rx.size = size;
+	rx.done = 0;
+	rx.pending = TRUE;
+
+	return EFI_SUCCESS;
+}
+
+EFI_STATUS tcp_write(void *buf, UINT32 size)
+{
+	struct io *io;
+
+	if (conn_fd < 0)
+		return EFI_NOT_STARTED;
+	if (tx_count == MAX_TOKEN)
+		return EFI_NOT_READY;
+
+	io = &tx[(tx_head + tx_count++) % MAX_TOKEN];
+	io->buf = buf;
+	io->size = size;
+	io->done = 0;
+	io->pending = TRUE;
+
+	return EFI_SUCCESS;
+}
+
+/* Move data for IO and return TRUE when it has completed.  The
+ * connection is closed if the peer has gone. */
+static BOOLEAN process_io(struct io *io, BOOLEAN send)
+{
+	ssize_t len;
+
+	len = send ? write(conn_fd, io->buf + io->done, io->size - io->done) :
+		read(conn_fd, io->buf + io->done, io->size - io->done);
+	if (len < 0 && (errno == EAGAIN || errno == EINTR))
+		return FALSE;
+	if (len <= 0) {
+		close_connection();
+		return FALSE;
+	}
+
+	io->done += len;
+	if (io->done < io->size)
+		return FALSE;
+
+	io->pending = FALSE;
+	return TRUE;
+}
+
+EFI_STATUS tcp_run(void)
+{
+	struct pollfd pfd;
+	struct io *io;
+
+	if (listen_fd < 0)
+		return EFI_NOT_STARTED;
+
+	if (conn_fd < 0) {
+		pfd.fd = listen_fd;
+		pfd.events = POLLIN;
+		if (poll(&pfd, 1, POLL_TIMEOUT_MS) <= 0)
+			return EFI_SUCCESS;
+
+		conn_fd = accept(listen_fd, NULL, NULL);
+		if (conn_fd < 0)
+			return EFI_SUCCESS;
+
+		fcntl(conn_fd, F_SETFL, O_NONBLOCK);
+		start_callback();
+		return EFI_SUCCESS;
+	}
+
+	pfd.fd = conn_fd;
+	pfd.events = (rx.pending ? POLLIN : 0) | (tx_count ? POLLOUT : 0);
+	if (poll(&pfd, 1, POLL_TIMEOUT_MS) <= 0)
+		return EFI_SUCCESS;
+
+	if (pfd.revents & (POLLHUP | POLLERR) && !(pfd.revents & POLLIN)) {
+		close_connection();
+		return EFI_SUCCESS;
+	}
+
+	/* Transmit first, the engine only posts the next read once
+	 * its answer has been sent. */
+	while (tx_count && pfd.revents & POLLOUT && process_io(&tx[tx_head], TRUE)) {
+		io = &tx[tx_head];
+		tx_head = (tx_head + 1) % MAX_TOKEN;
+		tx_count--;
+		tx_callback(io->buf, io->size);
+	}
+
+	if (conn_fd >= 0 && rx.pending && pfd.revents & POLLIN &&
+	    process_io(&rx, FALSE))
+		rx_callback(rx.buf, rx.size);
+
+	return EFI_SUCCESS;
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Host replacement of libkernelflinger/timer.c: the time stamp
+ * counter is read from the monotonic clock, in nanoseconds, so that
+ * get_cpu_freq() is a constant 1000 ticks per microsecond.
+ */
+
+#include <time.h>
+
+#include <efi.h>
+#include <efilib.h>
+#include "timer.h"
+
+#define HOST_TICKS_PER_US	1000
+
+uint64_t rdtsc(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+uint32_t get_cpu_freq(void)
+{
+	return HOST_TICKS_PER_US;
+}
+
+uint32_t boottime_in_msec(void)
+{
+	return rdtsc() / (HOST_TICKS_PER_US * 1000);
+}
+
+void set_boottime_stamp(__attribute__((__unused__)) int num)
+{
+}
+
+void set_efi_enter_point(__attribute__((__unused__)) unsigned int value)
+{
+}
+
+void construct_stages_boottime(CHAR8 *time_str, size_t buf_len)
+{
+	if (time_str && buf_len)
+		time_str[0] = '\0';
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/*
+ * Host replacement of libefiusb/usb.c: the host has no USB device
+ * controller, the transport layer falls back to the next back-end.
+ */
+
+#include <efi.h>
+#include <efilib.h>
+
+#include "usb.h"
+
+EFI_STATUS usb_start(UINT8 subclass, UINT8 protocol, CHAR16 *str_configuration,
+		     CHAR16 *str_interface, start_callback_t start_cb,
+		     data_callback_t rx_cb, data_callback_t tx_cb)
+{
+	return EFI_UNSUPPORTED;
+}
+
+EFI_STATUS usb_stop(void)
+{
+	return EFI_NOT_STARTED;
+}
+
+EFI_STATUS usb_run(void)
+{
+	return EFI_NOT_STARTED;
+}
+
+EFI_STATUS usb_read(void *buf, UINT32 size)
+{
+	return EFI_NOT_STARTED;
+}
+
+EFI_STATUS usb_write(void *buf, UINT32 size)
+{
+	return EFI_NOT_STARTED;
+}
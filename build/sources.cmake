@@ -182,6 +182,7 @@ set(LIB_FASTBOOT_SOURCES
 
 set(LIB_KERNELFLINGER_SOURCES
 	${LIB_KERNELFLINGER_SOURCE}/android.c
+	${LIB_KERNELFLINGER_SOURCE}/cmdline.c
 	${LIB_KERNELFLINGER_SOURCE}/efilinux.c
 	${LIB_KERNELFLINGER_SOURCE}/acpi.c
 	${LIB_KERNELFLINGER_SOURCE}/acpi_image.c
@@ -216,6 +217,7 @@ set(LIB_KERNELFLINGER_SOURCES
 	${LIB_KERNELFLINGER_SOURCE}/ias_sig.c
 	${LIB_KERNELFLINGER_SOURCE}/no_ui.c
 	${LIB_KERNELFLINGER_SOURCE}/ui_color.c
+	${LIB_KERNELFLINGER_SOURCE}/ui_scale.c
 	${LIB_KERNELFLINGER_SOURCE}/fatfs/source/diskio.c
 	${LIB_KERNELFLINGER_SOURCE}/fatfs/source/ff.c
 	${LIB_KERNELFLINGER_SOURCE}/fatfs/source/ffsystem.c
@@ -569,9 +569,7 @@ EFI_STATUS get_bootimage_blob(VOID *bootimage, enum blobtype btype, VOID **blob,
 /* Get a pointer and size to the 2ndstage area of a boot image */
 EFI_STATUS get_bootimage_2nd(VOID *bootimage, VOID **second, UINT32 *size);
 
-EFI_STATUS prepend_command_line(CHAR16 **cmdline, CHAR16 *fmt, ...);
-
-EFI_STATUS prepend_slot_command_line(CHAR16 **cmdline16,
+EFI_STATUS prepend_slot_command_line(struct cmdline *cl,
                                      enum boot_target boot_target,
                                      VBDATA *vb_data);
 
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef _CMDLINE_H_
+#define _CMDLINE_H_
+
+#include <efi.h>
+#include <efiapi.h>
+
+/* Command line builder.  The content is an ASCII string made of
+ * segments separated by a separator character, ' ' for the kernel
+ * command line and '\n' for the bootconfig.  Segments can be added at
+ * both ends in a time proportional to their length: the buffer keeps
+ * some room on each side of the content and doubles when it is full.
+ *
+ * A builder initialized with cmdline_init_fixed() works on a caller
+ * provided buffer, never grows and only supports appending. */
+struct cmdline {
+	CHAR8 *buf;
+	UINTN size;
+	UINTN start;
+	UINTN len;
+	CHAR8 sep;
+	BOOLEAN fixed;
+	CHAR16 *scratch;
+	UINTN scratch_len;
+};
+
+EFI_STATUS cmdline_init(struct cmdline *cl, UINTN size, CHAR8 sep);
+void cmdline_init_fixed(struct cmdline *cl, CHAR8 *buf, UINTN size, CHAR8 sep);
+void cmdline_free(struct cmdline *cl);
+
+/* Add LEN characters of STR as a new segment.  Empty segments are
+ * ignored. */
+EFI_STATUS cmdline_prepend_stra(struct cmdline *cl, const CHAR8 *str, UINTN len);
+EFI_STATUS cmdline_append_stra(struct cmdline *cl, const CHAR8 *str, UINTN len);
+/* Extend the last segment with LEN characters of STR */
+EFI_STATUS cmdline_cat_stra(struct cmdline *cl, const CHAR8 *str, UINTN len);
+
+/* Format a new segment with the Print() syntax.  Non-ASCII characters
+ * are rejected with EFI_INVALID_PARAMETER. */
+EFI_STATUS cmdline_prepend(struct cmdline *cl, const CHAR16 *fmt, ...);
+EFI_STATUS cmdline_append(struct cmdline *cl, const CHAR16 *fmt, ...);
+
+/* Remove LEN characters at POS, a pointer in the string returned by
+ * cmdline_str(). */
+void cmdline_remove(struct cmdline *cl, CHAR8 *pos, UINTN len);
+
+/* NUL terminated content of the builder */
+CHAR8 *cmdline_str(struct cmdline *cl);
+
+static inline UINTN cmdline_len(struct cmdline *cl)
+{
+	return cl->len;
+}
+
+/* Return the content as a pool allocated string to be freed with
+ * FreePool() and reset the builder. */
+CHAR8 *cmdline_detach(struct cmdline *cl);
+
+#endif	/* _CMDLINE_H_ */
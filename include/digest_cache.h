@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef _DIGEST_CACHE_H_
+#define _DIGEST_CACHE_H_
+
+#include <efi.h>
+#include <efiapi.h>
+
+/* Digests of the partitions verified by a previous boot of an
+ * unlocked device.  An entry is only trusted while the write
+ * generation, incremented by every flash, erase, set_active and
+ * device state change while the cache is enabled, is the one it has
+ * been recorded with.  The cache is disabled by default, never used
+ * on a locked device and not available on user builds. */
+
+#define DIGEST_CACHE_ENTRIES		8
+#define DIGEST_CACHE_NAME_LEN		36
+#define DIGEST_CACHE_DIGEST_LEN		64
+
+EFI_STATUS digest_cache_invalidate(void);
+BOOLEAN digest_cache_lookup(const char *partition, UINT64 image_size,
+			    const UINT8 *digest, UINTN digest_len);
+EFI_STATUS digest_cache_store(const char *partition, UINT64 image_size,
+			      const UINT8 *digest, UINTN digest_len);
+
+#endif	/* _DIGEST_CACHE_H_ */
@@ -75,10 +75,28 @@ typedef struct fat_fs {
 	struct gpt_partition_interface parti;
 } FAT_FS;
 
+/* Size of the read cache in front of the ESP.  A cache miss reads
+ * FAT_CACHE_SIZE bytes ahead so that the following FAT, directory
+ * and file data sectors of a contiguous run are served from memory.
+ */
+#ifndef FAT_CACHE_SIZE
+#define FAT_CACHE_SIZE (128 * 1024)
+#endif
+
+/* Number of DWORD entries of the fast seek cluster link map */
+#define FAT_LINKMAP_SIZE 256
+
 typedef struct fatsystem {
 	struct gpt_partition_interface parti;
 	FATFS fatfs;
-	UINT32 bpb_offset;
+	UINT64 bpb_offset;
+	UINT32 sector_size;
+	UINT64 part_end;
+	struct {
+		UINT8 *buf;
+		UINT64 offset;
+		UINT32 len;
+	} cache;
 } FATSYSTEM;
 
 typedef struct fatfs_fsobj {
@@ -95,10 +113,33 @@ typedef struct fatfs_fsobj {
 	UINT16 FstClusLO;
 	UINT16 FileSize;
 } FATFS_FSOBJ;
-EFI_STATUS fat_readdisk(UINT32 offset, UINT32 len, void *data);
-EFI_STATUS fat_writedisk(UINT32 offset, UINT32 len, void *data);
-UINT32 fat_getbpb_offset();
+#define FAT_DIRENT_SIZE 32
+
+/* Location of a file stored in a single run of clusters.  Offsets are
+ * in bytes from the start of the partition.  The directory entry and
+ * the CRC32 of the FAT entries of the run are kept so that the extent
+ * can be checked against the volume without mounting it.
+ */
+typedef struct fat_extent {
+	UINT64 starting_lba;
+	UINT64 data_offset;
+	UINT64 size;
+	UINT64 dirent_offset;
+	UINT64 fat_offset;
+	UINT32 fat_len;
+	UINT32 fat_crc;
+	UINT8 dirent[FAT_DIRENT_SIZE];
+} fat_extent_t;
+
+EFI_STATUS fat_readdisk(UINT64 offset, UINT32 len, void *data);
+EFI_STATUS fat_writedisk(UINT64 offset, UINT32 len, void *data);
+UINT64 fat_getbpb_offset();
+UINT32 fat_get_sector_size();
 EFI_STATUS fat_init();
 VOID debug_hex(UINT32 offset, CHAR8 *data, UINT16 size);
 EFI_STATUS flash_fwupdate(VOID *data, UINTN size);
+EFI_STATUS fat_get_file_extent(const CHAR16 *label, const TCHAR *path,
+			       fat_extent_t *ext);
+EFI_STATUS fat_check_file_extent(struct gpt_partition_interface *parti,
+				 fat_extent_t *ext);
 #endif /* _FATFS_H_ */
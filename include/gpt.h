@@ -97,6 +97,7 @@ EFI_STATUS gpt_create(struct gpt_header *gh, UINTN gh_size,
 		      UINT64 start_lba, UINTN part_count, struct gpt_bin_part *gbp, logical_unit_t log_unit);
 void gpt_free_cache(void);
 EFI_STATUS gpt_refresh(void);
+EFI_STATUS gpt_refresh_partition(const CHAR16 *label, logical_unit_t log_unit);
 EFI_STATUS gpt_get_root_disk(struct gpt_partition_interface *gpart, logical_unit_t log_unit);
 EFI_STATUS gpt_get_partition_uuid(const CHAR16 *label, EFI_GUID *uuid, logical_unit_t log_unit);
 EFI_STATUS gpt_get_partition_type(const CHAR16 *label, EFI_GUID *type, logical_unit_t log_unit);
@@ -52,6 +52,7 @@ EFI_STATUS ivshmem_init(void);
 
 void ivshmem_rot_interrupt(void);
 
+/* RET is filled in by the host, a negative value reports a failure. */
 struct tpm2_int_req {
         UINT32 cmd;
         volatile INT32 ret;
@@ -59,6 +60,43 @@ struct tpm2_int_req {
         UINT8  payload[0];
 };
 
-void ivshmem_rollback_index_interrupt(struct tpm2_int_req* req);
+/* Return an error if the request could not be delivered to the host,
+ * in which case REQ->ret is meaningless. */
+EFI_STATUS ivshmem_rollback_index_interrupt(struct tpm2_int_req* req);
+
+/* A host that can take several requests per doorbell writes
+ * IVSHMEM_QUEUE_MAGIC at the start of the rollback index page.  The
+ * guest then packs the requests after the queue header, each one
+ * aligned on IVSHMEM_QUEUE_ALIGN bytes, bumps seq and rings
+ * IVSHMEM_BATCH_INTERRUPT.  The host handles them in order, fills in
+ * their ret and payload, and copies seq to done once it is finished. */
+#define IVSHMEM_QUEUE_MAGIC		0x51555651
+#define IVSHMEM_QUEUE_ALIGN		8
+#define IVSHMEM_QUEUE_SIZE		0x1000
+#define IVSHMEM_BATCH_INTERRUPT		0x3
+
+struct ivshmem_queue {
+	UINT32 magic;
+	volatile UINT32 seq;
+	volatile UINT32 done;
+	UINT32 count;
+	UINT8 reqs[0];
+};
+
+BOOLEAN ivshmem_batch_supported(void);
+/* Same as ivshmem_rollback_index_interrupt() for COUNT requests. */
+EFI_STATUS ivshmem_rollback_index_batch(struct tpm2_int_req **reqs, UINTN count);
+
+/* The peer replaces the host side of the shared memory, it is used
+ * to exercise the request queue without a hypervisor. */
+typedef struct ivshmem_peer {
+	/* Shared memory used in place of the rollback index page. */
+	void *page;
+	/* Called instead of writing to the doorbell register. */
+	void (*doorbell)(UINT32 vector);
+} ivshmem_peer_t;
+
+void ivshmem_attach(ivshmem_peer_t *peer);
+void ivshmem_detach(void);
 
 #endif /* _IVSHMEM_H_ */
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef _LOOPBACK_H_
+#define _LOOPBACK_H_
+
+#include <efi.h>
+#include <transport.h>
+
+/* The loopback transport connects the fastboot or adb engine to a peer
+ * running in the same image instead of a USB or TCP host.  It is only
+ * selected when a peer is attached. */
+typedef struct loopback_peer {
+	/* Called by loopback_run() while the device waits for data.
+	 * Return EFI_NOT_READY when there is nothing to send yet. */
+	EFI_STATUS (*poll)(void);
+	/* Called with each buffer written by the device. */
+	void (*receive)(void *buf, UINT32 size);
+} loopback_peer_t;
+
+EFI_STATUS loopback_attach(loopback_peer_t *peer);
+void loopback_detach(void);
+EFI_STATUS loopback_send(const void *buf, UINTN size);
+
+EFI_STATUS loopback_start(start_callback_t start_cb,
+			  data_callback_t rx_cb,
+			  data_callback_t tx_cb);
+EFI_STATUS loopback_stop(void);
+EFI_STATUS loopback_run(void);
+EFI_STATUS loopback_read(void *buf, UINT32 size);
+EFI_STATUS loopback_write(void *buf, UINT32 size);
+
+#endif	/* _LOOPBACK_H_ */
@@ -38,6 +38,10 @@
 
 #define PCI_DEVICE_ID_ANY 0xFFFF
 
+#define PCI_CLASS_NETWORK	0x02
+#define PCI_CLASS_SERIAL_BUS	0x0C
+#define PCI_SUBCLASS_USB	0x03
+
 typedef struct _pci_device_ids
 {
 	UINT16 vendor_id;
@@ -83,4 +87,18 @@ EFI_STATUS get_pci_device(IN EFI_DEVICE_PATH *p, OUT EFI_PCI_IO **p_pciio);
  */
 EFI_STATUS get_pci_ids(IN EFI_PCI_IO *pciio, OUT pci_device_ids_t *ids);
 
+/**
+ * get_pci_class:
+ * @pciio - The EFI_PCI_IO_PROTOCOL handle for a device
+ * @class - Base class code
+ * @subclass - Sub-class code
+ *
+ * Reads the class code from the PCI configuration space
+ *
+ * Returns:
+ * EFI_SUCCESS - The operation succeeded
+ * an EFI Error if the values could not be read
+ */
+EFI_STATUS get_pci_class(IN EFI_PCI_IO *pciio, OUT UINT8 *class, OUT UINT8 *subclass);
+
 #endif	/* _PCI_H_ */
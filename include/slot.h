@@ -108,6 +108,12 @@ EFI_STATUS slot_reset(void);
 /* Stores the slot AB metadata on disk. */
 EFI_STATUS slot_restore(void);
 
+/* Writes the slot AB metadata to disk if it has been modified since
+ * the last write.  Slot updates are only kept in memory until this is
+ * called before handing over to the OS, before a reset and before a
+ * fastboot command is acknowledged. */
+EFI_STATUS slot_commit(void);
+
 /* Given a boot TARGET, decrements the corresponding tries count if
  * necessary. */
 EFI_STATUS slot_boot(enum boot_target target);
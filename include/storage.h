@@ -62,8 +62,25 @@ typedef enum {
 /* It is faster to erase multiple block at once */
 #define N_BLOCK (4096)
 
+/* Discard commands are issued in slices of at most this number of
+ * blocks so that a single command never exceeds the device command
+ * timeout and progress can be reported on large partitions.
+ */
+#define DISCARD_SLICE_BLOCKS (0x200000)
+
 struct storage {
 	EFI_STATUS (*erase_blocks)(EFI_HANDLE handle, EFI_BLOCK_IO *bio, EFI_LBA start, EFI_LBA end);
+	/* Deallocate the [start, end] range, which is never larger
+	 * than DISCARD_SLICE_BLOCKS. ZEROED is set to TRUE if the
+	 * device guarantees that deallocated blocks read back as
+	 * zero. */
+	EFI_STATUS (*discard_blocks)(EFI_HANDLE handle, EFI_BLOCK_IO *bio, EFI_LBA start, EFI_LBA end,
+				     BOOLEAN *zeroed);
+	/* Return TRUE if discarded blocks deterministically read back
+	 * as zero, in which case a discard is as good as an erase.
+	 * Left unset by the back-ends whose erase_blocks performs a
+	 * secure erase. */
+	BOOLEAN (*discard_zeroes)(EFI_HANDLE handle, EFI_BLOCK_IO *bio);
 	EFI_STATUS (*check_logical_unit)(EFI_DEVICE_PATH *p, logical_unit_t log_unit);
 	EFI_STATUS (*get_erase_block_size)(EFI_HANDLE handle, UINTN *erase_blk_size);
 	EFI_STATUS (*set_logical_unit)(UINT64 user_lun,UINT64 factory_lun);
@@ -81,7 +98,10 @@ EFI_HANDLE get_boot_device_handle(void);
 EFI_STATUS get_boot_device_type(enum storage_type *type);
 EFI_STATUS storage_set_boot_device(EFI_HANDLE device);
 EFI_STATUS storage_check_logical_unit(EFI_DEVICE_PATH *p, logical_unit_t log_unit);
-EFI_STATUS storage_erase_blocks(EFI_HANDLE handle, EFI_BLOCK_IO *bio, EFI_LBA start, EFI_LBA end);
+EFI_STATUS storage_erase_blocks(EFI_HANDLE handle, EFI_BLOCK_IO *bio, EFI_LBA start, EFI_LBA end,
+				BOOLEAN *zeroed);
+EFI_STATUS storage_discard_blocks(EFI_HANDLE handle, EFI_BLOCK_IO *bio, EFI_LBA start, EFI_LBA end,
+				  BOOLEAN *zeroed);
 EFI_STATUS storage_get_erase_block_size(UINTN *erase_blk_size);
 EFI_STATUS fill_with(EFI_BLOCK_IO *bio, EFI_LBA start, EFI_LBA end,
 		     VOID *pattern, UINTN pattern_blocks);
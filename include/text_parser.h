@@ -36,7 +36,28 @@
 #include <efi.h>
 #include <efiapi.h>
 
+/* Line parser fed with consecutive fragments of a text.  Each
+ * non-blank line, stripped of its leading and trailing spaces, is
+ * passed NUL terminated to PARSE_LINE.  Only the line being parsed
+ * is copied, the LINE pointer is not valid after PARSE_LINE returns. */
+struct text_parser {
+	EFI_STATUS (*parse_line)(char *line, VOID *ctx);
+	VOID *context;
+	char *line;
+	UINTN len;
+	UINTN size;
+	int lineno;
+};
+
 void skip_whitespace(char **line);
+void text_parser_init(struct text_parser *parser,
+		      EFI_STATUS (*parse_line)(char *line, VOID *ctx),
+		      VOID *context);
+EFI_STATUS text_parser_feed(struct text_parser *parser, const VOID *data, UINTN size);
+/* Parse the last line if it is not newline terminated and release
+ * the parser. */
+EFI_STATUS text_parser_finish(struct text_parser *parser);
+void text_parser_free(struct text_parser *parser);
 EFI_STATUS parse_text_buffer(VOID *data, UINTN size,
 			     EFI_STATUS (*parse_line)(char *line, VOID *ctx),
 			     VOID *context);
@@ -76,6 +76,14 @@ typedef struct ui_font {
 EFI_STATUS ui_font_init(void);
 ui_font_t *ui_font_get_default(void);
 ui_font_t *ui_font_get(char *name);
+void ui_font_draw_glyph(ui_font_t *font, unsigned char c, BOOLEAN bold,
+			EFI_GRAPHICS_OUTPUT_BLT_PIXEL *fg,
+			EFI_GRAPHICS_OUTPUT_BLT_PIXEL *dst, UINTN dst_width);
+EFI_GRAPHICS_OUTPUT_BLT_PIXEL *ui_font_get_glyph(ui_font_t *font, unsigned char c,
+						 BOOLEAN bold,
+						 EFI_GRAPHICS_OUTPUT_BLT_PIXEL *fg,
+						 EFI_GRAPHICS_OUTPUT_BLT_PIXEL *bg);
+void ui_font_free_glyph_cache(void);
 extern ui_font_t ui_fonts[];
 extern UINTN ui_fonts_nb;
 
@@ -97,6 +105,13 @@ typedef struct ui_textarea {
 	UINTN width;
 	UINTN height;
 	EFI_GRAPHICS_OUTPUT_BLT_PIXEL *blt;
+	/* Damage tracking: lines changed and lines scrolled since
+	 * the last ui_textarea_draw() call at (drawn_x, drawn_y). */
+	BOOLEAN *dirty;
+	UINTN scroll;
+	BOOLEAN drawn;
+	UINTN drawn_x;
+	UINTN drawn_y;
 } ui_textarea_t;
 
 ui_textarea_t *ui_textarea_create(UINTN line_nb, UINTN row_nb, ui_font_t *font,
@@ -118,6 +133,7 @@ void ui_textarea_n(ui_textarea_t *textarea, char *str,
 EFI_STATUS ui_textarea_draw_scale(ui_textarea_t *textarea, UINTN x, UINTN *y,
 				  UINTN width, UINTN height);
 EFI_STATUS ui_textarea_draw(ui_textarea_t *textarea, UINTN x, UINTN y);
+void ui_textarea_invalidate(ui_textarea_t *textarea);
 
 /* EFI Scan codes */
 #ifdef USE_POWER_BUTTON
@@ -179,6 +195,8 @@ EFI_STATUS ui_display_texts(const ui_textline_t **texts, UINTN x, UINTN y,
 			    UINTN linesarea, UINTN colsarea);
 EFI_STATUS ui_draw_blt(EFI_GRAPHICS_OUTPUT_BLT_PIXEL *blt, UINTN x, UINTN y,
 		       UINTN width, UINTN height);
+EFI_STATUS ui_move_area(UINTN src_x, UINTN src_y, UINTN x, UINTN y,
+			UINTN width, UINTN height);
 void ui_print(CHAR16 *fmt, ...);
 void ui_info(CHAR16 *fmt, ...);
 void ui_info_n(CHAR16 *fmt, ...);
@@ -189,8 +207,8 @@ void ui_get_scaled_dimension(UINTN orig_width, UINTN orig_heigth,
 			     UINTN max_width, UINTN max_height,
 			     UINTN *width, UINTN *height);
 UINT64 ui_get_blt_size(UINTN width, UINTN height);
-void ui_bilinear_scale(unsigned char *s, unsigned char *d,
-		       int sx, int sy, int dx, int dy,
-		       int depth);
+EFI_STATUS ui_bilinear_scale(EFI_GRAPHICS_OUTPUT_BLT_PIXEL *s,
+			     EFI_GRAPHICS_OUTPUT_BLT_PIXEL *d,
+			     UINTN sx, UINTN sy, UINTN dx, UINTN dy);
 
 #endif  /* _UI_H_ */
@@ -66,6 +66,7 @@
 #endif
 #include "gpt.h"
 #include "protocol.h"
+#include "pci.h"
 #include "uefi_utils.h"
 #include "security_interface.h"
 #include "security_efi.h"
@@ -1235,8 +1236,8 @@ static EFI_STATUS load_image(VOID *bootimage, VOID *vendorbootimage, UINT8 boot_
 	tpm2_end();
 #endif
 
-	debug(L"chainloading boot image, boot state is %s",
-			boot_state_to_string(boot_state));
+	debug(L"chainloading boot image, boot state is %s, avb arena used %ld bytes",
+			boot_state_to_string(boot_state), avb_arena_high_water());
 	ret = android_image_start_buffer(g_parent_image, bootimage, vendorbootimage,
 					boot_target, boot_state, NULL,
 					vb_data,
@@ -1278,6 +1279,55 @@ VOID connect_all_drivers(VOID)
 		FreePool (handles);
 }
 
+/* Connect the drivers of the network and USB controllers only, which
+ * is what the fastboot transports need, rather than every controller
+ * of the platform.  Everything is connected if no such controller is
+ * found.
+ */
+static VOID connect_transport_drivers(VOID)
+{
+	EFI_STATUS ret;
+	EFI_HANDLE *handles;
+	UINTN nb_handle = 0, nb_connected = 0;
+	UINTN index;
+	EFI_PCI_IO *pciio;
+	UINT8 class, subclass;
+
+	ret = uefi_call_wrapper(BS->LocateHandleBuffer, 5, ByProtocol,
+				&PciIoProtocol, NULL, &nb_handle, &handles);
+	if (EFI_ERROR(ret)) {
+		connect_all_drivers();
+		return;
+	}
+
+	for (index = 0; index < nb_handle; index++) {
+		ret = handle_protocol(handles[index], &PciIoProtocol,
+				      (void **)&pciio);
+		if (EFI_ERROR(ret))
+			continue;
+
+		ret = get_pci_class(pciio, &class, &subclass);
+		if (EFI_ERROR(ret))
+			continue;
+
+		if (class != PCI_CLASS_NETWORK &&
+		    (class != PCI_CLASS_SERIAL_BUS || subclass != PCI_SUBCLASS_USB))
+			continue;
+
+		ret = uefi_call_wrapper(BS->ConnectController, 4, handles[index],
+					NULL, NULL, TRUE);
+		if (!EFI_ERROR(ret))
+			nb_connected++;
+	}
+
+	FreePool(handles);
+
+	if (!nb_connected) {
+		debug(L"No transport controller found, connecting all drivers");
+		connect_all_drivers();
+	}
+}
+
 static VOID enter_fastboot_mode(UINT8 boot_state)
 	__attribute__ ((noreturn));
 
@@ -1298,10 +1348,10 @@ static VOID enter_fastboot_mode(UINT8 boot_state)
 		 * driver that is not necessary for boot to achieve better performance,
 		 * while network is necessary for fastboot mode since USB device mode is
 		 * not supported.
-		 * Connect all drivers that have not been connected.
+		 * Connect the network and USB controllers drivers.
 		 *
 		 */
-		connect_all_drivers();
+		connect_transport_drivers();
 	}
 	set_efi_variable(&fastboot_guid, BOOT_STATE_VAR, sizeof(boot_state),
 			&boot_state, FALSE, TRUE);
@@ -1393,10 +1443,10 @@ static void bootloader_recover_mode(UINT8 boot_state)
 		 * driver that is not necessary for boot to achieve better performance,
 		 * while network is necessary for crash mode since USB device mode is
 		 * not supported.
-		 * Connect all drivers that have not been connected.
+		 * Connect the network and USB controllers drivers.
 		 *
 		 */
-		connect_all_drivers();
+		connect_transport_drivers();
 	}
 #ifdef USE_UI
 	target = ux_prompt_user_for_boot_target(NOT_BOOTABLE_CODE);
@@ -1657,6 +1707,9 @@ EFI_STATUS efi_main(EFI_HANDLE image, EFI_SYSTEM_TABLE *sys_table)
 
 	/* AVB check */
 	disable_slot_if_efi_loaded_slot_failed();
+	ret = avb_arena_init();
+	if (EFI_ERROR(ret))
+		efi_perror(ret, L"Failed to reserve the avb arena, using the pool");
 	ret = avb_load_verify_boot_image(boot_target, target_path, &bootimage, oneshot, &boot_state, &vb_data);
 	avb_load_verify_vendor_boot_image(boot_target, &vendorbootimage);
 
@@ -1694,6 +1747,15 @@ EFI_STATUS efi_main(EFI_HANDLE image, EFI_SYSTEM_TABLE *sys_table)
 	if (EFI_ERROR(ret))
 		efi_perror(ret, L"Failed to start boot image");
 
+	/* The verification data and the boot image it holds are not
+	 * used past this point */
+	if (vb_data) {
+		avb_slot_verify_data_free(vb_data);
+		vb_data = NULL;
+		bootimage = NULL;
+	}
+	avb_arena_release();
+
 	switch (boot_target) {
 	case NORMAL_BOOT:
 	case CHARGER:
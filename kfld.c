@@ -41,12 +41,17 @@
 #include "gpt.h"
 #include "android.h"
 #include "slot.h"
+#include "vars.h"
+#include "fatfs.h"
 
 #include "libavb_ab.h"
 
 /* BIOS Capsule update file */
 #define FWUPDATE_FILE             L"\\BIOSUPDATE.fv"
 #define KF_FILE                   L"\\EFI\\INTEL\\KF4UEFI.EFI"
+/* Same file, as seen by the FAT library */
+#define KF_FAT_PATH               L"/EFI/INTEL/KF4UEFI.EFI"
+#define KF_EXTENT_VAR             L"KfExtent_%04x"
 
 #define KFLD_SELF_FILE            L"\\EFI\\INTEL\\KFLD.EFI"
 #define KFLD_UPDATE_FILE          L"\\EFI\\INTEL\\KFLD_NEW.EFI"
@@ -139,6 +144,103 @@ EFI_STATUS get_active_slot(UINT8 *slot)
 	return ret;
 }
 
+/* Remember where KF_FILE of SLOT lies on its partition so that the
+ * next boot can read it without going through the firmware FAT driver.
+ */
+static void save_kf_extent(UINT8 slot, CHAR16 *label)
+{
+	EFI_STATUS ret;
+	fat_extent_t ext;
+	CHAR16 name[32];
+
+	ret = fat_get_file_extent(label, KF_FAT_PATH, &ext);
+	if (EFI_ERROR(ret)) {
+		debug(L"No extent for %s on %s", KF_FILE, label);
+		return;
+	}
+
+	SPrint(name, sizeof(name), KF_EXTENT_VAR, slot);
+	ret = set_efi_variable(&fastboot_guid, name, sizeof(ext), &ext,
+			       TRUE, FALSE);
+	if (EFI_ERROR(ret))
+		efi_perror(ret, L"Failed to save %s", name);
+}
+
+/* Load KF_FILE from the extent recorded by a previous boot with a
+ * single read.  The extent is only trusted if the directory entry and
+ * the FAT chain it was computed from did not change.
+ */
+static EFI_STATUS load_kf_extent(UINT8 slot, CHAR16 *label,
+				 EFI_HANDLE kf_handle, EFI_HANDLE *kf_image)
+{
+	EFI_STATUS ret;
+	struct gpt_partition_interface gpart;
+	fat_extent_t *ext = NULL;
+	EFI_DEVICE_PATH *edp;
+	CHAR16 name[32];
+	UINTN size;
+	UINT32 flags;
+	UINT8 *buf;
+
+	SPrint(name, sizeof(name), KF_EXTENT_VAR, slot);
+	ret = get_efi_variable(&fastboot_guid, name, &size, (VOID **)&ext,
+			       &flags);
+	if (EFI_ERROR(ret))
+		return ret;
+
+	if (size != sizeof(*ext)) {
+		ret = EFI_COMPROMISED_DATA;
+		goto out;
+	}
+
+	ret = gpt_get_partition_by_label(label, &gpart, LOGICAL_UNIT_USER);
+	if (EFI_ERROR(ret))
+		goto out;
+
+	ret = fat_check_file_extent(&gpart, ext);
+	if (EFI_ERROR(ret)) {
+		debug(L"Cached extent of %s is stale", label);
+		goto out;
+	}
+
+	buf = AllocatePool(ext->size);
+	if (!buf) {
+		ret = EFI_OUT_OF_RESOURCES;
+		goto out;
+	}
+
+	ret = uefi_call_wrapper(gpart.dio->ReadDisk, 5, gpart.dio,
+			gpart.bio->Media->MediaId,
+			gpart.part.starting_lba * gpart.bio->Media->BlockSize +
+			ext->data_offset, ext->size, buf);
+	if (EFI_ERROR(ret)) {
+		efi_perror(ret, L"Read %s failed", label);
+		goto free_buf;
+	}
+
+	if (ext->size < 2 || buf[0] != 'M' || buf[1] != 'Z') {
+		ret = EFI_COMPROMISED_DATA;
+		goto free_buf;
+	}
+
+	edp = FileDevicePath(kf_handle, KF_FILE);
+	if (!edp) {
+		ret = EFI_OUT_OF_RESOURCES;
+		goto free_buf;
+	}
+
+	/* The image signature is still checked by LoadImage */
+	ret = uefi_call_wrapper(BS->LoadImage, 6, FALSE, g_parent_image,
+			edp, buf, ext->size, kf_image);
+	FreePool(edp);
+
+free_buf:
+	FreePool(buf);
+out:
+	FreePool(ext);
+	return ret;
+}
+
 EFI_STATUS load_kf(UINT8 slot)
 {
 	EFI_STATUS ret, unload_ret;
@@ -159,6 +261,14 @@ EFI_STATUS load_kf(UINT8 slot)
 		goto out;
 	}
 
+	ret = load_kf_extent(slot, label, kf_handle, &kf_image);
+	if (!EFI_ERROR(ret))
+		goto loaded;
+	if (kf_image != 0) {
+		uefi_call_wrapper(BS->UnloadImage, 1, kf_image);
+		kf_image = 0;
+	}
+
 	ret = handle_protocol(kf_handle, &SimpleFileSystemProtocol,
 			(void **)&io);
 	if (EFI_ERROR(ret)) {
@@ -185,6 +295,9 @@ EFI_STATUS load_kf(UINT8 slot)
 		goto out;
 	}
 
+	save_kf_extent(slot, label);
+
+loaded:
 	if (g_loaded_image->LoadOptionsSize > 0) {
 		ret = uefi_call_wrapper(BS->OpenProtocol, 6, kf_image,
 				&LoadedImageProtocol, (VOID **)&loaded_image,
@@ -12,7 +12,8 @@ LOCAL_STATIC_LIBRARIES := \
 	libkernelflinger-$(TARGET_BUILD_VARIANT)
 
 LOCAL_EXPORT_C_INCLUDE_DIRS := $(LOCAL_PATH)/../include/libadb
-LOCAL_C_INCLUDES := $(LOCAL_PATH)/../include/libadb
+LOCAL_C_INCLUDES := $(LOCAL_PATH)/../include/libadb \
+	$(LOCAL_PATH)/../libkernelflinger
 LOCAL_SRC_FILES := \
 	adb.c \
 	adb_socket.c \
@@ -34,6 +34,7 @@
 #include <slot.h>
 
 #include "acpi.h"
+#include "protocol/DiskIo2.h"
 #ifndef __LP64__
 #include "pae.h"
 #endif
@@ -590,18 +591,100 @@ static EFI_STATUS vmcore_read(reader_ctx_t *ctx, unsigned char **buf, UINT64 *le
 	return memory_read_current(&priv->m, buf, len);
 }
 
-/* Partition reader */
+/* Partition reader
+ *
+ * The partition is read in windows of up to PART_READER_BUF_SIZE bytes
+ * which alternate between two buffers.  When the disk provides the
+ * Disk I/O 2 protocol, the next window is read in the background
+ * while the current one is being sent so that the disk and the link
+ * work at the same time.  Windows end on a multiple of the optimal
+ * transfer length of the device. */
 #define PART_READER_BUF_SIZE (10 * 1024 * 1024)
 
+#ifndef EFI_BLOCK_IO_PROTOCOL_REVISION3
+#define EFI_BLOCK_IO_PROTOCOL_REVISION3 ((2 << 16) | 31)
+#endif
+
+struct part_window {
+	unsigned char *buf;
+	VOID *alloc;
+	UINT64 start;
+	UINTN len;
+	BOOLEAN pending;
+	EFI_DISK_IO2_TOKEN token;
+};
+
 struct part_priv {
 	struct gpt_partition_interface gparti;
-	BOOLEAN need_more_data;
-	unsigned char buf[PART_READER_BUF_SIZE];
+	EFI_DISK_IO2_PROTOCOL *dio2;
+	struct part_window win[2];
+	UINTN cur_win;
 	UINTN buf_cur;
-	UINTN buf_len;
 	UINT64 offset;
+	UINT64 next;
+	UINTN align;
 };
 
+static void part_close(reader_ctx_t *ctx)
+{
+	struct part_priv *priv = ctx->private;
+	struct part_window *w;
+	UINTN i, index;
+
+	for (i = 0; i < ARRAY_SIZE(priv->win); i++) {
+		w = &priv->win[i];
+		/* The buffer cannot be released under an on-going transfer */
+		if (w->pending)
+			uefi_call_wrapper(BS->WaitForEvent, 3, 1, &w->token.Event, &index);
+		if (w->token.Event)
+			uefi_call_wrapper(BS->CloseEvent, 1, w->token.Event);
+		if (w->alloc)
+			FreePool(w->alloc);
+	}
+
+	FreePool(priv);
+}
+
+static EFI_STATUS part_alloc_windows(struct part_priv *priv)
+{
+	EFI_BLOCK_IO_MEDIA *media = priv->gparti.bio->Media;
+	EFI_GUID dio2_guid = EFI_DISK_IO2_PROTOCOL_GUID;
+	struct part_window *w;
+	EFI_STATUS ret;
+	UINTN i;
+
+	priv->align = media->BlockSize;
+	if (priv->gparti.bio->Revision >= EFI_BLOCK_IO_PROTOCOL_REVISION3 &&
+	    media->OptimalTransferLengthGranularity &&
+	    media->OptimalTransferLengthGranularity * media->BlockSize <= PART_READER_BUF_SIZE)
+		priv->align *= media->OptimalTransferLengthGranularity;
+
+	ret = uefi_call_wrapper(BS->HandleProtocol, 3, priv->gparti.handle,
+				&dio2_guid, (VOID **)&priv->dio2);
+	if (EFI_ERROR(ret))
+		priv->dio2 = NULL;
+
+	for (i = 0; i < ARRAY_SIZE(priv->win); i++) {
+		w = &priv->win[i];
+		ret = alloc_aligned(&w->alloc, (VOID **)&w->buf,
+				    PART_READER_BUF_SIZE, media->IoAlign);
+		if (EFI_ERROR(ret))
+			return ret;
+
+		if (!priv->dio2)
+			continue;
+
+		ret = uefi_call_wrapper(BS->CreateEvent, 5, 0, 0, NULL, NULL,
+					&w->token.Event);
+		if (EFI_ERROR(ret)) {
+			efi_perror(ret, L"Failed to create the read-ahead event");
+			return ret;
+		}
+	}
+
+	return EFI_SUCCESS;
+}
+
 static EFI_STATUS _part_open(reader_ctx_t *ctx, UINTN argc, char **argv, logical_unit_t log_unit)
 {
 	EFI_STATUS ret = EFI_SUCCESS;
@@ -613,7 +696,7 @@ static EFI_STATUS _part_open(reader_ctx_t *ctx, UINTN argc, char **argv, logical
 	if (argc < 1 || argc > 3)
 		return EFI_INVALID_PARAMETER;
 
-	priv = ctx->private = AllocatePool(sizeof(*priv));
+	priv = ctx->private = AllocateZeroPool(sizeof(*priv));
 	if (!priv)
 		return EFI_OUT_OF_RESOURCES;
 
@@ -645,20 +728,24 @@ static EFI_STATUS _part_open(reader_ctx_t *ctx, UINTN argc, char **argv, logical
 			goto err;
 	}
 
+	/* ctx->len is where the read ends, LENGTH counts from START */
 	if (argc == 3) {
 		ctx->len = strtoull(argv[2], NULL, 16);
-		if (ctx->len == 0 || ctx->len > length || ctx->cur >= length - ctx->len)
+		if (ctx->len == 0 || ctx->len > length || ctx->cur > length - ctx->len)
 			goto err;
+		ctx->len += ctx->cur;
 	}
 
-	priv->buf_cur = 0;
-	priv->buf_len = 0;
-	priv->need_more_data = TRUE;
+	ret = part_alloc_windows(priv);
+	if (EFI_ERROR(ret))
+		goto err;
+
+	priv->next = ctx->cur;
 
 	return EFI_SUCCESS;
 
 err:
-	FreePool(priv);
+	part_close(ctx);
 	return EFI_ERROR(ret) ? ret : EFI_INVALID_PARAMETER;
 }
 
@@ -672,30 +759,98 @@ static EFI_STATUS factory_part_open(reader_ctx_t *ctx, UINTN argc, char **argv)
 	return _part_open(ctx, argc, argv, LOGICAL_UNIT_FACTORY);
 }
 
+/* Start reading the next window into @w.  The read is asynchronous
+ * if @async is set and the disk supports it. */
+static EFI_STATUS part_fill(reader_ctx_t *ctx, struct part_window *w, BOOLEAN async)
+{
+	struct part_priv *priv = ctx->private;
+	UINT64 abs_start = priv->offset + priv->next;
+	EFI_STATUS ret;
+
+	/* Shorten the window so that the following ones start aligned */
+	w->start = priv->next;
+	w->len = PART_READER_BUF_SIZE - PART_READER_BUF_SIZE % priv->align;
+	w->len -= abs_start % priv->align;
+	w->len = min((UINT64)w->len, ctx->len - priv->next);
+	priv->next += w->len;
+
+	if (async && priv->dio2) {
+		w->token.TransactionStatus = EFI_SUCCESS;
+		ret = uefi_call_wrapper(priv->dio2->ReadDiskEx, 6, priv->dio2,
+					priv->gparti.bio->Media->MediaId,
+					abs_start, &w->token, w->len, w->buf);
+		if (!EFI_ERROR(ret)) {
+			w->pending = TRUE;
+			return EFI_SUCCESS;
+		}
+		efi_perror(ret, L"Read-ahead failed, reading synchronously");
+		priv->dio2 = NULL;
+	}
+
+	ret = uefi_call_wrapper(priv->gparti.dio->ReadDisk, 5, priv->gparti.dio,
+				priv->gparti.bio->Media->MediaId,
+				abs_start, w->len, w->buf);
+	if (EFI_ERROR(ret))
+		efi_perror(ret, L"Failed to read partition");
+
+	return ret;
+}
+
+static EFI_STATUS part_wait(struct part_window *w)
+{
+	EFI_STATUS ret;
+	UINTN index;
+
+	if (!w->pending)
+		return EFI_SUCCESS;
+
+	ret = uefi_call_wrapper(BS->WaitForEvent, 3, 1, &w->token.Event, &index);
+	w->pending = FALSE;
+	if (EFI_ERROR(ret)) {
+		efi_perror(ret, L"Failed to wait for the partition read");
+		return ret;
+	}
+
+	ret = w->token.TransactionStatus;
+	if (EFI_ERROR(ret))
+		efi_perror(ret, L"Failed to read partition");
+
+	return ret;
+}
+
 static EFI_STATUS part_read(reader_ctx_t *ctx, unsigned char **buf, UINT64 *len)
 {
 	EFI_STATUS ret;
 	struct part_priv *priv = ctx->private;
+	struct part_window *w = &priv->win[priv->cur_win];
 
-	if (priv->need_more_data) {
-		priv->buf_len = min(sizeof(priv->buf), ctx->len - ctx->cur);
-		ret = uefi_call_wrapper(priv->gparti.dio->ReadDisk, 5, priv->gparti.dio,
-					priv->gparti.bio->Media->MediaId,
-					priv->offset + ctx->cur, priv->buf_len, priv->buf);
-		if (EFI_ERROR(ret)) {
-			efi_perror(ret, L"Failed to read partition");
+	if (priv->buf_cur == w->len || ctx->cur != w->start + priv->buf_cur) {
+		priv->cur_win ^= 1;
+		w = &priv->win[priv->cur_win];
+
+		ret = part_wait(w);
+		if (EFI_ERROR(ret))
 			return ret;
-		}
 
-		priv->need_more_data = FALSE;
+		/* Nothing prefetched for this position, read it now */
+		if (w->len == 0 || w->start != ctx->cur) {
+			priv->next = ctx->cur;
+			ret = part_fill(ctx, w, FALSE);
+			if (EFI_ERROR(ret))
+				return ret;
+		}
 		priv->buf_cur = 0;
+
+		if (priv->next < ctx->len) {
+			ret = part_fill(ctx, &priv->win[priv->cur_win ^ 1], TRUE);
+			if (EFI_ERROR(ret))
+				return ret;
+		}
 	}
 
-	*len = min(*len, priv->buf_len - priv->buf_cur);
-	*buf = priv->buf + priv->buf_cur;
+	*len = min(*len, w->len - priv->buf_cur);
+	*buf = w->buf + priv->buf_cur;
 	priv->buf_cur += *len;
-	if (priv->buf_cur == priv->buf_len)
-		priv->need_more_data = TRUE;
 
 	return EFI_SUCCESS;
 }
@@ -1009,8 +1164,8 @@ struct reader {
 	{ "ram",		ram_open,			ram_read,		memory_close },
 	{ "vmcore",		vmcore_open,			vmcore_read,		memory_close },
 	{ "acpi",		acpi_open,			read_from_private,	NULL },
-	{ "part",		part_open,			part_read,		free_private },
-	{ "factory-part",	factory_part_open,		part_read,		free_private },
+	{ "part",		part_open,			part_read,		part_close },
+	{ "factory-part",	factory_part_open,		part_read,		part_close },
 	{ "efivar",		efivar_open,			read_from_private,	free_private },
 	{ "mbr",		mbr_open,			read_from_private,	free_private },
 	{ "gpt-header",		gpt_header_open,		read_from_private,	free_private },
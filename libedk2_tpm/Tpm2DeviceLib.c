@@ -29,6 +29,7 @@ Tpm2SubmitCommand (
 {
   EFI_STATUS                Status;
   TPM2_RESPONSE_HEADER      *Header;
+  UINT64                    Start;
 
   EFI_GUID gEfiTcg2ProtocolGuid = EFI_TCG2_PROTOCOL_GUID;
   EFI_TCG2_PROTOCOL *mTcg2Protocol;
@@ -43,6 +44,7 @@ Tpm2SubmitCommand (
   //
   // Assume when Tcg2 Protocol is ready, RequestUseTpm already done.
   //
+  Start = Tpm2LatencyStart ();
   Status = mTcg2Protocol->SubmitCommand (
                             mTcg2Protocol,
                             InputParameterBlockSize,
@@ -50,6 +52,7 @@ Tpm2SubmitCommand (
                             *OutputParameterBlockSize,
                             OutputParameterBlock
                             );
+  Tpm2LatencyRecord (InputParameterBlock, InputParameterBlockSize, Start);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -16,6 +16,7 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include <efilib.h>
 #include "Tpm2Help.h"
 #include "Tcg2Protocol.h"
+#include "timer.h"
 
 typedef struct {
   TPMI_ALG_HASH              HashAlgo;
@@ -332,3 +333,93 @@ CopyAuthSessionCommand (
 
   return (UINT32)(Buffer - (UINT8 *)AuthSessionOut);
 }
+
+STATIC TPM2_COMMAND_LATENCY mLatency[TPM2_LATENCY_MAX_COMMANDS];
+STATIC UINTN                mLatencyCount;
+STATIC UINT32               mCpuFreq;
+
+/**
+  Return the time stamp to pass to Tpm2LatencyRecord() once the
+  command completes.
+**/
+UINT64
+EFIAPI
+Tpm2LatencyStart (
+  VOID
+  )
+{
+  return rdtsc ();
+}
+
+/**
+  Account the time spent since Start to the command code of Command.
+
+  @param[in] Command      TPM2 command byte stream.
+  @param[in] CommandSize  Size of the command.
+  @param[in] Start        Value returned by Tpm2LatencyStart().
+**/
+VOID
+EFIAPI
+Tpm2LatencyRecord (
+  IN UINT8                   *Command,
+  IN UINT32                  CommandSize,
+  IN UINT64                  Start
+  )
+{
+  TPM2_COMMAND_LATENCY       *Entry;
+  UINT32                     CommandCode;
+  UINT32                     Us;
+  UINTN                      Index;
+
+  if (Command == NULL || CommandSize < sizeof (TPM2_COMMAND_HEADER)) {
+    return;
+  }
+
+  if (mCpuFreq == 0) {
+    mCpuFreq = get_cpu_freq ();
+    if (mCpuFreq == 0) {
+      return;
+    }
+  }
+
+  // get_cpu_freq() is in MHz, that is ticks per microsecond
+  Us = (UINT32) DivU64x32 (rdtsc () - Start, mCpuFreq, NULL);
+  CommandCode = SwapBytes32 (ReadUnaligned32 ((UINT32 *) &((TPM2_COMMAND_HEADER *) Command)->commandCode));
+
+  for (Index = 0; Index < mLatencyCount; Index++) {
+    if (mLatency[Index].CommandCode == CommandCode) {
+      break;
+    }
+  }
+  if (Index == mLatencyCount) {
+    if (mLatencyCount == TPM2_LATENCY_MAX_COMMANDS) {
+      return;
+    }
+    mLatencyCount++;
+    mLatency[Index].CommandCode = CommandCode;
+  }
+
+  Entry = &mLatency[Index];
+  Entry->Count++;
+  Entry->TotalUs += Us;
+  if (Us > Entry->MaxUs) {
+    Entry->MaxUs = Us;
+  }
+}
+
+/**
+  Return the latency counters of the commands submitted so far.
+
+  @param[out] Latency  Array of counters, one per command code.
+
+  @return Number of entries of Latency.
+**/
+UINTN
+EFIAPI
+Tpm2GetCommandLatency (
+  OUT CONST TPM2_COMMAND_LATENCY   **Latency
+  )
+{
+  *Latency = mLatency;
+  return mLatencyCount;
+}
@@ -85,13 +85,14 @@ PtpCrbWaitRegisterBits (
 {
   UINT32                            RegRead;
   UINT32                            WaitTime;
+  UINT32                            Delay;
 
-  for (WaitTime = 0; WaitTime < TimeOut; WaitTime += 100) {
+  Delay = 0;
+  for (WaitTime = 0; WaitTime < TimeOut; WaitTime += Tpm2PollDelay (&Delay)) {
     RegRead = MmioRead32 ((UINTN)Register);
     if ((RegRead & BitSet) == BitSet && (RegRead & BitClear) == 0) {
       return EFI_SUCCESS;
     }
-    pause_us(100);
   }
   return EFI_TIMEOUT;
 }
@@ -202,7 +203,10 @@ PtpCrbTpmCommand (
   // first byte of a command to the Command Buffer and the receipt of a write
   // of 1 to Start.
   //
-  for (Index = 0; Index < SizeIn; Index++) {
+  for (Index = 0; Index + sizeof (UINT32) <= SizeIn; Index += sizeof (UINT32)) {
+    MmioWrite32 ((UINTN)&CrbReg->CrbDataBuffer[Index], ReadUnaligned32 ((UINT32 *) (BufferIn + Index)));
+  }
+  for (; Index < SizeIn; Index++) {
     MmioWrite8 ((UINTN)&CrbReg->CrbDataBuffer[Index], BufferIn[Index]);
   }
   MmioWrite32 ((UINTN)&CrbReg->CrbControlCommandAddressHigh, (UINT32)RShiftU64 ((UINTN)CrbReg->CrbDataBuffer, 32));
@@ -239,7 +243,10 @@ PtpCrbTpmCommand (
   //
   // Get response data header
   //
-  for (Index = 0; Index < sizeof (TPM2_RESPONSE_HEADER); Index++) {
+  for (Index = 0; Index + sizeof (UINT32) <= sizeof (TPM2_RESPONSE_HEADER); Index += sizeof (UINT32)) {
+    WriteUnaligned32 ((UINT32 *) (BufferOut + Index), MmioRead32 ((UINTN)&CrbReg->CrbDataBuffer[Index]));
+  }
+  for (; Index < sizeof (TPM2_RESPONSE_HEADER); Index++) {
     BufferOut[Index] = MmioRead8 ((UINTN)&CrbReg->CrbDataBuffer[Index]);
   }
   //
@@ -263,7 +270,13 @@ PtpCrbTpmCommand (
   //
   // Continue reading the remaining data
   //
-  for (Index = sizeof (TPM2_RESPONSE_HEADER); Index < TpmOutSize; Index++) {
+  for (Index = sizeof (TPM2_RESPONSE_HEADER); Index < TpmOutSize && (Index % sizeof (UINT32)); Index++) {
+    BufferOut[Index] = MmioRead8 ((UINTN)&CrbReg->CrbDataBuffer[Index]);
+  }
+  for (; Index + sizeof (UINT32) <= TpmOutSize; Index += sizeof (UINT32)) {
+    WriteUnaligned32 ((UINT32 *) (BufferOut + Index), MmioRead32 ((UINTN)&CrbReg->CrbDataBuffer[Index]));
+  }
+  for (; Index < TpmOutSize; Index++) {
     BufferOut[Index] = MmioRead8 ((UINTN)&CrbReg->CrbDataBuffer[Index]);
   }
 Exit:
@@ -459,29 +472,37 @@ Tpm2SubmitCommand (
   )
 {
   PTP_INTERFACE_TYPE  PtpInterface;
+  EFI_STATUS          Status;
+  UINT64              Start;
 
+  Start = Tpm2LatencyStart ();
   PtpInterface = Tpm2GetPtpInterface ((VOID *) (UINTN) PcdGet64 (PcdTpmBaseAddress));
   switch (PtpInterface) {
   case PtpInterfaceCrb:
-    return PtpCrbTpmCommand (
-             (PTP_CRB_REGISTERS_PTR) (UINTN) PcdGet64 (PcdTpmBaseAddress),
-             InputParameterBlock,
-             InputParameterBlockSize,
-             OutputParameterBlock,
-             OutputParameterBlockSize
-             );
+    Status = PtpCrbTpmCommand (
+               (PTP_CRB_REGISTERS_PTR) (UINTN) PcdGet64 (PcdTpmBaseAddress),
+               InputParameterBlock,
+               InputParameterBlockSize,
+               OutputParameterBlock,
+               OutputParameterBlockSize
+               );
+    break;
   case PtpInterfaceFifo:
   case PtpInterfaceTis:
-    return Tpm2TisTpmCommand (
-             (TIS_PC_REGISTERS_PTR) (UINTN) PcdGet64 (PcdTpmBaseAddress),
-             InputParameterBlock,
-             InputParameterBlockSize,
-             OutputParameterBlock,
-             OutputParameterBlockSize
-             );
+    Status = Tpm2TisTpmCommand (
+               (TIS_PC_REGISTERS_PTR) (UINTN) PcdGet64 (PcdTpmBaseAddress),
+               InputParameterBlock,
+               InputParameterBlockSize,
+               OutputParameterBlock,
+               OutputParameterBlockSize
+               );
+    break;
   default:
     return EFI_NOT_FOUND;
   }
+
+  Tpm2LatencyRecord (InputParameterBlock, InputParameterBlockSize, Start);
+  return Status;
 }
 
 /**
@@ -14,6 +14,7 @@
 #include <PcdLib.h>
 
 #include <IndustryStandard/TpmTis.h>
+#include <IndustryStandard/TpmPtp.h>
 #include "lib.h"
 
 #define TIS_TIMEOUT_MAX             (90000 * 1000)  // 90s
@@ -23,6 +24,35 @@
 //
 #define TPMCMDBUFLENGTH             0x500
 
+//
+// Register polling starts with a short delay which doubles up to
+// TIS_POLL_MAX_US, so that fast TPM operations are not rounded up to
+// a full polling period.
+//
+#define TIS_POLL_MIN_US             1
+#define TIS_POLL_MAX_US             100
+
+/**
+  Wait before polling a TPM register again.
+
+  @param[in, out] Delay  Current polling delay (unit MicroSecond), it is
+                         updated for the next call. Start with 0.
+
+  @return The time waited (unit MicroSecond).
+**/
+UINT32
+Tpm2PollDelay (
+  IN OUT  UINT32                    *Delay
+  )
+{
+  UINT32                            Wait;
+
+  Wait = *Delay ? *Delay : TIS_POLL_MIN_US;
+  pause_us (Wait);
+  *Delay = min (Wait * 2, TIS_POLL_MAX_US);
+  return Wait;
+}
+
 /**
   Check whether TPM chip exist.
 
@@ -63,13 +93,14 @@ TisPcWaitRegisterBits (
 {
   UINT8                             RegRead;
   UINT32                            WaitTime;
+  UINT32                            Delay;
 
-  for (WaitTime = 0; WaitTime < TimeOut; WaitTime += 100) {
+  Delay = 0;
+  for (WaitTime = 0; WaitTime < TimeOut; WaitTime += Tpm2PollDelay (&Delay)) {
     RegRead = MmioRead8 ((UINTN)Register);
     if ((RegRead & BitSet) == BitSet && (RegRead & BitClear) == 0) {
       return EFI_SUCCESS;
     }
-    pause_us(100);
   }
   return EFI_TIMEOUT;
 }
@@ -92,6 +123,7 @@ TisPcReadBurstCount (
   )
 {
   UINT32                            WaitTime;
+  UINT32                            Delay;
   UINT8                             DataByte0;
   UINT8                             DataByte1;
 
@@ -100,6 +132,7 @@ TisPcReadBurstCount (
   }
 
   WaitTime = 0;
+  Delay = 0;
   do {
     //
     // TIS_PC_REGISTERS_PTR->burstCount is UINT16, but it is not 2bytes aligned,
@@ -111,13 +144,112 @@ TisPcReadBurstCount (
     if (*BurstCount != 0) {
       return EFI_SUCCESS;
     }
-    pause_us(100);
-    WaitTime += 100;
+    WaitTime += Tpm2PollDelay (&Delay);
   } while (WaitTime < TIS_TIMEOUT_D);
 
   return EFI_TIMEOUT;
 }
 
+/**
+  Return the widest access supported by the data FIFO. TIS 1.3 and PTP
+  FIFO interfaces which report a data transfer size larger than one
+  byte accept 32-bit accesses of DataFifo.
+
+  @param[in] TisReg  Pointer to TIS register.
+
+  @return 4 or 1.
+**/
+STATIC
+UINT32
+TisPcFifoWidth (
+  IN      TIS_PC_REGISTERS_PTR      TisReg
+  )
+{
+  PTP_FIFO_INTERFACE_CAPABILITY     Capability;
+
+  Capability.Uint32 = MmioRead32 ((UINTN)&TisReg->IntfCapability);
+  if (Capability.Uint32 == (UINT32) - 1 ||
+      Capability.Bits.InterfaceVersion == INTERFACE_CAPABILITY_INTERFACE_VERSION_TIS_12 ||
+      Capability.Bits.DataTransferSizeSupport == 0) {
+    return 1;
+  }
+  return sizeof (UINT32);
+}
+
+/**
+  Write up to BurstCount bytes of Buffer to the data FIFO.
+
+  @param[in] TisReg      Pointer to TIS register.
+  @param[in] Width       Widest FIFO access supported.
+  @param[in] Buffer      Data to write.
+  @param[in] Size        Size of the data.
+  @param[in] BurstCount  Number of bytes the TPM accepts.
+
+  @return Number of bytes written.
+**/
+STATIC
+UINT32
+TisPcWriteFifo (
+  IN      TIS_PC_REGISTERS_PTR      TisReg,
+  IN      UINT32                    Width,
+  IN      UINT8                     *Buffer,
+  IN      UINT32                    Size,
+  IN      UINT16                    BurstCount
+  )
+{
+  UINT32                            Index;
+  UINT32                            Count;
+
+  Count = min (Size, (UINT32) BurstCount);
+  Index = 0;
+  if (Width == sizeof (UINT32)) {
+    for (; Index + sizeof (UINT32) <= Count; Index += sizeof (UINT32)) {
+      MmioWrite32 ((UINTN)&TisReg->DataFifo, ReadUnaligned32 ((UINT32 *) (Buffer + Index)));
+    }
+  }
+  for (; Index < Count; Index++) {
+    MmioWrite8 ((UINTN)&TisReg->DataFifo, Buffer[Index]);
+  }
+  return Count;
+}
+
+/**
+  Read up to BurstCount bytes from the data FIFO to Buffer.
+
+  @param[in]  TisReg      Pointer to TIS register.
+  @param[in]  Width       Widest FIFO access supported.
+  @param[out] Buffer      Buffer to store the data.
+  @param[in]  Size        Number of bytes wanted.
+  @param[in]  BurstCount  Number of bytes available.
+
+  @return Number of bytes read.
+**/
+STATIC
+UINT32
+TisPcReadFifo (
+  IN      TIS_PC_REGISTERS_PTR      TisReg,
+  IN      UINT32                    Width,
+  OUT     UINT8                     *Buffer,
+  IN      UINT32                    Size,
+  IN      UINT16                    BurstCount
+  )
+{
+  UINT32                            Index;
+  UINT32                            Count;
+
+  Count = min (Size, (UINT32) BurstCount);
+  Index = 0;
+  if (Width == sizeof (UINT32)) {
+    for (; Index + sizeof (UINT32) <= Count; Index += sizeof (UINT32)) {
+      WriteUnaligned32 ((UINT32 *) (Buffer + Index), MmioRead32 ((UINTN)&TisReg->DataFifo));
+    }
+  }
+  for (; Index < Count; Index++) {
+    Buffer[Index] = MmioRead8 ((UINTN)&TisReg->DataFifo);
+  }
+  return Count;
+}
+
 /**
   Set TPM chip to ready state by sending ready command TIS_PC_STS_READY
   to Status Register in time.
@@ -215,8 +347,11 @@ Tpm2TisTpmCommand (
   UINT32                            TpmOutSize;
   UINT16                            Data16;
   UINT32                            Data32;
+  UINT32                            Width;
+  UINT32                            Count;
 
   TpmOutSize = 0;
+  Width = TisPcFifoWidth (TisReg);
 
   Status = TisPcPrepareCommand (TisReg);
   if (EFI_ERROR (Status)) {
@@ -233,10 +368,7 @@ Tpm2TisTpmCommand (
       Status = EFI_DEVICE_ERROR;
       goto Exit;
     }
-    for (; BurstCount > 0 && Index < SizeIn; BurstCount--) {
-      MmioWrite8 ((UINTN)&TisReg->DataFifo, * (BufferIn + Index));
-      Index++;
-    }
+    Index += TisPcWriteFifo (TisReg, Width, BufferIn + Index, SizeIn - Index, BurstCount);
   }
   //
   // Check the Tpm status STS_EXPECT change from 1 to 0
@@ -282,13 +414,10 @@ Tpm2TisTpmCommand (
       Status = EFI_DEVICE_ERROR;
       goto Exit;
     }
-    for (; BurstCount > 0; BurstCount--) {
-      * (BufferOut + Index) = MmioRead8 ((UINTN)&TisReg->DataFifo);
-      Index++;
-      if (Index == sizeof (TPM2_RESPONSE_HEADER)) {
-        break;
-      }
-    }
+    Count = TisPcReadFifo (TisReg, Width, BufferOut + Index,
+              sizeof (TPM2_RESPONSE_HEADER) - Index, BurstCount);
+    BurstCount = (UINT16) (BurstCount - Count);
+    Index += Count;
   }
   //
   // Check the reponse data header (tag,parasize and returncode )
@@ -312,20 +441,18 @@ Tpm2TisTpmCommand (
   // Continue reading the remaining data
   //
   while ( Index < TpmOutSize ) {
-    for (; BurstCount > 0; BurstCount--) {
-      * (BufferOut + Index) = MmioRead8 ((UINTN)&TisReg->DataFifo);
-      Index++;
-      if (Index == TpmOutSize) {
-        Status = EFI_SUCCESS;
+    if (BurstCount == 0) {
+      Status = TisPcReadBurstCount (TisReg, &BurstCount);
+      if (EFI_ERROR (Status)) {
+        Status = EFI_DEVICE_ERROR;
         goto Exit;
       }
     }
-    Status = TisPcReadBurstCount (TisReg, &BurstCount);
-    if (EFI_ERROR (Status)) {
-      Status = EFI_DEVICE_ERROR;
-      goto Exit;
-    }
+    Count = TisPcReadFifo (TisReg, Width, BufferOut + Index, TpmOutSize - Index, BurstCount);
+    BurstCount = (UINT16) (BurstCount - Count);
+    Index += Count;
   }
+  Status = EFI_SUCCESS;
 Exit:
   MmioWrite8 ((UINTN)&TisReg->Status, TIS_PC_STS_READY);
   return Status;
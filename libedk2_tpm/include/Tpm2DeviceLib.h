@@ -108,4 +108,67 @@ Tpm2RegisterTpm2DeviceLib (
   IN TPM2_DEVICE_INTERFACE   *Tpm2Device
   );
 
+//
+// Number of distinct command codes with latency counters
+//
+#define TPM2_LATENCY_MAX_COMMANDS  16
+
+typedef struct {
+  UINT32                             CommandCode;
+  UINT32                             Count;
+  UINT32                             MaxUs;
+  UINT64                             TotalUs;
+} TPM2_COMMAND_LATENCY;
+
+/**
+  Return the time stamp to pass to Tpm2LatencyRecord() once the
+  command completes.
+**/
+UINT64
+EFIAPI
+Tpm2LatencyStart (
+  VOID
+  );
+
+/**
+  Account the time spent since Start to the command code of Command.
+
+  @param[in] Command      TPM2 command byte stream.
+  @param[in] CommandSize  Size of the command.
+  @param[in] Start        Value returned by Tpm2LatencyStart().
+**/
+VOID
+EFIAPI
+Tpm2LatencyRecord (
+  IN UINT8                   *Command,
+  IN UINT32                  CommandSize,
+  IN UINT64                  Start
+  );
+
+/**
+  Return the latency counters of the commands submitted so far.
+
+  @param[out] Latency  Array of counters, one per command code.
+
+  @return Number of entries of Latency.
+**/
+UINTN
+EFIAPI
+Tpm2GetCommandLatency (
+  OUT CONST TPM2_COMMAND_LATENCY   **Latency
+  );
+
+/**
+  Wait before polling a TPM register again.
+
+  @param[in, out] Delay  Current polling delay (unit MicroSecond), it is
+                         updated for the next call. Start with 0.
+
+  @return The time waited (unit MicroSecond).
+**/
+UINT32
+Tpm2PollDelay (
+  IN OUT  UINT32                    *Delay
+  );
+
 #endif
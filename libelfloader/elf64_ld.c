@@ -46,11 +46,19 @@ elf64_get_segment_info(const elf64_ehdr_t *ehdr,
 	}
 	return FALSE;
 }
+
+/* Relocation targets are spread over the whole image, fetch them a few
+ * entries ahead so that the stores do not wait on memory. */
+#define RELA_PREFETCH_DISTANCE 8
+
 /* prototypes of the real elf parsing functions */
 static BOOLEAN
-elf64_update_rela_section(uint16_t e_type, uint64_t relocation_offset, elf64_dyn_t *dyn_section, uint64_t dyn_section_sz)
+elf64_update_rela_section(module_file_info_t *file_info, uint16_t e_type, uint64_t relocation_offset,
+			  elf64_dyn_t *dyn_section, uint64_t dyn_section_sz)
 {
 	elf64_rela_t *rela = NULL;
+	elf64_rela_t *rela_end;
+	elf64_rela_t *r;
 	uint64_t rela_sz = 0;
 	uint64_t rela_entsz = 0;
 	elf64_sym_t *symtab = NULL;
@@ -102,27 +110,43 @@ elf64_update_rela_section(uint16_t e_type, uint64_t relocation_offset, elf64_dyn
 		}
 	}
 
-	for (i = 0; i < rela_sz / rela_entsz; ++i) {
-		uint64_t *target_addr =
-			(uint64_t *)(UINTN)(uint64_t)(rela[i].r_offset +
-						 relocation_offset);
+	if (!image_contains(file_info, (uint64_t)(UINTN)rela, rela_sz)) {
+		local_print(L"relocation table is outside of the image\n");
+		return FALSE;
+	}
+
+	rela_end = rela + rela_sz / rela_entsz;
+	for (r = rela; r < rela_end; ++r) {
+		uint64_t target = r->r_offset + relocation_offset;
+		uint64_t *target_addr = (uint64_t *)(UINTN)target;
 		uint32_t symtab_idx;
 
-		switch (rela[i].r_info & 0xFF) {
+		if (r + RELA_PREFETCH_DISTANCE < rela_end) {
+			__builtin_prefetch((void *)(UINTN)(r[RELA_PREFETCH_DISTANCE].r_offset +
+							   relocation_offset), 1);
+		}
+
+		if ((r->r_info & 0xFF) != 0 &&
+			!image_contains(file_info, target, sizeof(*target_addr))) {
+			local_print(L"relocation target %#p is outside of the image\n", target);
+			return FALSE;
+		}
+
+		switch (r->r_info & 0xFF) {
 		/* Formula for R_x86_64_32 and R_X86_64_64 are same: S + A  */
 		case R_X86_64_32:
 		case R_X86_64_64:
-			*target_addr = rela[i].r_addend + relocation_offset;
-			symtab_idx = (uint32_t)(rela[i].r_info >> 32);
+			*target_addr = r->r_addend + relocation_offset;
+			symtab_idx = (uint32_t)(r->r_info >> 32);
 			*target_addr += symtab[symtab_idx].st_value;
 			break;
 		case R_X86_64_RELATIVE:
-			*target_addr = rela[i].r_addend + relocation_offset;
+			*target_addr = r->r_addend + relocation_offset;
 			break;
 		case 0:        /* do nothing */
 			break;
 		default:
-			local_print(L"Unsupported Relocation %#x\n", rela[i].r_info & 0xFF);
+			local_print(L"Unsupported Relocation %#x\n", r->r_info & 0xFF);
 			return FALSE;
 		}
 	}
@@ -203,6 +227,14 @@ elf64_load_executable(module_file_info_t *file_info, uint64_t *p_entry)
 			continue;
 		}
 
+		/* reject a truncated image before anything is written to the
+		 * runtime memory */
+		filesz = min(phdr->p_filesz, memsz);
+		if (filesz && !image_offset(file_info, phdr->p_offset, filesz)) {
+			local_print(L"segment %d is outside of the file\n", i);
+			return FALSE;
+		}
+
 		if (addr < low_addr) {
 			low_addr = addr;
 		}
@@ -261,9 +293,11 @@ elf64_load_executable(module_file_info_t *file_info, uint64_t *p_entry)
 
 		if (filesz < memsz) {
 			/* zero BSS if exists */
-			memset_s((void *)(UINTN)(uint64_t)(addr + filesz +
-						    relocation_offset), (uint64_t)(memsz - filesz), 0,
-				(uint64_t)(memsz - filesz));
+			if (!image_zero((void *)(UINTN)(uint64_t)(addr + filesz + relocation_offset),
+					file_info, (uint64_t)(memsz - filesz))) {
+				local_print(L"failed to zero segment BSS\n");
+				return FALSE;
+			}
 		}
 	}
 
@@ -285,7 +319,8 @@ elf64_load_executable(module_file_info_t *file_info, uint64_t *p_entry)
 	if (NULL != phdr_dyn) {
 		dyn_section = (elf64_dyn_t *)(UINTN)image_offset
 			(file_info, (uint64_t)phdr_dyn->p_offset, (uint64_t)phdr_dyn->p_filesz);
-		if (!elf64_update_rela_section(ehdr->e_type, relocation_offset, dyn_section, phdr_dyn->p_filesz))
+		if (!elf64_update_rela_section(file_info, ehdr->e_type, relocation_offset,
+					       dyn_section, phdr_dyn->p_filesz))
 			return FALSE;
 	}
 
@@ -34,6 +34,17 @@ void *image_offset(module_file_info_t *file_info,
 	return (void *)(UINTN)(file_info->loadtime_addr+ src_offset);
 }
 
+BOOLEAN image_contains(module_file_info_t *file_info,
+				uint64_t addr, uint64_t size)
+{
+	if ((addr < file_info->runtime_addr) || (addr + size < addr)) {
+		return FALSE;
+	}
+
+	return (addr + size) <=
+		(file_info->runtime_addr + file_info->runtime_image_size);
+}
+
 BOOLEAN image_copy(void *dest, module_file_info_t *file_info,
 				uint64_t src_offset, uint64_t bytes_to_copy)
 {
@@ -43,9 +54,7 @@ BOOLEAN image_copy(void *dest, module_file_info_t *file_info,
 	if (!src) {
 		return FALSE;
 	}
-	if (((uint64_t)(UINTN)dest < file_info->runtime_addr) ||
-		(((uint64_t)(UINTN)dest + bytes_to_copy) >
-		 (file_info->runtime_addr + file_info->runtime_image_size))) {
+	if (!image_contains(file_info, (uint64_t)(UINTN)dest, bytes_to_copy)) {
 		return FALSE;
 	}
 
@@ -53,6 +62,17 @@ BOOLEAN image_copy(void *dest, module_file_info_t *file_info,
 	return (ret == EFI_SUCCESS) ? (TRUE) : (FALSE);
 }
 
+BOOLEAN image_zero(void *dest, module_file_info_t *file_info,
+				uint64_t bytes_to_zero)
+{
+	if (!image_contains(file_info, (uint64_t)(UINTN)dest, bytes_to_zero)) {
+		return FALSE;
+	}
+
+	memset_s(dest, bytes_to_zero, 0, bytes_to_zero);
+	return TRUE;
+}
+
 /*------------------------- Exported Interface --------------------------*/
 
 /*----------------------------------------------------------------------
@@ -229,7 +229,9 @@ typedef struct {
 	uint64_t runtime_total_size;
 } module_file_info_t;
 
+BOOLEAN image_contains(module_file_info_t *file_info, uint64_t addr, uint64_t size);
 BOOLEAN image_copy(void * dest, module_file_info_t *file_info, uint64_t src_offset, uint64_t byte_to_read);
+BOOLEAN image_zero(void * dest, module_file_info_t *file_info, uint64_t byte_to_zero);
 void *image_offset(module_file_info_t *file_info, uint64_t src_offset, uint64_t byte_to_read);
 
 #endif    /* _ELF_LD_H_ */
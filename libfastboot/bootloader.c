@@ -208,7 +208,7 @@ static EFI_STATUS flash_efi_partition(CHAR16 *label, CHAR16 *tmp_part,
 	if (EFI_ERROR(ret))
 		return ret;
 
-	ret = gpt_refresh();
+	ret = gpt_refresh_partition(tmp_part, LOGICAL_UNIT_USER);
 	if (EFI_ERROR(ret))
 		return ret;
 
@@ -737,6 +737,8 @@ void fastboot_fail(const char *fmt, ...)
 {
 	va_list ap;
 
+	slot_commit();
+
 	va_start(ap, fmt);
 	if (fastboot_state == STATE_TX)
 		fastboot_ack_buffered("FAIL", fmt, ap);
@@ -748,6 +750,15 @@ void fastboot_fail(const char *fmt, ...)
 void fastboot_okay(const char *fmt, ...)
 {
 	va_list ap;
+	EFI_STATUS ret;
+
+	/* Slot changes made by the command are on disk before it is
+	 * acknowledged */
+	ret = slot_commit();
+	if (EFI_ERROR(ret)) {
+		fastboot_fail("Failed to write A/B metadata, %r", ret);
+		return;
+	}
 
 	va_start(ap, fmt);
 	if (fastboot_state == STATE_TX)
@@ -41,6 +41,7 @@
 #include "intel_variables.h"
 #include "android.h"
 #include "tpm2_security.h"
+#include "digest_cache.h"
 
 static cmdlist_t cmdlist;
 
@@ -145,6 +146,15 @@ EFI_STATUS change_device_state(enum device_state new_state, BOOLEAN interactive)
 		return ret;
 	}
 
+	/* Digests verified while unlocked must not survive a lock
+	 * cycle. */
+	ret = digest_cache_invalidate();
+	if (EFI_ERROR(ret)) {
+		if (interactive)
+			fastboot_fail("Failed to reset the digest cache");
+		return ret;
+	}
+
 #ifdef USE_UI
 	fastboot_ui_refresh();
 #endif
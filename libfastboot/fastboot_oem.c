@@ -58,9 +58,11 @@
 #include "vars.h"
 #include "security_interface.h"
 #include "fatfs.h"
+#include "digest_cache.h"
 #define OFF_MODE_CHARGE		"off-mode-charge"
 #define CRASH_EVENT_MENU	"crash-event-menu"
 #define SLOT_FALLBACK		"slot-fallback"
+#define VB_DIGEST_CACHE		"vb-digest-cache"
 
 static cmdlist_t cmdlist;
 #ifdef USE_TPM
@@ -75,6 +77,10 @@ static EFI_STATUS fastboot_oem_publish(void)
 	if (EFI_ERROR(ret))
 		return ret;
 
+	ret = fastboot_publish(FLASH_VERIFY_VAR, flash_get_verify() ? "1" : "0");
+	if (EFI_ERROR(ret))
+		return ret;
+
 	return publish_intel_variables();
 }
 
@@ -96,7 +102,7 @@ static EFI_STATUS cmd_oem_set_boolean(INTN argc, CHAR8 **argv,
 
 	ret = set_fun(!strcmp(argv[1], (CHAR8 *)"1"));
 	if (EFI_ERROR(ret))
-		fastboot_fail("Failed to set %a", OFF_MODE_CHARGE);
+		fastboot_fail("Failed to set %a", name);
 
 	return ret;
 }
@@ -328,6 +334,17 @@ static void cmd_oem_gethashes(INTN argc, CHAR8 **argv)
 	fastboot_okay("");
 }
 
+static void cmd_oem_flash_verify(INTN argc, CHAR8 **argv)
+{
+	EFI_STATUS ret;
+
+	ret = cmd_oem_set_boolean(argc, argv, FLASH_VERIFY_VAR, flash_set_verify);
+	if (EFI_ERROR(ret))
+		return;
+
+	fastboot_okay("");
+}
+
 static void cmd_oem_set_storage(INTN argc, CHAR8 **argv)
 {
 	EFI_STATUS ret;
@@ -563,6 +580,24 @@ static void cmd_oem_disable_slot_fallback(INTN argc, CHAR8 **argv)
 	fastboot_okay("");
 }
 
+static void cmd_oem_vb_digest_cache(INTN argc, CHAR8 **argv)
+{
+	EFI_STATUS ret;
+
+	ret = cmd_oem_set_boolean(argc, argv, VB_DIGEST_CACHE, set_vb_digest_cache);
+	if (EFI_ERROR(ret))
+		return;
+
+	/* Start from an empty cache each time it is toggled. */
+	ret = digest_cache_invalidate();
+	if (EFI_ERROR(ret)) {
+		fastboot_fail("Failed to reset the digest cache, %r", ret);
+		return;
+	}
+
+	fastboot_okay("");
+}
+
 static void cmd_oem_erase_efivars(__attribute__((__unused__)) INTN argc,
 				  __attribute__((__unused__)) CHAR8 **argv)
 {
@@ -808,9 +843,11 @@ static struct fastboot_cmd COMMANDS[] = {
 	{ "rm",				LOCKED,		cmd_oem_rm },
 	{ "set-watchdog-counter-max",	LOCKED,		cmd_oem_set_watchdog_counter_max },
 	{ SLOT_FALLBACK,		LOCKED,		cmd_oem_disable_slot_fallback },
+	{ VB_DIGEST_CACHE,		LOCKED,		cmd_oem_vb_digest_cache },
 	{ "erase-efivars",		LOCKED,		cmd_oem_erase_efivars },
 #endif
 	{ "get-hashes",			LOCKED,		cmd_oem_gethashes  },
+	{ FLASH_VERIFY_VAR,		LOCKED,		cmd_oem_flash_verify },
 	{ "get-provisioning-logs",	LOCKED,		cmd_oem_get_logs },
 	{ "setvm",			LOCKED,		cmd_oem_set_vm },
 	{ "unsetvm",			LOCKED,		cmd_oem_unset_vm },
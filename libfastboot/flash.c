@@ -58,6 +58,8 @@
 #endif
 #include "fatfs.h"
 #include "embedded_controller.h"
+#include "hashes.h"
+#include "digest_cache.h"
 extern uint64_t vm_offset;
 static struct gpt_partition_interface gparti;
 static struct gpt_partition_interface vm_gparti;
@@ -73,6 +75,187 @@ BOOLEAN new_install_device = FALSE;
 #define is_inside_partition(off, sz) \
 		(off >= part_start && off + sz <= part_end)
 
+/* Read-back verification of the flashed data.  The data is written
+ * in VERIFY_CHUNK_SIZE pieces and each piece is read back and
+ * compared by digest once the following piece has been written.
+ * Verification is therefore interleaved with the write stream
+ * instead of requiring a second pass over the whole partition.
+ */
+#define VERIFY_CHUNK_SIZE (4 * 1024 * 1024)
+#define VERIFY_FAILED "failed"
+
+static BOOLEAN verify_enabled;
+static struct flash_verify {
+	BOOLEAN active;
+	const EVP_MD *md;
+	EVP_MD_CTX partition_ctx;
+	VOID *buf;
+	UINT64 pending_offset;
+	UINTN pending_size;
+	UINT8 pending_hash[EVP_MAX_MD_SIZE];
+} verify;
+
+EFI_STATUS flash_set_verify(BOOLEAN enable)
+{
+	verify_enabled = enable;
+	return fastboot_publish(FLASH_VERIFY_VAR, enable ? "1" : "0");
+}
+
+BOOLEAN flash_get_verify(void)
+{
+	return verify_enabled;
+}
+
+static void verify_hash(VOID *data, UINTN size, UINT8 *hash)
+{
+	EVP_MD_CTX mdctx;
+
+	EVP_MD_CTX_init(&mdctx);
+	EVP_DigestInit_ex(&mdctx, verify.md, NULL);
+	EVP_DigestUpdate(&mdctx, data, size);
+	EVP_DigestFinal_ex(&mdctx, hash, NULL);
+	EVP_MD_CTX_cleanup(&mdctx);
+}
+
+/* Set the flash-digest:LABEL variable to VALUE. */
+static EFI_STATUS verify_publish(CHAR16 *label, const char *value)
+{
+	char var[128];
+	int len;
+
+	len = efi_snprintf((CHAR8 *)var, sizeof(var), (CHAR8 *)"%a:%s",
+			   FLASH_DIGEST_VAR, label);
+	if (len < 0 || len >= (int)sizeof(var))
+		return EFI_INVALID_PARAMETER;
+
+	return fastboot_publish(var, value);
+}
+
+/* The digest of a previous flash of LABEL is replaced by
+ * VERIFY_FAILED until the new data has been verified. */
+static EFI_STATUS verify_start(CHAR16 *label)
+{
+	EFI_STATUS ret;
+
+	if (!verify_enabled)
+		return EFI_SUCCESS;
+
+	ret = verify_publish(label, VERIFY_FAILED);
+	if (EFI_ERROR(ret))
+		return ret;
+
+	verify.buf = AllocatePool(VERIFY_CHUNK_SIZE);
+	if (!verify.buf) {
+		error(L"Failed to allocate the read-back buffer");
+		return EFI_OUT_OF_RESOURCES;
+	}
+
+	verify.md = get_hash_algorithm();
+	EVP_MD_CTX_init(&verify.partition_ctx);
+	EVP_DigestInit_ex(&verify.partition_ctx, verify.md, NULL);
+	verify.pending_size = 0;
+	verify.active = TRUE;
+
+	return EFI_SUCCESS;
+}
+
+static void verify_stop(void)
+{
+	if (!verify.active)
+		return;
+
+	EVP_MD_CTX_cleanup(&verify.partition_ctx);
+	FreePool(verify.buf);
+	verify.buf = NULL;
+	verify.active = FALSE;
+}
+
+static EFI_STATUS verify_pending(void)
+{
+	EFI_STATUS ret;
+	UINT8 hash[EVP_MAX_MD_SIZE];
+
+	if (!verify.pending_size)
+		return EFI_SUCCESS;
+
+	ret = uefi_call_wrapper(p_gparti->dio->ReadDisk, 5, p_gparti->dio,
+				p_gparti->bio->Media->MediaId,
+				vm_offset + verify.pending_offset,
+				verify.pending_size, verify.buf);
+	if (EFI_ERROR(ret)) {
+		efi_perror(ret, L"Failed to read back bytes");
+		return ret;
+	}
+
+	verify_hash(verify.buf, verify.pending_size, hash);
+	verify.pending_size = 0;
+	if (memcmp(hash, verify.pending_hash, EVP_MD_size(verify.md))) {
+		error(L"Read-back verification failed at offset %ld", verify.pending_offset);
+		return EFI_CRC_ERROR;
+	}
+
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS verify_write(VOID *data, UINTN size)
+{
+	EFI_STATUS ret;
+	UINT8 hash[EVP_MAX_MD_SIZE];
+	UINTN piece;
+
+	for (; size; size -= piece, data += piece) {
+		piece = min(size, (UINTN)VERIFY_CHUNK_SIZE);
+
+		EVP_DigestUpdate(&verify.partition_ctx, data, piece);
+		verify_hash(data, piece, hash);
+
+		ret = uefi_call_wrapper(p_gparti->dio->WriteDisk, 5, p_gparti->dio,
+					p_gparti->bio->Media->MediaId,
+					vm_offset + cur_offset, piece, data);
+		if (EFI_ERROR(ret)) {
+			efi_perror(ret, L"Failed to write bytes");
+			return ret;
+		}
+
+		ret = verify_pending();
+		if (EFI_ERROR(ret))
+			return ret;
+
+		ret = memcpy_s(verify.pending_hash, sizeof(verify.pending_hash),
+			       hash, EVP_MD_size(verify.md));
+		if (EFI_ERROR(ret))
+			return ret;
+		verify.pending_offset = cur_offset;
+		verify.pending_size = piece;
+
+		cur_offset += piece;
+	}
+
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS verify_finish(CHAR16 *label)
+{
+	EFI_STATUS ret;
+	UINT8 hash[EVP_MAX_MD_SIZE];
+	CHAR8 hashstr[EVP_MAX_MD_SIZE * 2 + 1];
+
+	if (!verify.active)
+		return EFI_SUCCESS;
+
+	ret = verify_pending();
+	if (EFI_ERROR(ret))
+		return ret;
+
+	EVP_DigestFinal_ex(&verify.partition_ctx, hash, NULL);
+	ret = bytes_to_hex_stra(hash, EVP_MD_size(verify.md), hashstr, sizeof(hashstr));
+	if (EFI_ERROR(ret))
+		return ret;
+
+	debug(L"%s read-back verified, digest %a", label, hashstr);
+	return verify_publish(label, (char *)hashstr);
+}
+
 EFI_STATUS flash_skip(UINT64 size)
 {
 	if (!is_inside_partition(cur_offset, size)) {
@@ -96,6 +279,10 @@ EFI_STATUS flash_write(VOID *data, UINTN size)
 				part_start, part_end, cur_offset, cur_offset + size);
 		return EFI_INVALID_PARAMETER;
 	}
+
+	if (verify.active)
+		return verify_write(data, size);
+
 	ret = uefi_call_wrapper(p_gparti->dio->WriteDisk, 5, p_gparti->dio, p_gparti->bio->Media->MediaId, vm_offset + cur_offset, size, data);
 	if (EFI_ERROR(ret)) {
 		efi_perror(ret, L"Failed to write bytes");
@@ -461,16 +648,24 @@ EFI_STATUS flash_partition(VOID *data, UINTN size, CHAR16 *label)
 
 	cur_offset = p_gparti->part.starting_lba * p_gparti->bio->Media->BlockSize;
 
+	ret = verify_start(label);
+	if (EFI_ERROR(ret))
+		return ret;
+
 	if (is_sparse_image(data, size))
 		ret = flash_sparse(data, size);
 	else
 		ret = flash_write(data, size);
 
+	if (!EFI_ERROR(ret))
+		ret = verify_finish(label);
+	verify_stop();
+
 	if (EFI_ERROR(ret))
 		return ret;
 
 	if (!CompareGuid(&p_gparti->part.type, &EfiPartTypeSystemPartitionGuid)) {
-		ret = gpt_refresh();
+		ret = gpt_refresh_partition(label, LOGICAL_UNIT_USER);
 		if (EFI_ERROR(ret))
 			return ret;
 	}
@@ -510,9 +705,15 @@ static struct label_exception {
 
 EFI_STATUS flash(VOID *data, UINTN size, CHAR16 *label)
 {
+	EFI_STATUS ret;
 	UINTN i;
 	CHAR16 *full_label;
 
+	/* any write may change a partition verified by a previous boot */
+	ret = digest_cache_invalidate();
+	if (EFI_ERROR(ret))
+		return ret;
+
 #ifndef USER
 	/* special case for writing inside esp partition */
 	CHAR16 esp[] = L"/ESP/";
@@ -572,9 +773,13 @@ static EFI_STATUS erase_blocks(EFI_HANDLE handle, EFI_BLOCK_IO *bio, EFI_LBA sta
 {
 	EFI_STATUS ret;
 	EFI_LBA min_end;
+	BOOLEAN zeroed;
 
-	ret = storage_erase_blocks(handle, bio, start, end);
+	ret = storage_erase_blocks(handle, bio, start, end, &zeroed);
 	if (ret == EFI_SUCCESS) {
+		if (zeroed)
+			return EFI_SUCCESS;
+
 		/* If the Android fs_mgr fails mounting a partition,
 		   it tries to detect if the partition has been wiped
 		   out to determine if it has to format it.  fs_mgr
@@ -596,6 +801,7 @@ static EFI_STATUS fast_erase_part(const CHAR16 *label)
 {
 	EFI_STATUS ret;
 	EFI_LBA start, end, min_end;
+	BOOLEAN zeroed = FALSE;
 
 	ret = gpt_get_partition_by_label(label, p_gparti, LOGICAL_UNIT_USER);
 	if (EFI_ERROR(ret)) {
@@ -607,14 +813,24 @@ static EFI_STATUS fast_erase_part(const CHAR16 *label)
 	end = p_gparti->part.ending_lba;
 	min_end = start + (FS_MGR_SIZE / p_gparti->bio->Media->BlockSize) + 1;
 
-	ret = fill_zero(p_gparti->bio, start, min(min_end, end));
-	if (EFI_ERROR(ret)) {
-		efi_perror(ret, L"Failed to erase partition %s", label);
-		return ret;
+	/* Deallocating the whole partition only takes a few seconds
+	   when the storage supports it and spares the flash
+	   translation layer the garbage collection of stale data.
+	   It is not mandatory for a fast erase though. */
+	ret = storage_discard_blocks(p_gparti->handle, p_gparti->bio, start, end, &zeroed);
+	if (EFI_ERROR(ret) && ret != EFI_UNSUPPORTED)
+		efi_perror(ret, L"Failed to discard partition %s, ignoring", label);
+
+	if (EFI_ERROR(ret) || !zeroed) {
+		ret = fill_zero(p_gparti->bio, start, min(min_end, end));
+		if (EFI_ERROR(ret)) {
+			efi_perror(ret, L"Failed to erase partition %s", label);
+			return ret;
+		}
 	}
 
 	if (!CompareGuid(&p_gparti->part.type, &EfiPartTypeSystemPartitionGuid))
-		return gpt_refresh();
+		return gpt_refresh_partition(label, LOGICAL_UNIT_USER);
 
 	return EFI_SUCCESS;
 }
@@ -625,6 +841,10 @@ EFI_STATUS erase_by_label(CHAR16 *label)
 	BOOLEAN is_data = (!StrCmp(label, L"userdata") || !StrCmp(label, L"data"));
 	BOOLEAN is_share_data = !StrCmp(label, L"share_data");
 
+	ret = digest_cache_invalidate();
+	if (EFI_ERROR(ret))
+		return ret;
+
 	/* userdata/data partition only need to be erased once during each boot */
 	if (is_data || is_share_data) {
 		if ((is_data && userdata_erased) || (is_share_data && share_data_erased)) {
@@ -654,7 +874,7 @@ EFI_STATUS erase_by_label(CHAR16 *label)
 		return ret;
 	}
 	if (!CompareGuid(&p_gparti->part.type, &EfiPartTypeSystemPartitionGuid))
-		return gpt_refresh();
+		return gpt_refresh_partition(label, LOGICAL_UNIT_USER);
 
 	if (is_data)
 		userdata_erased = TRUE;
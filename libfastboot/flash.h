@@ -39,9 +39,14 @@
 
 extern BOOLEAN new_install_device;
 
+#define FLASH_VERIFY_VAR "flash-verify"
+#define FLASH_DIGEST_VAR "flash-digest"
+
 EFI_STATUS flash_skip(UINT64 size);
 EFI_STATUS flash_write(VOID *data, UINTN size);
 EFI_STATUS flash_fill(UINT32 pattern, UINTN size);
+EFI_STATUS flash_set_verify(BOOLEAN enable);
+BOOLEAN flash_get_verify(void);
 
 /* return value for flash() function */
 
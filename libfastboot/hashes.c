@@ -89,6 +89,14 @@ out:
 	return ret;
 }
 
+const EVP_MD *get_hash_algorithm(void)
+{
+	if (!selected_md)
+		set_hash_algorithm(NULL);
+
+	return selected_md;
+}
+
 static void hash_buffer(CHAR8 *buffer, UINT64 len, CHAR8 *hash)
 {
 	EVP_MD_CTX mdctx;
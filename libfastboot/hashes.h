@@ -35,6 +35,8 @@
 #ifndef _HASHES_H_
 #define _HASHES_H_
 
+#include <openssl/evp.h>
+
 #ifdef USE_MULTIBOOT
 EFI_STATUS get_ias_image_hash(const CHAR16 *label);
 #endif
@@ -43,6 +45,7 @@ EFI_STATUS get_boot_image_hash(const CHAR16 *label);
 EFI_STATUS get_bootloader_hash(const CHAR16 *label);
 EFI_STATUS get_fs_hash(const CHAR16 *label);
 EFI_STATUS set_hash_algorithm(const CHAR8 *algo);
+const EVP_MD *get_hash_algorithm(void);
 #if defined(USE_ACPIO) || defined(USE_ACPI)
 EFI_STATUS get_acpi_hash(const CHAR16 *label);
 #endif
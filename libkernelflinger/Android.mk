@@ -100,6 +100,7 @@ endif
 
 LOCAL_SRC_FILES := \
 	android.c \
+	cmdline.c \
 	efilinux.c \
 	acpi.c \
 	acpi_image.c \
@@ -107,6 +108,7 @@ LOCAL_SRC_FILES := \
 	options.c \
 	security.c \
 	vars.c \
+	digest_cache.c \
 	log.c \
 	em.c \
 	gpt.c \
@@ -175,6 +177,7 @@ ifneq ($(strip $(KERNELFLINGER_USE_UI)),false)
     LOCAL_SRC_FILES += \
 	ui.c \
 	ui_color.c \
+	ui_scale.c \
 	ui_font.c \
 	ui_textarea.c \
 	ui_image.c \
@@ -189,7 +192,8 @@ ifneq ($(strip $(KERNELFLINGER_USE_UI)),false)
 else
     LOCAL_SRC_FILES += \
 	no_ui.c \
-	ui_color.c
+	ui_color.c \
+	ui_scale.c
 endif
 
 ifeq ($(HAL_AUTODETECT),true)
@@ -437,6 +437,12 @@ static inline EFI_STATUS handover_jump(EFI_HANDLE image,
 
         log(L"handover jump ...\n");
 
+        /* The OS must not start before the slot tries count update
+         * is on disk */
+        ret = slot_commit();
+        if (EFI_ERROR(ret))
+                return ret;
+
         ret = setup_gdt();
         if (EFI_ERROR(ret)) {
                 efi_perror(ret, L"Failed to setup GDT");
@@ -679,21 +685,15 @@ static EFI_STATUS setup_ramdisk(UINT8 *bootimage, UINT8 *vendorbootimage, UINT8
             if (EFI_ERROR(ret))
                     goto out;
 
-            if (androidcmd != NULL) {
-                    int iret;
-                    iret = addBootConfigParameters(androidcmd, androidcmd_size,
-                                    (UINTN)ramdisk_addr + rboffset, vendor_hdr->bootconfig_size);
-                    if (iret < 0) {
-                            ret = EFI_INVALID_PARAMETER;
-                            goto out;
-                    }
-            } else {
-                    int iret;
-                    iret = addBootConfigTrailer((UINTN)ramdisk_addr + rboffset, vendor_hdr->bootconfig_size);
-                    if (iret < 0) {
-                            ret = EFI_INVALID_PARAMETER;
-                            goto out;
-                    }
+            struct BootConfigBuilder bootconfig;
+            if (initBootConfigBuilder(&bootconfig, (UINTN)ramdisk_addr + rboffset,
+                                      vendor_hdr->bootconfig_size, rsize - rboffset) < 0 ||
+                (androidcmd != NULL &&
+                 appendBootConfigParameters(&bootconfig, (char *)androidcmd,
+                                            androidcmd_size) < 0) ||
+                finalizeBootConfig(&bootconfig) < 0) {
+                    ret = EFI_INVALID_PARAMETER;
+                    goto out;
             }
         }
 
@@ -897,132 +897,109 @@ done:
         return bootreason;
 }
 
-EFI_STATUS prepend_command_line(CHAR16 **cmdline, CHAR16 *fmt, ...)
+/* Append the command line stored in the boot image header to CL */
+static EFI_STATUS append_bootimage_cmdline(IN struct boot_img_hdr *aosp_header,
+                                           OUT struct cmdline *cl)
 {
-        CHAR16 *old;
-        va_list args;
-        CHAR16 *string;
-        CHAR16 *new;
+        struct boot_img_hdr_v3 *v3;
+        EFI_STATUS ret;
 
-        old = *cmdline;
-        va_start(args, fmt);
-        string = VPoolPrint(fmt, args);
-        va_end(args);
+        if (aosp_header->header_version < BOOT_HEADER_V3) {
+                CHAR8 full_cmdline[BOOT_ARGS_SIZE + BOOT_EXTRA_ARGS_SIZE];
+                int offset = BOOT_ARGS_SIZE;
+                UINTN size = BOOT_ARGS_SIZE;
 
-        if (!string)
-                return EFI_OUT_OF_RESOURCES;
+                /* include the potential NUL terminal char */
+                ret = memcpy_s(full_cmdline, sizeof(full_cmdline), aosp_header->cmdline,
+                               BOOT_ARGS_SIZE);
+                if (EFI_ERROR(ret))
+                        return ret;
 
-        new = PoolPrint(L"%s %s", string, old);
-        FreePool(string);
-        if (!new)
-                return EFI_OUT_OF_RESOURCES;
+                /* if there is extra cmdline arguments */
+                if (aosp_header->extra_cmdline[0]) {
+                        /* legacy boot.img format cmdline is NUL terminated */
+                        if (!aosp_header->cmdline[BOOT_ARGS_SIZE - 1])
+                                offset--;
+                        ret = memcpy_s(full_cmdline + offset, sizeof(full_cmdline) - offset,
+                                       aosp_header->extra_cmdline, BOOT_EXTRA_ARGS_SIZE);
+                        if (EFI_ERROR(ret))
+                                return ret;
+                        size = offset + BOOT_EXTRA_ARGS_SIZE;
+                }
+                return cmdline_append_stra(cl, full_cmdline, strnlen(full_cmdline, size));
+        }
 
-        FreePool(old);
-        *cmdline = new;
-        return EFI_SUCCESS;
+        v3 = (struct boot_img_hdr_v3 *)aosp_header;
+        return cmdline_append_stra(cl, v3->cmdline,
+                                   strnlen(v3->cmdline, sizeof(v3->cmdline)));
 }
 
-
-static CHAR16 *get_command_line(IN struct boot_img_hdr *aosp_header,
-                                IN enum boot_target boot_target)
+static EFI_STATUS get_command_line(IN struct boot_img_hdr *aosp_header,
+                                   IN enum boot_target boot_target,
+                                   OUT struct cmdline *cl)
 {
         EFI_STATUS ret;
-        CHAR16 *cmdline16 = NULL;
 #ifndef USER
-        CHAR16 *cmdline_append = NULL;
-        CHAR16 *cmdline_prepend = NULL;
+        CHAR16 *replace16 = NULL;
+        CHAR16 *append16 = NULL;
+        CHAR16 *prepend16 = NULL;
         BOOLEAN needs_pause = FALSE;
 
         if (boot_target == NORMAL_BOOT || boot_target == MEMORY) {
-                cmdline16 = get_efi_variable_str8(&loader_guid, CMDLINE_REPLACE_VAR);
-                cmdline_append = get_efi_variable_str8(&loader_guid, CMDLINE_APPEND_VAR);
-                cmdline_prepend = get_efi_variable_str8(&loader_guid, CMDLINE_PREPEND_VAR);
+                replace16 = get_efi_variable_str8(&loader_guid, CMDLINE_REPLACE_VAR);
+                append16 = get_efi_variable_str8(&loader_guid, CMDLINE_APPEND_VAR);
+                prepend16 = get_efi_variable_str8(&loader_guid, CMDLINE_PREPEND_VAR);
         }
-#else
-        (void)boot_target; /* Get rid of a unused parameter warning */
-#endif
 
-        if (!cmdline16) {
-                if (aosp_header->header_version < BOOT_HEADER_V3) {
-                    CHAR8 full_cmdline[BOOT_ARGS_SIZE + BOOT_EXTRA_ARGS_SIZE];
-                    int offset = BOOT_ARGS_SIZE;
-
-                    /* include the potential NUL terminal char */
-                    ret = memcpy_s(full_cmdline, sizeof(full_cmdline), aosp_header->cmdline,
-                                   BOOT_ARGS_SIZE);
-                    if (EFI_ERROR(ret))
-                            goto failed;
-
-                    /* if there is extra cmdline arguments */
-                    if (aosp_header->extra_cmdline[0]) {
-                            /* legacy boot.img format cmdline is NUL terminated */
-                            if (!aosp_header->cmdline[BOOT_ARGS_SIZE - 1])
-                                    offset--;
-                            ret = memcpy_s(full_cmdline + offset, sizeof(full_cmdline) - offset,
-                                           aosp_header->extra_cmdline, BOOT_EXTRA_ARGS_SIZE);
-                            if (EFI_ERROR(ret))
-                                    goto failed;
-                    }
-                    cmdline16 = stra_to_str(full_cmdline);
-                } else {
-                    struct boot_img_hdr_v3 *v3 = (struct boot_img_hdr_v3 *)aosp_header;
-                    cmdline16 = stra_to_str(v3->cmdline);
-                }
-
-                if (!cmdline16)
-                        goto failed;
-#ifndef USER
-        } else {
-                error(L"Boot image command line overridden with '%s'", cmdline16);
+        if (replace16) {
+                error(L"Boot image command line overridden with '%s'", replace16);
                 needs_pause = TRUE;
+
+                ret = cmdline_append(cl, L"%s", replace16);
+                FreePool(replace16);
+        } else
+                ret = append_bootimage_cmdline(aosp_header, cl);
+#else
+        (void)boot_target; /* Get rid of a unused parameter warning */
+        ret = append_bootimage_cmdline(aosp_header, cl);
 #endif
-        }
+        if (EFI_ERROR(ret))
+                goto failed;
 
 #ifndef USER
-        if (cmdline_prepend) {
-                EFI_STATUS ret;
-
-                error(L"Prepending '%s' to command line", cmdline_prepend);
+        if (prepend16) {
+                error(L"Prepending '%s' to command line", prepend16);
                 needs_pause = TRUE;
 
-                ret = prepend_command_line(&cmdline16, L"%s", cmdline_prepend);
-                FreePool(cmdline_prepend);
+                ret = cmdline_prepend(cl, L"%s", prepend16);
                 if (EFI_ERROR(ret))
                         error(L"couldn't prepend to command line");
         }
 
-        if (cmdline_append) {
-                EFI_STATUS ret;
-
-                error(L"Appending '%s' to command line", cmdline_append);
+        if (append16) {
+                error(L"Appending '%s' to command line", append16);
                 needs_pause = TRUE;
 
-                ret = prepend_command_line(&cmdline_append, L"%s", cmdline16);
-                if (EFI_ERROR(ret)) {
-                        error(L"couldn't prepend to command line");
-                        FreePool(cmdline_append);
-                } else {
-                        FreePool(cmdline16);
-                        cmdline16 = cmdline_append;
-                }
+                ret = cmdline_append(cl, L"%s", append16);
+                if (EFI_ERROR(ret))
+                        error(L"couldn't append to command line");
         }
 
         if (needs_pause)
                 pause(1);
 #endif
-
-        return cmdline16;
+        ret = EFI_SUCCESS;
 
 failed:
 #ifndef USER
-        if (cmdline_append) {
-                FreePool(cmdline_append);
+        if (append16) {
+                FreePool(append16);
         }
-        if (cmdline_prepend) {
-                FreePool(cmdline_prepend);
+        if (prepend16) {
+                FreePool(prepend16);
         }
 #endif
-        return NULL;
+        return ret;
 }
 
 EFI_STATUS get_bootimage_2nd(VOID *bootimage, VOID **second, UINT32 *size)
@@ -1078,15 +1055,15 @@ EFI_STATUS get_bootimage_blob(VOID *bootimage, enum blobtype btype, VOID **blob,
  * trusted */
 static EFI_STATUS parse_bootvars_line(char *line, VOID *ctx)
 {
-        CHAR16 **cmdline16 = (CHAR16 **)ctx;
+        struct cmdline *cl = (struct cmdline *)ctx;
 
         if (strlen((CHAR8 *)line) == 0 || line[0] == '#')
                 return EFI_SUCCESS;
 
-        return prepend_command_line(cmdline16, L"%a", line);
+        return cmdline_prepend_stra(cl, (CHAR8 *)line, strlen((CHAR8 *)line));
 }
 
-static EFI_STATUS add_bootvars(VOID *bootimage, CHAR16 **cmdline16)
+static EFI_STATUS add_bootvars(VOID *bootimage, struct cmdline *cl)
 {
         VOID *bootvars;
         UINT32 bvsize;
@@ -1104,81 +1081,59 @@ static EFI_STATUS add_bootvars(VOID *bootimage, CHAR16 **cmdline16)
         }
 
         return parse_text_buffer(bootvars, bvsize, parse_bootvars_line,
-                                 cmdline16);
+                                 cl);
 }
 #endif
 
+/* Split the command line CMD between the androidboot parameters,
+ * returned in ANDROIDCMD as a '\n' separated list for the bootconfig,
+ * and the kernel parameters, written in the KERNELCMD buffer of
+ * KERNELCMD_SIZE bytes. */
 static EFI_STATUS classify_cmd_parameters(
-                IN UINT8 *cmd_conf,
-                OUT UINT8 *androidcmd,
-                OUT UINT8 *kernelcmd
+                IN CHAR8 *cmd,
+                OUT UINT8 **androidcmd,
+                OUT UINT8 *kernelcmd,
+                IN UINTN kernelcmd_size
                 )
 {
-	UINT32 cnt;
-	bool end = false;
-	CHAR8 *tempChar;
-	CHAR8 *androidcmd_tmp = androidcmd;
-	CHAR8 *kernelcmd_tmp = kernelcmd;
+	static const CHAR8 ANDROIDBOOT[] = "androidboot";
+	static const CHAR8 UNKNOWN[] = "unknown";
+	struct cmdline android, kernel;
+	EFI_STATUS ret;
+	CHAR8 *param;
+	UINTN len;
 
-	if (cmd_conf == NULL || androidcmd == NULL || kernelcmd == NULL)
+	if (cmd == NULL || androidcmd == NULL || kernelcmd == NULL)
 		return EFI_INVALID_PARAMETER;
 
-	tempChar = cmd_conf;
-	while(*tempChar == ' ')
-		tempChar += 1;
-
-	while (*tempChar != '\0') {
-		cnt = 0;
-		if (strncmp(tempChar, "androidboot", strlen("androidboot")) == 0) {
-			cnt = strlen("androidboot");
-			while (true) {
-				if (tempChar[cnt] == '\0') {
-					memcpy_s(androidcmd_tmp, cnt, tempChar, cnt);
-					androidcmd_tmp += cnt;
-					end = true;
-					break;
-				} else if (tempChar[cnt] == ' ') {
-					if (tempChar[cnt - 1] == '=') {
-						memcpy_s(androidcmd_tmp, cnt, tempChar, cnt);
-						memcpy_s(androidcmd_tmp + cnt, 7, "unknown", 7);
-						androidcmd_tmp += cnt + 7;
-					} else {
-						memcpy_s(androidcmd_tmp, cnt, tempChar, cnt);
-						androidcmd_tmp += cnt;
-					}
-					*androidcmd_tmp = '\n';
-					androidcmd_tmp += 1;
-					tempChar += cnt;
-					break;
-				}
-				cnt ++;
-			}
-		} else {
-			while (true) {
-				if (tempChar[cnt] == '\0') {
-					memcpy_s(kernelcmd_tmp, cnt, tempChar, cnt);
-					kernelcmd_tmp += cnt;
-					end = true;
-					break;
-				} else if (tempChar[cnt] == ' ') {
-					memcpy_s(kernelcmd_tmp, cnt+1, tempChar, cnt+1);
-					tempChar += cnt+1;
-					kernelcmd_tmp += cnt+1;
-					break;
-				}
-				cnt ++;
-			}
-		}
+	ret = cmdline_init(&android, strlen(cmd) + 1, '\n');
+	if (EFI_ERROR(ret))
+		return ret;
+	cmdline_init_fixed(&kernel, kernelcmd, kernelcmd_size, ' ');
 
-		if (end) break;
+	for (param = cmd; *param; param += len) {
+		while (*param == ' ')
+			param++;
 
-		while(*tempChar == ' ')
-			tempChar += 1;
-	}
+		for (len = 0; param[len] && param[len] != ' '; len++)
+			;
+		if (!len)
+			break;
 
-	*androidcmd_tmp = '\0';
-	*kernelcmd_tmp = '\0';
+		if (strncmp(param, (CHAR8 *)ANDROIDBOOT, sizeof(ANDROIDBOOT) - 1)) {
+			ret = cmdline_append_stra(&kernel, param, len);
+		} else {
+			ret = cmdline_append_stra(&android, param, len);
+			if (!EFI_ERROR(ret) && param[len - 1] == '=')
+				ret = cmdline_cat_stra(&android, UNKNOWN, sizeof(UNKNOWN) - 1);
+		}
+		if (EFI_ERROR(ret)) {
+			cmdline_free(&android);
+			return ret;
+		}
+	}
 
+	*androidcmd = cmdline_detach(&android);
 	return EFI_SUCCESS;
 }
 
@@ -1294,10 +1249,8 @@ static BOOLEAN is_same_console_type(CHAR8 *sos_console, CHAR8 *kernel_console) {
         CHAR8 *kernel_prefix_end = find_console_prefix_end(kernel_console);
 
         while (sos_console < sos_prefix_end && kernel_console < kernel_prefix_end) {
-                if (*sos_console != *kernel_console) {
-                        FreePool(kernel_console);
+                if (*sos_console != *kernel_console)
                         return FALSE;
-                }
                 sos_console++;
                 kernel_console++;
         }
@@ -1318,21 +1271,18 @@ static EFI_STATUS setup_command_line(
                 OUT UINT8 **androidcmd
                 )
 {
-	CHAR16 *cmdline16 = NULL;
+	struct cmdline cl;
 	char   *serialno = NULL;
 	CHAR16 *serialport = NULL;
 	CHAR16 *bootreason = NULL;
 	EFI_PHYSICAL_ADDRESS cmdline_addr = 0;
 	CHAR8 *cmdline;
-	CHAR8 *cmd_conf= NULL;
-	UINTN cmdlen;
-	UINTN cmdsize;
+	UINTN cmdsize = 0;
 	UINTN vb_cmdlen = 0;
 	EFI_STATUS ret;
 	struct boot_params *buf;
 	struct boot_img_hdr *aosp_header;
 	CHAR8 time_str8[128] = {0};
-	CHAR16 *time_str16 = NULL;
 	EFI_GUID *swap_guid = NULL;
 	CHAR8 *abl_cmd_line = NULL;
 	BOOLEAN is_uefi = TRUE;
@@ -1353,21 +1303,26 @@ static EFI_STATUS setup_command_line(
 	}
 
 	aosp_header = (struct boot_img_hdr *)bootimage;
-	cmdline16 = get_command_line(aosp_header, boot_target);
-	if (!cmdline16) {
-		ret = EFI_OUT_OF_RESOURCES;
+	ret = cmdline_init(&cl, EFI_PAGE_SIZE, ' ');
+	if (EFI_ERROR(ret))
+		return ret;
+
+	ret = get_command_line(aosp_header, boot_target, &cl);
+	if (EFI_ERROR(ret))
 		goto out;
-	}
 
 	if (aosp_header->header_version >= BOOT_HEADER_V3) {
 		struct vendor_boot_img_hdr_v3 *v3 = (struct vendor_boot_img_hdr_v3 *)vendorbootimage;
-		ret = prepend_command_line(&cmdline16, L"%a", v3->cmdline);
+		ret = cmdline_prepend_stra(&cl, v3->cmdline,
+					   strnlen(v3->cmdline, sizeof(v3->cmdline)));
+		if (EFI_ERROR(ret))
+			goto out;
 	}
 
 	/* Append serial number from DMI */
 	serialno = get_serial_number();
 	if (serialno) {
-		ret = prepend_command_line(&cmdline16,
+		ret = cmdline_prepend(&cl,
 				L"androidboot.serialno=%a g_ffs.iSerialNumber=%a",
 				serialno, serialno);
 		if (EFI_ERROR(ret))
@@ -1375,7 +1330,7 @@ static EFI_STATUS setup_command_line(
 	}
 
 	if (boot_target == CHARGER) {
-		ret = prepend_command_line(&cmdline16,
+		ret = cmdline_prepend(&cl,
 				L"androidboot.mode=charger");
 		if (EFI_ERROR(ret))
 			goto out;
@@ -1394,16 +1349,16 @@ static EFI_STATUS setup_command_line(
 		goto out;
 	}
 
-	ret = prepend_command_line(&cmdline16, L"androidboot.bootreason=%s", bootreason);
+	ret = cmdline_prepend(&cl, L"androidboot.bootreason=%s", bootreason);
 	if (EFI_ERROR(ret))
 		goto out;
-	ret = prepend_command_line(&cmdline16, L"androidboot.verifiedbootstate=%s",
+	ret = cmdline_prepend(&cl, L"androidboot.verifiedbootstate=%s",
 			boot_state_to_string(boot_state));
 	if (EFI_ERROR(ret))
 		goto out;
 
 	if (swap_guid) {
-		ret = prepend_command_line(&cmdline16, L"resume=PARTUUID=%g",
+		ret = cmdline_prepend(&cl, L"resume=PARTUUID=%g",
 				swap_guid);
 		if (EFI_ERROR(ret))
 			goto out;
@@ -1411,7 +1366,7 @@ static EFI_STATUS setup_command_line(
 
 	serialport = get_serial_port();
 	if (serialport) {
-		ret = prepend_command_line(&cmdline16, L"console=%s", serialport);
+		ret = cmdline_prepend(&cl, L"console=%s", serialport);
 		if (EFI_ERROR(ret))
 			goto out;
 	}
@@ -1424,12 +1379,14 @@ static EFI_STATUS setup_command_line(
                 *tmp = ' ';
                 tmp++;
         }
-        ret = prepend_command_line(&cmdline16, L"%a", cmd_for_kernel);
+        ret = cmdline_prepend_stra(&cl, (CHAR8 *)cmd_for_kernel, strlen((CHAR8 *)cmd_for_kernel));
+        if (EFI_ERROR(ret))
+                goto out;
 #endif
 
 #ifndef USER
         if (get_disable_watchdog()) {
-                ret = prepend_command_line(&cmdline16, CONVERT_TO_WIDE(TCO_OPT_DISABLED));
+                ret = cmdline_prepend(&cl, CONVERT_TO_WIDE(TCO_OPT_DISABLED));
                 if (EFI_ERROR(ret))
                         goto out;
         }
@@ -1486,13 +1443,13 @@ static EFI_STATUS setup_command_line(
 
 		if (diskbus2 && aosp_header->header_version < 2) {
 			warning(L"androidboot.diskbus only support 1 device, secondary_diskbus ignored");
-			ret = prepend_command_line(&cmdline16, L"androidboot.diskbus=%s", diskbus);
+			ret = cmdline_prepend(&cl, L"androidboot.diskbus=%s", diskbus);
 		} else if (diskbus2) {
-			ret = prepend_command_line(&cmdline16,
+			ret = cmdline_prepend(&cl,
 					L"androidboot.boot_devices=pci0000:00/0000:00:%s,pci0000:00/0000:00:%s pci=noaer",
 					diskbus, diskbus2);
 		} else {
-			ret = prepend_command_line(&cmdline16,
+			ret = cmdline_prepend(&cl,
 					L"androidboot.boot_devices=pci0000:00/0000:00:%s pci=noaer",
 					diskbus);
 		}
@@ -1505,7 +1462,7 @@ static EFI_STATUS setup_command_line(
 	} else
 		error(L"Boot device not found, diskbus parameter not set in the commandline!");
 
-	ret = prepend_command_line(&cmdline16, L"androidboot.bootloader=%a",
+	ret = cmdline_prepend(&cl, L"androidboot.bootloader=%a",
 			get_property_bootloader());
 	if (EFI_ERROR(ret))
 		goto out;
@@ -1514,23 +1471,23 @@ static EFI_STATUS setup_command_line(
 	//containing the recovery’s ramdisk. command line "androidboot.force_normal_boot=1" is
 	//mandatory for normal boot.
 	if(boot_target == NORMAL_BOOT) {
-		ret = prepend_command_line(&cmdline16, L"androidboot.force_normal_boot=1");
+		ret = cmdline_prepend(&cl, L"androidboot.force_normal_boot=1");
 		if (EFI_ERROR(ret))
 			goto out;
 	}
 #endif
-	ret = prepend_command_line(&cmdline16, L"androidboot.acpi_idx=%a ",
+	ret = cmdline_prepend(&cl, L"androidboot.acpi_idx=%a ",
 			acpi_loaded_table_idx_to_string(BOOT_ACPI));
 	if (EFI_ERROR(ret))
 		goto out;
 
-	ret = prepend_command_line(&cmdline16, L"androidboot.acpio_idx=%a ",
+	ret = cmdline_prepend(&cl, L"androidboot.acpio_idx=%a ",
 			acpi_loaded_table_idx_to_string(ACPIO));
 	if (EFI_ERROR(ret))
 		goto out;
 
 #ifdef HAL_AUTODETECT
-	ret = prepend_command_line(&cmdline16, L"androidboot.brand=%a "
+	ret = cmdline_prepend(&cl, L"androidboot.brand=%a "
 			"androidboot.name=%a androidboot.device=%a "
 			"androidboot.model=%a", get_property_brand(),
 			get_property_name(), get_property_device(),
@@ -1539,57 +1496,29 @@ static EFI_STATUS setup_command_line(
 		goto out;
 
 	if (aosp_header->header_version < BOOT_HEADER_V3) {
-		ret = add_bootvars(bootimage, &cmdline16);
+		ret = add_bootvars(bootimage, &cl);
 		if (EFI_ERROR(ret))
 			goto out;
 	}
 #endif
 
-	ret = prepend_slot_command_line(&cmdline16, boot_target, vb_data);
+	ret = prepend_slot_command_line(&cl, boot_target, vb_data);
 	if (EFI_ERROR(ret))
 		goto out;
 	/* append stages boottime */
 	set_boottime_stamp(TM_JMP_KERNEL);
 	construct_stages_boottime(time_str8, sizeof(time_str8));
-	time_str16 = stra_to_str(time_str8);
-	if (time_str16) {
-		ret = prepend_command_line(&cmdline16, L"androidboot.boottime=%s", time_str16);
-		if (EFI_ERROR(ret))
-			goto out;
-	}
+	ret = cmdline_prepend(&cl, L"androidboot.boottime=%a", time_str8);
+	if (EFI_ERROR(ret))
+		goto out;
 
 	if(boot_target != MEMORY)
 		vb_cmdlen = get_vb_cmdlen(vb_data);
 
-	cmdlen = StrLen(cmdline16);
-	if (is_uefi) {
-		cmdsize = cmdlen + 1 + vb_cmdlen + 1;
-	} else {
-		cmdsize = cmdlen + vb_cmdlen + abl_cmd_len + 256;
-	}
-
-	cmd_conf = AllocatePool(cmdsize);
-	if (cmd_conf == NULL) {
-		ret = EFI_OUT_OF_RESOURCES;
-		goto out;
-	}
-
-	ret = str_to_stra(cmd_conf, cmdline16, cmdlen + 1);
-	if (EFI_ERROR(ret)) {
-		error(L"Non-ascii characters in command line");
-		goto out;
-	}
-
         if (vb_cmdlen > 0) {
-                char *vb_cmdline;
-                vb_cmdline = get_vb_cmdline(vb_data);
-                cmd_conf[cmdlen] = ' ';
-                ret = memcpy_s(cmd_conf + cmdlen + 1, vb_cmdlen, vb_cmdline, vb_cmdlen);
-                if (EFI_ERROR(ret)) {
+                ret = cmdline_append_stra(&cl, (CHAR8 *)get_vb_cmdline(vb_data), vb_cmdlen);
+                if (EFI_ERROR(ret))
                         goto out;
-                }
-                cmdlen += vb_cmdlen + 1;
-                cmd_conf[cmdlen] = 0;
         }
 
         /* Append command line from ABL */
@@ -1599,7 +1528,7 @@ static EFI_STATUS setup_command_line(
                 if (abl_console) {
                         abl_console += 8;
 
-                        CHAR8 *kernel_console = strcasestr(cmd_conf, "console=");
+                        CHAR8 *kernel_console = strcasestr(cmdline_str(&cl), "console=");
                         if (kernel_console) {
                                 kernel_console += 8;
 
@@ -1609,25 +1538,22 @@ static EFI_STATUS setup_command_line(
                                         if (!kernel_console_end) {
                                                 kernel_console_end = kernel_console + strlen(kernel_console);
                                         }
-                                        
-                                        UINTN console_entry_len = kernel_console_end - (kernel_console - 8);
-                                        memmove(kernel_console - 8, kernel_console_end, strlen(kernel_console_end) + 1);
 
-                                        cmdlen -= console_entry_len;
-                                        cmdsize -= console_entry_len;
+                                        cmdline_remove(&cl, kernel_console - 8,
+                                                       kernel_console_end - (kernel_console - 8));
                                 }
                         }
                 }
 
-                cmd_conf[cmdlen] = ' ';
-                ret = memcpy_s(cmd_conf + cmdlen + 1, abl_cmd_len + 1, abl_cmd_line, abl_cmd_len + 1);
-                if (EFI_ERROR(ret)) {
+                ret = cmdline_append_stra(&cl, abl_cmd_line, abl_cmd_len);
+                if (EFI_ERROR(ret))
                         goto out;
-                }
-                cmdlen += abl_cmd_len + 1;
-                cmd_conf[cmdlen] = '\0';
         }
 
+	cmdsize = cmdline_len(&cl) + 1;
+	if (!is_uefi)
+		cmdsize += 256;
+
 	if (is_uefi) {
 		/* Documentation/x86/boot.txt: "The kernel command line can be located
 		 * anywhere between the end of the setup heap and 0xA0000" */
@@ -1649,39 +1575,20 @@ static EFI_STATUS setup_command_line(
 
 	cmdline = (CHAR8 *)(UINTN)cmdline_addr;
 
-	if (aosp_header->header_version <= BOOT_HEADER_V3) {
-		ret = memcpy_s(cmdline, cmdsize, cmd_conf, cmdsize);
-	} else {
-		if (androidcmd == NULL) {
-			ret = EFI_INVALID_PARAMETER;
-			goto out;
-		}
-		*androidcmd= AllocatePool(cmdsize);
-		if (*androidcmd == NULL) {
-			ret = EFI_OUT_OF_RESOURCES;
-			goto out;
-		}
-
-		ret = classify_cmd_parameters(cmd_conf, *androidcmd, cmdline);
-	}
-
-	if (EFI_ERROR(ret)) {
-		free_pages(cmdline_addr, EFI_SIZE_TO_PAGES(cmdsize));
+	if (aosp_header->header_version <= BOOT_HEADER_V3)
+		ret = memcpy_s(cmdline, cmdsize, cmdline_str(&cl), cmdline_len(&cl) + 1);
+	else
+		ret = classify_cmd_parameters(cmdline_str(&cl), androidcmd, cmdline, cmdsize);
+	if (EFI_ERROR(ret))
 		goto out;
-	}
 
 	buf = get_boot_param_hdr(bootimage);
 	buf->hdr.cmd_line_ptr = (UINT32)(UINTN)cmdline;
 	ret = EFI_SUCCESS;
 out:
-	if (cmdline16)
-		FreePool(cmdline16);
-	if (cmd_conf)
-		FreePool(cmd_conf);
+	cmdline_free(&cl);
 	if (serialport)
 		FreePool(serialport);
-	if (time_str16)
-		FreePool(time_str16);
 	if (EFI_ERROR(ret) && cmdline_addr) {
 		if (is_uefi) {
 			free_pages(cmdline_addr, EFI_SIZE_TO_PAGES(cmdsize));
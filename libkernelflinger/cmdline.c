@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <lib.h>
+
+#include "cmdline.h"
+
+#define CMDLINE_MIN_SIZE	256
+#define CMDLINE_SCRATCH_LEN	256
+
+EFI_STATUS cmdline_init(struct cmdline *cl, UINTN size, CHAR8 sep)
+{
+	ZeroMem(cl, sizeof(*cl));
+
+	cl->size = max(size, (UINTN)CMDLINE_MIN_SIZE);
+	cl->buf = AllocatePool(cl->size);
+	if (!cl->buf)
+		return EFI_OUT_OF_RESOURCES;
+
+	cl->start = cl->size / 2;
+	cl->buf[cl->start] = '\0';
+	cl->sep = sep;
+
+	return EFI_SUCCESS;
+}
+
+void cmdline_init_fixed(struct cmdline *cl, CHAR8 *buf, UINTN size, CHAR8 sep)
+{
+	ZeroMem(cl, sizeof(*cl));
+
+	cl->buf = buf;
+	cl->size = size;
+	cl->sep = sep;
+	cl->fixed = TRUE;
+	if (size)
+		buf[0] = '\0';
+}
+
+void cmdline_free(struct cmdline *cl)
+{
+	if (cl->scratch)
+		FreePool(cl->scratch);
+	if (cl->buf && !cl->fixed)
+		FreePool(cl->buf);
+	ZeroMem(cl, sizeof(*cl));
+}
+
+/* Make sure there is room for NEED characters at the beginning
+ * (PREPEND) or at the end of the content.  The content is re-centered
+ * in a buffer at least twice as large when it does not fit. */
+static EFI_STATUS cmdline_reserve(struct cmdline *cl, UINTN need, BOOLEAN prepend)
+{
+	UINTN size, start;
+	CHAR8 *buf;
+
+	if (prepend ? need <= cl->start :
+	    cl->start + cl->len + need + 1 <= cl->size)
+		return EFI_SUCCESS;
+
+	if (cl->fixed || !cl->buf)
+		return EFI_BUFFER_TOO_SMALL;
+
+	size = max(cl->size * 2, (cl->len + need + 1) * 2);
+	buf = AllocatePool(size);
+	if (!buf)
+		return EFI_OUT_OF_RESOURCES;
+
+	start = (size - cl->len - 1) / 2;
+	CopyMem(buf + start, cl->buf + cl->start, cl->len + 1);
+	FreePool(cl->buf);
+
+	cl->buf = buf;
+	cl->size = size;
+	cl->start = start;
+
+	return EFI_SUCCESS;
+}
+
+/* Reserve room for a LEN characters segment at the beginning
+ * (PREPEND) or at the end of the content and return where to write
+ * it.  The separator is written unless the segment extends the last
+ * one (CAT). */
+static EFI_STATUS cmdline_add(struct cmdline *cl, UINTN len, BOOLEAN prepend,
+			      BOOLEAN cat, CHAR8 **dst)
+{
+	EFI_STATUS ret;
+	BOOLEAN sep = cl->len && !cat;
+
+	ret = cmdline_reserve(cl, len + (sep ? 1 : 0), prepend);
+	if (EFI_ERROR(ret))
+		return ret;
+
+	if (prepend) {
+		if (sep)
+			cl->buf[--cl->start] = cl->sep;
+		cl->start -= len;
+		*dst = cl->buf + cl->start;
+	} else {
+		*dst = cl->buf + cl->start + cl->len;
+		if (sep)
+			*(*dst)++ = cl->sep;
+		(*dst)[len] = '\0';
+	}
+	cl->len += len + (sep ? 1 : 0);
+
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS cmdline_add_stra(struct cmdline *cl, const CHAR8 *str, UINTN len,
+				   BOOLEAN prepend, BOOLEAN cat)
+{
+	EFI_STATUS ret;
+	CHAR8 *dst;
+
+	if (!len)
+		return EFI_SUCCESS;
+
+	ret = cmdline_add(cl, len, prepend, cat, &dst);
+	if (EFI_ERROR(ret))
+		return ret;
+
+	CopyMem(dst, (VOID *)str, len);
+	return EFI_SUCCESS;
+}
+
+EFI_STATUS cmdline_prepend_stra(struct cmdline *cl, const CHAR8 *str, UINTN len)
+{
+	return cmdline_add_stra(cl, str, len, TRUE, FALSE);
+}
+
+EFI_STATUS cmdline_append_stra(struct cmdline *cl, const CHAR8 *str, UINTN len)
+{
+	return cmdline_add_stra(cl, str, len, FALSE, FALSE);
+}
+
+EFI_STATUS cmdline_cat_stra(struct cmdline *cl, const CHAR8 *str, UINTN len)
+{
+	return cmdline_add_stra(cl, str, len, FALSE, TRUE);
+}
+
+/* Format in the scratch buffer.  EFI_BUFFER_TOO_SMALL is returned
+ * once the scratch buffer has been grown: the caller has to restart
+ * the variable argument list and call again. */
+static EFI_STATUS cmdline_vformat(struct cmdline *cl, const CHAR16 *fmt,
+				  va_list args, UINTN *len)
+{
+	UINTN new_len;
+
+	if (!cl->scratch) {
+		cl->scratch = AllocatePool(CMDLINE_SCRATCH_LEN * sizeof(CHAR16));
+		if (!cl->scratch)
+			return EFI_OUT_OF_RESOURCES;
+		cl->scratch_len = CMDLINE_SCRATCH_LEN;
+	}
+
+	*len = VSPrint(cl->scratch, cl->scratch_len * sizeof(CHAR16),
+		       (CHAR16 *)fmt, args);
+	if (*len + 1 < cl->scratch_len)
+		return EFI_SUCCESS;
+
+	new_len = cl->scratch_len * 2;
+	FreePool(cl->scratch);
+	cl->scratch = AllocatePool(new_len * sizeof(CHAR16));
+	if (!cl->scratch) {
+		cl->scratch_len = 0;
+		return EFI_OUT_OF_RESOURCES;
+	}
+	cl->scratch_len = new_len;
+
+	return EFI_BUFFER_TOO_SMALL;
+}
+
+static EFI_STATUS cmdline_add_scratch(struct cmdline *cl, UINTN len, BOOLEAN prepend)
+{
+	EFI_STATUS ret;
+	CHAR8 *dst;
+	UINTN i;
+
+	if (!len)
+		return EFI_SUCCESS;
+
+	for (i = 0; i < len; i++)
+		if (cl->scratch[i] > 0x7f) {
+			error(L"Non-ascii characters in command line");
+			return EFI_INVALID_PARAMETER;
+		}
+
+	ret = cmdline_add(cl, len, prepend, FALSE, &dst);
+	if (EFI_ERROR(ret))
+		return ret;
+
+	for (i = 0; i < len; i++)
+		dst[i] = (CHAR8)cl->scratch[i];
+
+	return EFI_SUCCESS;
+}
+
+EFI_STATUS cmdline_prepend(struct cmdline *cl, const CHAR16 *fmt, ...)
+{
+	EFI_STATUS ret;
+	va_list args;
+	UINTN len;
+
+	do {
+		va_start(args, fmt);
+		ret = cmdline_vformat(cl, fmt, args, &len);
+		va_end(args);
+	} while (ret == EFI_BUFFER_TOO_SMALL);
+
+	if (EFI_ERROR(ret))
+		return ret;
+
+	return cmdline_add_scratch(cl, len, TRUE);
+}
+
+EFI_STATUS cmdline_append(struct cmdline *cl, const CHAR16 *fmt, ...)
+{
+	EFI_STATUS ret;
+	va_list args;
+	UINTN len;
+
+	do {
+		va_start(args, fmt);
+		ret = cmdline_vformat(cl, fmt, args, &len);
+		va_end(args);
+	} while (ret == EFI_BUFFER_TOO_SMALL);
+
+	if (EFI_ERROR(ret))
+		return ret;
+
+	return cmdline_add_scratch(cl, len, FALSE);
+}
+
+void cmdline_remove(struct cmdline *cl, CHAR8 *pos, UINTN len)
+{
+	CHAR8 *str = cmdline_str(cl);
+	UINTN offset = pos - str;
+
+	if (pos < str || offset > cl->len)
+		return;
+
+	len = min(len, cl->len - offset);
+	memmove(pos, pos + len, cl->len - offset - len + 1);
+	cl->len -= len;
+}
+
+CHAR8 *cmdline_str(struct cmdline *cl)
+{
+	return cl->buf + cl->start;
+}
+
+CHAR8 *cmdline_detach(struct cmdline *cl)
+{
+	CHAR8 *str;
+
+	if (cl->fixed || !cl->buf)
+		return NULL;
+
+	str = cl->buf;
+	if (cl->start)
+		memmove(str, str + cl->start, cl->len + 1);
+	cl->buf = NULL;
+	cmdline_free(cl);
+
+	return str;
+}
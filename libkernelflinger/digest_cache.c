@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <efi.h>
+#include <efilib.h>
+#include <lib.h>
+#include <log.h>
+#include "vars.h"
+#include "digest_cache.h"
+
+#define DIGEST_CACHE_VAR	L"VbDigests"
+#define WRITE_GENERATION_VAR	L"VbWriteGeneration"
+#define DIGEST_CACHE_MAGIC	0x48434456	/* VDCH */
+
+struct digest_cache_entry {
+	char partition[DIGEST_CACHE_NAME_LEN];
+	UINT64 image_size;
+	UINT32 digest_len;
+	UINT8 digest[DIGEST_CACHE_DIGEST_LEN];
+} __attribute__((__packed__));
+
+struct digest_cache {
+	UINT32 magic;
+	UINT32 generation;
+	UINT32 count;
+	struct digest_cache_entry entries[DIGEST_CACHE_ENTRIES];
+} __attribute__((__packed__));
+
+#define DIGEST_CACHE_SIZE(count) \
+	(offsetof(struct digest_cache, entries) + \
+	 (count) * sizeof(struct digest_cache_entry))
+
+static struct digest_cache cache;
+static BOOLEAN cache_loaded;
+
+static BOOLEAN digest_cache_usable(void)
+{
+	return device_is_unlocked() && get_vb_digest_cache();
+}
+
+static UINT32 read_write_generation(void)
+{
+	EFI_STATUS ret;
+	UINTN size;
+	VOID *data;
+	UINT32 generation = 0;
+
+	ret = get_efi_variable(&fastboot_guid, WRITE_GENERATION_VAR,
+			       &size, &data, NULL);
+	if (EFI_ERROR(ret))
+		return 0;
+
+	if (size == sizeof(generation))
+		generation = *(UINT32 *)data;
+
+	FreePool(data);
+	return generation;
+}
+
+/* Load the cache recorded by a previous boot.  It is dropped if the
+ * partitions may have been written since it has been saved. */
+static void load_cache(void)
+{
+	EFI_STATUS ret;
+	UINTN size;
+	struct digest_cache *saved;
+
+	if (cache_loaded)
+		return;
+
+	cache_loaded = TRUE;
+	cache.magic = DIGEST_CACHE_MAGIC;
+	cache.generation = read_write_generation();
+	cache.count = 0;
+
+	ret = get_efi_variable(&fastboot_guid, DIGEST_CACHE_VAR,
+			       &size, (VOID **)&saved, NULL);
+	if (EFI_ERROR(ret))
+		return;
+
+	if (size >= DIGEST_CACHE_SIZE(0) &&
+	    saved->magic == DIGEST_CACHE_MAGIC &&
+	    saved->generation == cache.generation &&
+	    saved->count <= DIGEST_CACHE_ENTRIES &&
+	    size == DIGEST_CACHE_SIZE(saved->count))
+		memcpy_s(&cache, sizeof(cache), saved, size);
+	else
+		debug(L"Dropping stale verified boot digest cache");
+
+	FreePool(saved);
+}
+
+static struct digest_cache_entry *find_entry(const char *partition)
+{
+	UINT32 i;
+
+	for (i = 0; i < cache.count; i++)
+		if (!strcmp((CHAR8 *)cache.entries[i].partition,
+			    (CHAR8 *)partition))
+			return &cache.entries[i];
+
+	return NULL;
+}
+
+/* Writes are not tracked while the cache is disabled: enabling it
+ * bumps the generation, which drops the digests recorded before.  If
+ * the generation cannot be bumped, the digests are deleted instead.
+ * The caller must not write the partitions if this fails. */
+EFI_STATUS digest_cache_invalidate(void)
+{
+#ifndef USER
+	EFI_STATUS ret;
+	UINT32 generation;
+
+	if (!get_vb_digest_cache())
+		return EFI_SUCCESS;
+
+	cache_loaded = FALSE;
+
+	generation = read_write_generation() + 1;
+	ret = set_efi_variable(&fastboot_guid, WRITE_GENERATION_VAR,
+			       sizeof(generation), &generation, TRUE, FALSE);
+	if (!EFI_ERROR(ret))
+		return EFI_SUCCESS;
+
+	efi_perror(ret, L"Failed to set %s variable", WRITE_GENERATION_VAR);
+	ret = del_efi_variable(&fastboot_guid, DIGEST_CACHE_VAR);
+	if (EFI_ERROR(ret) && ret != EFI_NOT_FOUND) {
+		efi_perror(ret, L"Failed to delete %s variable", DIGEST_CACHE_VAR);
+		return ret;
+	}
+#endif
+	return EFI_SUCCESS;
+}
+
+BOOLEAN digest_cache_lookup(const char *partition, UINT64 image_size,
+			    const UINT8 *digest, UINTN digest_len)
+{
+	struct digest_cache_entry *entry;
+
+	if (!digest_cache_usable())
+		return FALSE;
+
+	load_cache();
+	entry = find_entry(partition);
+	if (!entry)
+		return FALSE;
+
+	return entry->image_size == image_size &&
+		entry->digest_len == digest_len &&
+		!memcmp(entry->digest, digest, digest_len);
+}
+
+EFI_STATUS digest_cache_store(const char *partition, UINT64 image_size,
+			      const UINT8 *digest, UINTN digest_len)
+{
+	EFI_STATUS ret;
+	struct digest_cache_entry *entry;
+
+	if (!digest_cache_usable())
+		return EFI_SUCCESS;
+
+	if (digest_len > DIGEST_CACHE_DIGEST_LEN ||
+	    strlen((CHAR8 *)partition) >= DIGEST_CACHE_NAME_LEN)
+		return EFI_INVALID_PARAMETER;
+
+	load_cache();
+	entry = find_entry(partition);
+	if (entry && entry->image_size == image_size &&
+	    entry->digest_len == digest_len &&
+	    !memcmp(entry->digest, digest, digest_len))
+		return EFI_SUCCESS;
+
+	if (!entry) {
+		/* Evict the oldest entry if the cache is full. */
+		if (cache.count == DIGEST_CACHE_ENTRIES) {
+			memmove(cache.entries, cache.entries + 1,
+				(DIGEST_CACHE_ENTRIES - 1) * sizeof(*entry));
+			cache.count--;
+		}
+		entry = &cache.entries[cache.count++];
+	}
+
+	memset_s(entry, sizeof(*entry), 0, sizeof(*entry));
+	strcpy_s(entry->partition, sizeof(entry->partition), partition);
+	entry->image_size = image_size;
+	entry->digest_len = digest_len;
+	memcpy_s(entry->digest, sizeof(entry->digest), digest, digest_len);
+
+	ret = set_efi_variable(&fastboot_guid, DIGEST_CACHE_VAR,
+			       DIGEST_CACHE_SIZE(cache.count), &cache, TRUE, FALSE);
+	if (EFI_ERROR(ret))
+		efi_perror(ret, L"Failed to set %s variable", DIGEST_CACHE_VAR);
+
+	return ret;
+}
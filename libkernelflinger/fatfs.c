@@ -35,6 +35,38 @@
 
 static FATSYSTEM g_fatsystem;
 
+static EFI_STATUS fresult_to_efi_status(FRESULT f_ret)
+{
+	switch (f_ret) {
+	case FR_OK:
+		return EFI_SUCCESS;
+	case FR_NO_FILE:
+	case FR_NO_PATH:
+		return EFI_NOT_FOUND;
+	case FR_INVALID_NAME:
+	case FR_INVALID_OBJECT:
+	case FR_INVALID_DRIVE:
+	case FR_INVALID_PARAMETER:
+		return EFI_INVALID_PARAMETER;
+	case FR_DENIED:
+	case FR_EXIST:
+	case FR_LOCKED:
+		return EFI_ACCESS_DENIED;
+	case FR_WRITE_PROTECTED:
+		return EFI_WRITE_PROTECTED;
+	case FR_INT_ERR:
+	case FR_NO_FILESYSTEM:
+		return EFI_VOLUME_CORRUPTED;
+	case FR_NOT_ENOUGH_CORE:
+	case FR_TOO_MANY_OPEN_FILES:
+		return EFI_OUT_OF_RESOURCES;
+	case FR_TIMEOUT:
+		return EFI_TIMEOUT;
+	default:
+		return EFI_DEVICE_ERROR;
+	}
+}
+
 VOID debug_ascii(CHAR8 * ch, UINT16 size) {
 	UINT16 i;
 	CHAR8 *p;
@@ -55,29 +87,56 @@ VOID debug_hex(UINT32 offset, CHAR8 *data, UINT16 size){
 				d[5], d[6], d[7]);
 	}
 }
-UINT32 fat_getbpb_offset(){
+UINT64 fat_getbpb_offset(){
 	return g_fatsystem.bpb_offset;
 }
 
-EFI_STATUS fat_readdisk(UINT32 offset, UINT32 len, void *data) {
+UINT32 fat_get_sector_size(){
+	return g_fatsystem.sector_size;
+}
+
+static EFI_STATUS fat_diskio_read(FATSYSTEM *fs, UINT64 offset, UINT32 len, void *data)
+{
+	EFI_STATUS ret;
+
+	ret = uefi_call_wrapper(fs->parti.dio->ReadDisk, 5, fs->parti.dio,
+			fs->parti.bio->Media->MediaId,
+			offset, len, (VOID *)data);
+	if (EFI_ERROR(ret))
+		efi_perror(ret, L"fat read failed");
+	return ret;
+}
+
+EFI_STATUS fat_readdisk(UINT64 offset, UINT32 len, void *data) {
 	FATSYSTEM *fs = &g_fatsystem;
 	EFI_STATUS ret = EFI_SUCCESS;
+	UINT32 cache_len;
 	if (fs == NULL || fs->parti.dio == NULL || fs->parti.bio == NULL)
 	{
 		debug(L"fat_readdisk init fail");
 		return EFI_INVALID_PARAMETER;
 	}
-	//ret = fs->dio->ReadDisk(fs->dio, fs->bio->Media->MediaId, offset, len, data);
-	ret = uefi_call_wrapper(fs->parti.dio->ReadDisk, 5, fs->parti.dio,
-			fs->parti.bio->Media->MediaId,
-			offset, len, (VOID *)data);
 
+	if (fs->cache.len && offset >= fs->cache.offset &&
+	    offset + len <= fs->cache.offset + fs->cache.len)
+		return memcpy_s(data, len, fs->cache.buf + (offset - fs->cache.offset), len);
+
+	/* Large requests are already coalesced by FatFs */
+	if (!fs->cache.buf || len >= FAT_CACHE_SIZE || offset + len > fs->part_end)
+		return fat_diskio_read(fs, offset, len, data);
+
+	cache_len = min(fs->part_end - offset, (UINT64)FAT_CACHE_SIZE);
+	fs->cache.len = 0;
+	ret = fat_diskio_read(fs, offset, cache_len, fs->cache.buf);
 	if (EFI_ERROR(ret))
-		efi_perror(ret, L"fat read failed");
-	return ret;
+		return ret;
+	fs->cache.offset = offset;
+	fs->cache.len = cache_len;
+
+	return memcpy_s(data, len, fs->cache.buf, len);
 }
 
-EFI_STATUS fat_writedisk( UINT32 offset, UINT32 len, void *data)
+EFI_STATUS fat_writedisk(UINT64 offset, UINT32 len, void *data)
 {
 	FATSYSTEM *fs = &g_fatsystem;
 	EFI_STATUS ret = EFI_SUCCESS;
@@ -86,12 +145,191 @@ EFI_STATUS fat_writedisk( UINT32 offset, UINT32 len, void *data)
 		debug(L"fat_writedisk init fail");
 		return EFI_INVALID_PARAMETER;
 	}
+	if (offset < fs->cache.offset + fs->cache.len &&
+	    fs->cache.offset < offset + len)
+		fs->cache.len = 0;
 	ret = uefi_call_wrapper(fs->parti.dio->WriteDisk, 5, fs->parti.dio, fs->parti.bio->Media->MediaId,offset,len,data);
 	if (EFI_ERROR(ret))
 		efi_perror(ret, L"fat write failed");
 	return ret;
 }
 
+/* Mount the FAT volume of the FS->parti partition.  The FatFs sector
+ * size is taken from the BPB so that both 512 bytes and 4K native
+ * formatted volumes are supported.
+ */
+static EFI_STATUS fat_mount(FATSYSTEM *fs)
+{
+	EFI_STATUS ret;
+	UINT32 block_size = fs->parti.bio->Media->BlockSize;
+	UINT8 bpb[512];
+	UINT16 ssize;
+
+	fs->bpb_offset = fs->parti.part.starting_lba * block_size;
+	fs->part_end = (fs->parti.part.ending_lba + 1) * block_size;
+
+	if (!fs->cache.buf) {
+		fs->cache.buf = AllocatePool(FAT_CACHE_SIZE);
+		if (!fs->cache.buf)
+			debug(L"No memory for the FAT cache, reading through");
+	}
+	fs->cache.len = 0;
+
+	ret = fat_readdisk(fs->bpb_offset, sizeof(bpb), bpb);
+	if (EFI_ERROR(ret)) {
+		efi_perror(ret, L"Failed to get FAT BPB");
+		return ret;
+	}
+
+	ssize = UINT8to16(bpb[12], bpb[11]);
+	if (ssize < FF_MIN_SS || ssize > FF_MAX_SS || (ssize & (ssize - 1))) {
+		error(L"Unsupported FAT sector size %d", ssize);
+		return EFI_UNSUPPORTED;
+	}
+	fs->sector_size = ssize;
+
+	fs->fatfs.pdrv = 4;
+	if(FR_OK != f_mount(&fs->fatfs,L"/",1)) {
+		debug(L"the file is not mount success");
+		return EFI_NOT_FOUND;
+	}
+	debug(L"f_mount success");
+	return EFI_SUCCESS;
+}
+
+/* Build the cluster link map of FP so that accessing the file does
+ * not walk the FAT chain.  A file too fragmented for the map keeps
+ * using the FAT chain.
+ */
+static void fat_fastseek(FIL *fp)
+{
+	static DWORD linkmap[FAT_LINKMAP_SIZE];
+
+	linkmap[0] = FAT_LINKMAP_SIZE;
+	fp->cltbl = linkmap;
+	if (f_lseek(fp, CREATE_LINKMAP) != FR_OK) {
+		debug(L"fast seek unavailable, needs %d entries", linkmap[0]);
+		fp->cltbl = NULL;
+	}
+}
+
+/* CRC32 of the FAT entries describing the cluster run of EXT */
+static EFI_STATUS fat_extent_crc(struct gpt_partition_interface *parti,
+				 fat_extent_t *ext, UINT32 *crc)
+{
+	EFI_STATUS ret;
+	UINT8 *fat;
+
+	fat = AllocatePool(ext->fat_len);
+	if (!fat)
+		return EFI_OUT_OF_RESOURCES;
+
+	ret = uefi_call_wrapper(parti->dio->ReadDisk, 5, parti->dio,
+				parti->bio->Media->MediaId,
+				ext->starting_lba * parti->bio->Media->BlockSize +
+				ext->fat_offset, ext->fat_len, fat);
+	if (!EFI_ERROR(ret))
+		ret = uefi_call_wrapper(BS->CalculateCrc32, 3, fat,
+					ext->fat_len, crc);
+	FreePool(fat);
+	return ret;
+}
+
+/* Locate the clusters holding PATH on the FAT volume of partition
+ * LABEL.  Only files stored in one run of clusters on a FAT16 or FAT32
+ * volume can be described by a single extent.
+ */
+EFI_STATUS fat_get_file_extent(const CHAR16 *label, const TCHAR *path,
+			       fat_extent_t *ext)
+{
+	FATSYSTEM *fs = &g_fatsystem;
+	EFI_STATUS ret;
+	FRESULT f_ret;
+	FIL fp;
+	DWORD linkmap[4];
+	UINT32 entsize, ncl;
+	UINT64 ssize;
+
+	ret = gpt_get_partition_by_label(label, &fs->parti, LOGICAL_UNIT_USER);
+	if (EFI_ERROR(ret)) {
+		efi_perror(ret, L"Failed to get partition %s", label);
+		return ret;
+	}
+	ret = fat_mount(fs);
+	if (EFI_ERROR(ret))
+		return ret;
+
+	if (fs->fatfs.fs_type != FS_FAT16 && fs->fatfs.fs_type != FS_FAT32)
+		return EFI_UNSUPPORTED;
+	entsize = fs->fatfs.fs_type == FS_FAT32 ? 4 : 2;
+
+	f_ret = f_open(&fp, path, FA_READ);
+	if (f_ret != FR_OK) {
+		debug(L"f_open %s err:%d", path, f_ret);
+		return EFI_NOT_FOUND;
+	}
+
+	ssize = fs->fatfs.ssize;
+	ZeroMem(ext, sizeof(*ext));
+	ext->starting_lba = fs->parti.part.starting_lba;
+	ext->size = f_size(&fp);
+	ext->dirent_offset = fp.dir_sect * ssize + (fp.dir_ptr - fs->fatfs.win);
+	/* The window is reused by the FAT walk below */
+	CopyMem(ext->dirent, fp.dir_ptr, sizeof(ext->dirent));
+
+	linkmap[0] = ARRAY_SIZE(linkmap);
+	fp.cltbl = linkmap;
+	f_ret = f_lseek(&fp, CREATE_LINKMAP);
+	f_close(&fp);
+	if (f_ret != FR_OK || ext->size == 0 || linkmap[1] == 0 ||
+	    linkmap[3] != 0) {
+		debug(L"%s is not contiguous", path);
+		return EFI_UNSUPPORTED;
+	}
+
+	ncl = linkmap[1];
+	ext->data_offset = (fs->fatfs.database +
+			    (UINT64)(linkmap[2] - 2) * fs->fatfs.csize) * ssize;
+	ext->fat_offset = fs->fatfs.fatbase * ssize + (UINT64)linkmap[2] * entsize;
+	ext->fat_len = ncl * entsize;
+
+	return fat_extent_crc(&fs->parti, ext, &ext->fat_crc);
+}
+
+/* Check that EXT still describes the same file on PARTI: the directory
+ * entry is unchanged and so is the FAT chain of its clusters.
+ */
+EFI_STATUS fat_check_file_extent(struct gpt_partition_interface *parti,
+				 fat_extent_t *ext)
+{
+	EFI_STATUS ret;
+	UINT8 dirent[FAT_DIRENT_SIZE];
+	UINT32 crc;
+	UINT64 part_len;
+
+	part_len = (parti->part.ending_lba + 1 - parti->part.starting_lba) *
+		parti->bio->Media->BlockSize;
+	if (ext->starting_lba != parti->part.starting_lba ||
+	    ext->fat_len == 0 || ext->fat_len > FAT_CACHE_SIZE ||
+	    ext->size > part_len || ext->data_offset > part_len - ext->size)
+		return EFI_INVALID_PARAMETER;
+
+	ret = uefi_call_wrapper(parti->dio->ReadDisk, 5, parti->dio,
+				parti->bio->Media->MediaId,
+				ext->starting_lba * parti->bio->Media->BlockSize +
+				ext->dirent_offset, sizeof(dirent), dirent);
+	if (EFI_ERROR(ret))
+		return ret;
+	if (CompareMem(dirent, ext->dirent, sizeof(dirent)))
+		return EFI_CRC_ERROR;
+
+	ret = fat_extent_crc(parti, ext, &crc);
+	if (EFI_ERROR(ret))
+		return ret;
+
+	return crc == ext->fat_crc ? EFI_SUCCESS : EFI_CRC_ERROR;
+}
+
 static TCHAR * fwuImage = L"/FwuImage.bin";
 EFI_STATUS flash_fwupdate(VOID *data, UINTN size)
 {
@@ -106,50 +344,50 @@ EFI_STATUS flash_fwupdate(VOID *data, UINTN size)
 		efi_perror(ret, L"Failed to get efi system partition");
 		return ret;
 	}
-	fs->bpb_offset = fs->parti.part.starting_lba*512;
-	ret = fat_readdisk(fs->bpb_offset,512,fs->fatfs.win);
-	if (EFI_ERROR(ret)) {
-		efi_perror(ret, L"Failed to get FAT BPB");
+	ret = fat_mount(fs);
+	if (EFI_ERROR(ret))
 		return ret;
-	}
-	fs->fatfs.pdrv = 4;
-	if(FR_OK != f_mount(&fs->fatfs,L"/",1)) {
-		debug(L"the file is not mount success");
-		return EFI_NOT_FOUND;
-	}
-	debug(L"f_mount success");
 	f_ret = f_open(&fp, fwuImage, FA_READ|FA_WRITE);
 	if( f_ret == FR_NO_FILE ) {
 		debug(L"%s file is not existing", fwuImage);
 		f_ret = f_open(&fp, fwuImage,FA_READ|FA_WRITE|FA_CREATE_NEW);
 		if (f_ret != 0) {
 			debug(L"f_create err:%d", f_ret);
-			return ret;
+			return fresult_to_efi_status(f_ret);
 		}
 	} else if( f_ret == 0 ) {
 		debug(L"open %s success", fwuImage);
+		/* Rewrite the existing clusters in place */
+		if (f_size(&fp) >= size)
+			fat_fastseek(&fp);
 	} else {
 		debug(L"f_open err:%d", f_ret);
-		return ret;
+		return fresult_to_efi_status(f_ret);
 	}
-	ret = f_write(&fp,data,size,&bsize);
-	if(ret != 0) {
-		debug(L"f_write error:%d", ret);
-		return ret;
+	f_ret = f_write(&fp,data,size,&bsize);
+	if(f_ret != 0) {
+		debug(L"f_write error:%d", f_ret);
+		return fresult_to_efi_status(f_ret);
 	}
-	debug(L"f_write OK:%d", ret);
+	debug(L"f_write OK:%d", f_ret);
 	if(size != bsize) {
 		debug(L"write %x is not equal %x",size,bsize);
 		return EFI_VOLUME_CORRUPTED;
 	}
 	debug(L"good size is same");
-	ret = f_close(&fp);
+	fp.cltbl = NULL;
+	f_ret = f_truncate(&fp);
+	if(f_ret != 0) {
+		debug(L"f_truncate error:%d", f_ret);
+		return fresult_to_efi_status(f_ret);
+	}
+	f_ret = f_close(&fp);
 
-	if(ret != 0) {
-		debug(L"f_close error:%d", ret);
-		return ret;
+	if(f_ret != 0) {
+		debug(L"f_close error:%d", f_ret);
+		return fresult_to_efi_status(f_ret);
 	}
-	return ret;
+	return EFI_SUCCESS;
 }
 EFI_STATUS fat_test()
 {
@@ -172,22 +410,13 @@ EFI_STATUS fat_test()
 	}else {
 		error(L"can not find Efi system partition");
 	}
-	fs->bpb_offset = fs->parti.part.starting_lba*512;
 	debug(L"starting_lba is %x",fs->parti.part.starting_lba);
-	debug(L"bpb_offset is %x",fs->bpb_offset);
-	ret = fat_readdisk(fs->bpb_offset,512,fs->fatfs.win);
-	if (EFI_ERROR(ret)) {
-		efi_perror(ret, L"Failed to get FAT BPB");
+	ret = fat_mount(fs);
+	if (EFI_ERROR(ret))
 		return ret;
-	}
+	debug(L"bpb_offset is %lx",fs->bpb_offset);
 	debug_hex(0,fs->fatfs.win,512);
-	fs->fatfs.pdrv = 4;
-	if(FR_OK != f_mount(&fs->fatfs,L"/",1)) {
-		debug(L"the file is not mount success");
-		return EFI_NOT_FOUND;
-	}
 
-	debug(L"f_mount success");
 	f_ret = f_open(&fp, L"/fat16.txt",FA_READ);
 	if (!f_ret) {
 		debug(L"open fat16.txt success");
@@ -209,7 +438,7 @@ EFI_STATUS fat_test()
 		f_ret = f_open(&fp, L"/austin.txt",FA_READ|FA_WRITE|FA_CREATE_NEW);
 		if (f_ret != 0) {
 			debug(L"f_create err:%d", f_ret);
-			return ret;
+			return fresult_to_efi_status(f_ret);
 		}
 	} else if( f_ret == 0 ) {
 		debug(L"open /austin.txt success");
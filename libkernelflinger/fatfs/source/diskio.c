@@ -67,17 +67,17 @@ DRESULT disk_read (
 		UINT count		/* Number of sectors to read */
 		)
 {
-	DRESULT ret = RES_OK;
-	UINT32 offset = 0;
-	offset += sector;
-	offset = offset * 512;
-	offset += fat_getbpb_offset();
+	UINT64 offset;
+	UINT32 ssize = fat_get_sector_size();
+
+	offset = (UINT64)sector * ssize + fat_getbpb_offset();
 	switch (pdrv) {
 		case DEV_NVME:
-			fat_readdisk(offset,count*512,buff);
-			return ret;
+			if (EFI_ERROR(fat_readdisk(offset, count * ssize, buff)))
+				return RES_ERROR;
+			return RES_OK;
 		default:
-			return ret;
+			return RES_PARERR;
 	}
 
 	return RES_PARERR;
@@ -98,15 +98,15 @@ DRESULT disk_write (
 		UINT count			/* Number of sectors to write */
 		)
 {
-	UINT32 offset = 0;
-	offset += sector;
-	offset = offset * 512;
-	offset += fat_getbpb_offset();
+	UINT64 offset;
+	UINT32 ssize = fat_get_sector_size();
 
+	offset = (UINT64)sector * ssize + fat_getbpb_offset();
 	switch (pdrv) {
 		case DEV_NVME:
-			fat_writedisk(offset,count*512,(void *)buff);
-			return 0x0;
+			if (EFI_ERROR(fat_writedisk(offset, count * ssize, (void *)buff)))
+				return RES_ERROR;
+			return RES_OK;
 		default:
 			return RES_PARERR;
 	}
@@ -128,14 +128,17 @@ DRESULT disk_ioctl (
 		void *buff		/* Buffer to send/receive control data */
 		)
 {
-	DRESULT ret = RES_OK;
-	/* just make sure pass compile*/
-	if (cmd != 0 || buff == NULL) {
-		return ret;
-	}
-	switch (pdrv) {
-		case DEV_NVME:
-			return ret;
+	if (pdrv != DEV_NVME)
+		return RES_PARERR;
+
+	switch (cmd) {
+		case CTRL_SYNC:
+			return RES_OK;
+		case GET_SECTOR_SIZE:
+			if (buff == NULL)
+				return RES_PARERR;
+			*(WORD *)buff = (WORD)fat_get_sector_size();
+			return RES_OK;
 	}
 
 	return RES_PARERR;
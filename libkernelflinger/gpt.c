@@ -87,6 +87,9 @@ struct gpt_disk {
 	EFI_HANDLE handle;
 	BOOLEAN label_prefix_removed;
 	logical_unit_t log_unit;
+	/* Entries CRC of the partition table the firmware partition
+	 * driver has been started on */
+	UINT32 installed_crc32;
 	struct gpt_header gpt_hd;
 	struct gpt_partition partitions[GPT_ENTRIES];
 };
@@ -251,6 +254,7 @@ static EFI_STATUS gpt_list_partition_on_disk(struct gpt_disk *disk)
 	if (EFI_ERROR(ret))
 		return ret;
 
+	disk->installed_crc32 = disk->gpt_hd.entries_crc32;
 	return EFI_SUCCESS;
 }
 
@@ -352,6 +356,71 @@ EFI_STATUS gpt_refresh(void)
 	return EFI_SUCCESS;
 }
 
+/* Reinstall the partition table in place: the partition driver is
+ * only restarted if the partitions have changed and the cache, which
+ * already holds the new table, is kept. */
+static EFI_STATUS gpt_reinstall(void)
+{
+	EFI_STATUS ret;
+
+	ret = gpt_sync();
+	if (EFI_ERROR(ret))
+		return ret;
+
+	if (pdisk->installed_crc32 == pdisk->gpt_hd.entries_crc32) {
+		debug(L"Partitions unchanged, keep the partition handles");
+		return EFI_SUCCESS;
+	}
+
+	ret = uefi_call_wrapper(BS->ReinstallProtocolInterface, 4, pdisk->handle, &BlockIoProtocol, pdisk->bio, pdisk->bio);
+	if (EFI_ERROR(ret)) {
+		efi_perror(ret, L"Failed to Reinstall block io interface on System disk");
+		return ret;
+	}
+
+	/* The disk io driver has been restarted along */
+	ret = uefi_call_wrapper(BS->HandleProtocol, 3, pdisk->handle, &DiskIoProtocol, (VOID *)&pdisk->dio);
+	if (EFI_ERROR(ret)) {
+		efi_perror(ret, L"Failed to get disk io protocol");
+		gpt_free_cache();
+		return ret;
+	}
+
+	pdisk->installed_crc32 = pdisk->gpt_hd.entries_crc32;
+	return EFI_SUCCESS;
+}
+
+EFI_STATUS gpt_refresh_partition(const CHAR16 *label, logical_unit_t log_unit)
+{
+	EFI_STATUS ret;
+	EFI_HANDLE handle;
+	EFI_BLOCK_IO *bio;
+
+	/* Virtual partitions do not have a handle of their own */
+	if (pdisk != &sdisk)
+		return gpt_refresh();
+
+	ret = gpt_sync();
+	if (EFI_ERROR(ret))
+		return ret;
+
+	ret = gpt_get_partition_handle(label, log_unit, &handle);
+	if (EFI_ERROR(ret))
+		return gpt_refresh();
+
+	ret = uefi_call_wrapper(BS->HandleProtocol, 3, handle, &BlockIoProtocol, (VOID *)&bio);
+	if (EFI_ERROR(ret)) {
+		efi_perror(ret, L"Failed to get block io protocol");
+		return ret;
+	}
+
+	ret = uefi_call_wrapper(BS->ReinstallProtocolInterface, 4, handle, &BlockIoProtocol, bio, bio);
+	if (EFI_ERROR(ret))
+		efi_perror(ret, L"Failed to Reinstall block io interface on %s", label);
+
+	return ret;
+}
+
 
 EFI_STATUS gpt_get_root_disk(struct gpt_partition_interface *gpart, logical_unit_t log_unit)
 {
@@ -712,61 +781,31 @@ static VOID gpt_fill_entries(UINTN part_count, struct gpt_bin_part *gbp, struct
 	}
 }
 
-static EFI_STATUS gpt_write_mbr(void)
+static void gpt_fill_mbr(struct mbr *mbr)
 {
-	struct mbr mbr;
-	EFI_STATUS ret;
-
-	/* Write protective MBR */
-	ZeroMem(&mbr, sizeof(mbr));
-	mbr.sig = 0xAA55;
-	mbr.entries[0].type = PROTECTIVE_MBR;
-	mbr.entries[0].first_lba = 1;
+	ZeroMem(mbr, sizeof(*mbr));
+	mbr->sig = 0xAA55;
+	mbr->entries[0].type = PROTECTIVE_MBR;
+	mbr->entries[0].first_lba = 1;
 	if (pdisk->bio->Media->LastBlock > 0xFFFFFFFFULL)
-		mbr.entries[0].lba_count = 0xFFFFFFFFULL;
+		mbr->entries[0].lba_count = 0xFFFFFFFFULL;
 	else
-		mbr.entries[0].lba_count = pdisk->bio->Media->LastBlock;
-
-	ret = uefi_call_wrapper(pdisk->dio->WriteDisk, 5, pdisk->dio, pdisk->bio->Media->MediaId,
-				pdisk->dio_offset + 440, sizeof(struct mbr), &mbr);
-	if (EFI_ERROR(ret))
-		error(L"Couldn't write MBR");
-
-	return ret;
-}
-
-static EFI_STATUS gpt_write_table_to_disk(struct gpt_header *gh)
-{
-	UINT64 entries_offset, header_offset, entries_size;
-	EFI_STATUS ret;
-
-	entries_size = ((UINT64)gh->number_of_entries) * gh->size_of_entry;
-	header_offset = gh->my_lba * pdisk->bio->Media->BlockSize;
-	entries_offset = gh->entries_lba * pdisk->bio->Media->BlockSize;
-
-	ret = uefi_call_wrapper(pdisk->dio->WriteDisk, 5, pdisk->dio, pdisk->bio->Media->MediaId,
-				pdisk->dio_offset + header_offset, sizeof(struct gpt_header), gh);
-	if (EFI_ERROR(ret)) {
-		error(L"Couldn't write GPT header");
-		return ret;
-	}
-
-	ret = uefi_call_wrapper(pdisk->dio->WriteDisk, 5, pdisk->dio, pdisk->bio->Media->MediaId,
-				pdisk->dio_offset + entries_offset, entries_size,
-				pdisk->partitions);
-	if (EFI_ERROR(ret))
-		error(L"Couldn't write GPT entries array");
-
-	return ret;
+		mbr->entries[0].lba_count = pdisk->bio->Media->LastBlock;
 }
 
+/* The primary table is written along with the protective MBR from
+ * the end of the MBR boot code up to the end of the entries array,
+ * the backup table from the start of its entries array up to the
+ * end of the disk, each of them in a single request. */
 static EFI_STATUS gpt_write_partition_tables(void)
 {
 	EFI_STATUS ret;
+	UINT32 block_size = pdisk->bio->Media->BlockSize;
 	UINT64 entries_size;
-	struct gpt_header *gh;
-	struct gpt_header *gh_backup;
+	struct gpt_header *gh, gh_backup;
 	UINT32 crc;
+	UINT8 *buf, *p;
+	UINTN buf_size, size;
 
 	gh = &pdisk->gpt_hd;
 
@@ -785,45 +824,56 @@ static EFI_STATUS gpt_write_partition_tables(void)
 	if (EFI_ERROR(ret))
 		return ret;
 
-	debug(L"Write first GPT Header at %d", gh->my_lba);
-	ret = gpt_write_table_to_disk(gh);
-	if (EFI_ERROR(ret)) {
-		efi_perror(ret, L"Failed to write primary GPT header");
+	CopyMem(&gh_backup, gh, sizeof(gh_backup));
+	gh_backup.my_lba = gh->alternate_lba;//no mbr here
+	gh_backup.alternate_lba = gh->my_lba;
+	gh_backup.entries_lba = gh_backup.my_lba - entries_size / block_size;
+
+	ret = set_header_crc32(&gh_backup);
+	if (EFI_ERROR(ret))
 		return ret;
-	}
 
-	gh_backup = AllocatePool(sizeof(struct gpt_header));
-	if (!gh_backup) {
-		error(L"Cannot allocate alternate GPT header");
+	buf_size = block_size - MBR_CODE_SIZE + block_size + entries_size;
+	buf = AllocatePool(buf_size);
+	if (!buf) {
+		error(L"Cannot allocate the GPT write buffer");
 		return EFI_OUT_OF_RESOURCES;
 	}
 
-	CopyMem(gh_backup, gh, sizeof(struct gpt_header));
+	debug(L"Write protective MBR and first GPT Header at %d", gh->my_lba);
+	ZeroMem(buf, buf_size);
+	gpt_fill_mbr((struct mbr *)buf);
+	p = buf + block_size - MBR_CODE_SIZE;
+	CopyMem(p, gh, sizeof(*gh));
+	CopyMem(p + block_size, pdisk->partitions, entries_size);
 
-	gh_backup->my_lba = gh->alternate_lba;//no mbr here
-	gh_backup->alternate_lba = gh->my_lba;
-	gh_backup->entries_lba = gh_backup->my_lba - entries_size / pdisk->bio->Media->BlockSize;
+	ret = uefi_call_wrapper(pdisk->dio->WriteDisk, 5, pdisk->dio, pdisk->bio->Media->MediaId,
+				pdisk->dio_offset + MBR_CODE_SIZE, buf_size, buf);
+	if (EFI_ERROR(ret)) {
+		efi_perror(ret, L"Failed to write primary GPT header");
+		goto out;
+	}
 
-	ret = set_header_crc32(gh_backup);
-	if (EFI_ERROR(ret))
-		return ret;
+	debug(L"Write alternate GPT Header at %d", gh_backup.my_lba);
+	size = entries_size + block_size;
+	ZeroMem(buf, size);
+	CopyMem(buf, pdisk->partitions, entries_size);
+	CopyMem(buf + entries_size, &gh_backup, sizeof(gh_backup));
 
-	debug(L"Write alternate GPT Header at %d", gh_backup->my_lba);
-	ret = gpt_write_table_to_disk(gh_backup);
-	FreePool(gh_backup);
+	ret = uefi_call_wrapper(pdisk->dio->WriteDisk, 5, pdisk->dio, pdisk->bio->Media->MediaId,
+				pdisk->dio_offset + gh_backup.entries_lba * block_size,
+				size, buf);
 	if (EFI_ERROR(ret)) {
 		efi_perror(ret, L"Failed to write alternate GPT header");
-		return ret;
+		goto out;
 	}
-	debug(L"Write protective MBR");
-	ret = gpt_write_mbr();
-	if (EFI_ERROR(ret))
-		return ret;
 
 	if(pdisk == &sdisk)
-		return gpt_refresh();
+		ret = gpt_reinstall();
 
-	return EFI_SUCCESS;
+out:
+	FreePool(buf);
+	return ret;
 }
 
 EFI_STATUS gpt_create(struct gpt_header *gh, UINTN gh_size,
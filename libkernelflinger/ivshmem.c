@@ -438,36 +438,192 @@ void ivshmem_rot_interrupt(void)
 
 #define NOT_READY_MAGIC 0x12ABCDEF
 
-void ivshmem_rollback_index_interrupt(struct tpm2_int_req* req)
+/* The host completion is polled with pause back-off, starting at one
+ * microsecond and doubling up to IVSHMEM_POLL_MAX_US, and given up
+ * after IVSHMEM_TIMEOUT_US. */
+#define IVSHMEM_POLL_MAX_US	100
+#define IVSHMEM_TIMEOUT_US	(5 * 1000 * 1000)
+
+#define QUEUE_ENTRY_SIZE(req) \
+	((sizeof(*(req)) + (req)->size + IVSHMEM_QUEUE_ALIGN - 1) & \
+	 ~(IVSHMEM_QUEUE_ALIGN - 1))
+
+static ivshmem_peer_t *ivshmem_peer;
+
+void ivshmem_attach(ivshmem_peer_t *peer)
 {
-	if (NULL == req)
-		return;
+	ivshmem_peer = peer;
+}
 
-	if (0 == g_ivshmem_rot_addr) {
-		debug(L"Error! ivshmem is not initialized.");
+void ivshmem_detach(void)
+{
+	ivshmem_peer = NULL;
+}
+
+static void *rollback_index_page(void)
+{
+	if (ivshmem_peer)
+		return ivshmem_peer->page;
+
+	if (0 == g_ivshmem_rot_addr)
+		return NULL;
+
+	//offset 1 page reserved for rot.
+	return (void *)(g_ivshmem_rot_addr + 0x1000);
+}
+
+static void ring_doorbell(UINT32 vector)
+{
+	if (ivshmem_peer) {
+		ivshmem_peer->doorbell(vector);
 		return;
 	}
 
-	//offset 1 page reserved for rot.
-	UINT64 rollback_index_addr = g_ivshmem_rot_addr + 0x1000;
-	struct tpm2_int_req * p_req = (struct tpm2_int_req *)rollback_index_addr;
+	io_write_32((void *)((UINT64)(g_ivshmem_dev.bar0_addr + DOORBELL_OFF)), vector);
+}
 
-	req->ret = NOT_READY_MAGIC;
+static BOOLEAN request_done(void *ctx)
+{
+	return ((struct tpm2_int_req *)ctx)->ret != NOT_READY_MAGIC;
+}
+
+static BOOLEAN queue_done(void *ctx)
+{
+	struct ivshmem_queue *queue = ctx;
+
+	return queue->done == queue->seq;
+}
+
+static EFI_STATUS wait_for_host(BOOLEAN (*done)(void *ctx), void *ctx)
+{
+	UINTN delay = 1, waited = 0;
+
+	while (!done(ctx)) {
+		if (waited >= IVSHMEM_TIMEOUT_US)
+			return EFI_TIMEOUT;
+		pause_us(delay);
+		waited += delay;
+		delay = min(delay * 2, (UINTN)IVSHMEM_POLL_MAX_US);
+	}
+	rmb();
+
+	return EFI_SUCCESS;
+}
+
+BOOLEAN ivshmem_batch_supported(void)
+{
+	struct ivshmem_queue *queue = rollback_index_page();
+
+	return queue && queue->magic == IVSHMEM_QUEUE_MAGIC;
+}
+
+static EFI_STATUS send_request(struct tpm2_int_req *p_req, struct tpm2_int_req *req)
+{
+	EFI_STATUS ret;
 	UINT32 req_size = sizeof(struct tpm2_int_req) + req->size;
-	if (req_size > 0x1000) {
+
+	if (req_size > IVSHMEM_QUEUE_SIZE) {
 		info(L"req size is too large(0x%X), abort...", req_size);
-		return;
+		return EFI_BUFFER_TOO_SMALL;
 	}
+
+	req->ret = NOT_READY_MAGIC;
 	memcpy(p_req, req, req_size);
 
-	io_write_32((void *)((UINT64)(g_ivshmem_dev.bar0_addr + DOORBELL_OFF)), ROLLBACK_INDEX_INTERRUPT);
+	ring_doorbell(ROLLBACK_INDEX_INTERRUPT);
 
-	while (NOT_READY_MAGIC == p_req->ret) {
-		//just wait for int handler return
+	ret = wait_for_host(request_done, p_req);
+	if (EFI_ERROR(ret)) {
+		efi_perror(ret, L"ivshmem request 0x%x not handled", req->cmd);
+		return ret;
 	}
 
 	memcpy(req, p_req, req_size);
 
-	return;
+	return EFI_SUCCESS;
+}
+
+/* Copy as many requests as fit in the queue, starting at reqs[0],
+ * ring the doorbell once and copy the results back.  Returns the
+ * number of requests handled in *handled. */
+static EFI_STATUS send_queue(struct ivshmem_queue *queue,
+			     struct tpm2_int_req **reqs, UINTN count,
+			     UINTN *handled)
+{
+	EFI_STATUS ret;
+	UINTN i, n, offset;
+
+	for (n = 0, offset = 0; n < count; n++) {
+		if (sizeof(*queue) + offset + QUEUE_ENTRY_SIZE(reqs[n]) > IVSHMEM_QUEUE_SIZE)
+			break;
+		reqs[n]->ret = NOT_READY_MAGIC;
+		memcpy(queue->reqs + offset, reqs[n], sizeof(*reqs[n]) + reqs[n]->size);
+		offset += QUEUE_ENTRY_SIZE(reqs[n]);
+	}
+	if (n == 0) {
+		info(L"req size is too large(0x%X), abort...",
+		     (UINT32)(sizeof(*reqs[0]) + reqs[0]->size));
+		return EFI_BUFFER_TOO_SMALL;
+	}
+
+	queue->count = n;
+	wmb();
+	queue->seq++;
+	ring_doorbell(IVSHMEM_BATCH_INTERRUPT);
+
+	ret = wait_for_host(queue_done, queue);
+	if (EFI_ERROR(ret)) {
+		efi_perror(ret, L"ivshmem batch of %d requests not handled", n);
+		return ret;
+	}
+
+	for (i = 0, offset = 0; i < n; i++) {
+		memcpy(reqs[i], queue->reqs + offset, sizeof(*reqs[i]) + reqs[i]->size);
+		offset += QUEUE_ENTRY_SIZE(reqs[i]);
+	}
+
+	*handled = n;
+	return EFI_SUCCESS;
 }
 
+EFI_STATUS ivshmem_rollback_index_batch(struct tpm2_int_req **reqs, UINTN count)
+{
+	struct ivshmem_queue *queue;
+	EFI_STATUS ret;
+	UINTN i, n;
+
+	if (!reqs)
+		return EFI_INVALID_PARAMETER;
+
+	queue = rollback_index_page();
+	if (!queue) {
+		debug(L"Error! ivshmem is not initialized.");
+		return EFI_NOT_FOUND;
+	}
+
+	/* Hosts without a request queue take one request per doorbell */
+	if (queue->magic != IVSHMEM_QUEUE_MAGIC) {
+		for (i = 0; i < count; i++) {
+			ret = send_request((struct tpm2_int_req *)queue, reqs[i]);
+			if (EFI_ERROR(ret))
+				return ret;
+		}
+		return EFI_SUCCESS;
+	}
+
+	for (i = 0; i < count; i += n) {
+		ret = send_queue(queue, reqs + i, count - i, &n);
+		if (EFI_ERROR(ret))
+			return ret;
+	}
+
+	return EFI_SUCCESS;
+}
+
+EFI_STATUS ivshmem_rollback_index_interrupt(struct tpm2_int_req* req)
+{
+	if (NULL == req)
+		return EFI_INVALID_PARAMETER;
+
+	return ivshmem_rollback_index_batch(&req, 1);
+}
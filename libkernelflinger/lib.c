@@ -69,6 +69,7 @@
 #include "lib.h"
 #include "timer.h"
 #include "vars.h"
+#include "slot.h"
 
 
 EFI_HANDLE g_parent_image;
@@ -1326,6 +1327,7 @@ VOID pause_us(UINTN microseconds)
 
 VOID halt_system(VOID)
 {
+        slot_commit();
         uefi_call_wrapper(RT->ResetSystem, 4, EfiResetShutdown, EFI_SUCCESS,
                           0, NULL);
         error(L"Failed to halt the device ... looping forever");
@@ -1337,6 +1339,8 @@ VOID reboot(CHAR16 *target, EFI_RESET_TYPE type)
 {
         EFI_STATUS ret;
 
+        slot_commit();
+
         if (target) {
                 ret = set_efi_variable_str(&loader_guid, LOADER_ENTRY_ONESHOT,
                                            TRUE, TRUE, target);
@@ -49,8 +49,21 @@ static EMMC_DEVICE_PATH *get_emmc_device_path(EFI_DEVICE_PATH *p)
 	return NULL;
 }
 
-static EFI_STATUS get_mmc_info(EFI_SD_HOST_IO_PROTOCOL *sdio,
-			       UINTN *erase_grp_size, UINTN *timeout)
+/* EXT_CSD SEC_FEATURE_SUPPORT bit indicating TRIM support */
+#define SEC_GB_CL_EN		(1 << 4)
+/* EXT_CSD_REV of eMMC 4.5 which introduced DISCARD */
+#define EXT_CSD_REV_1_6		6
+
+struct mmc_info {
+	UINTN erase_grp_size;	/* in sectors */
+	UINTN erase_timeout;	/* in ms per erase group */
+	UINTN trim_timeout;	/* in ms per erase group */
+	BOOLEAN trim;
+	BOOLEAN discard;
+	BOOLEAN erased_zero;
+};
+
+static EFI_STATUS get_mmc_info(EFI_SD_HOST_IO_PROTOCOL *sdio, struct mmc_info *info)
 {
 	EXT_CSD *ext_csd;
 	void *rawbuffer;
@@ -73,11 +86,15 @@ static EFI_STATUS get_mmc_info(EFI_SD_HOST_IO_PROTOCOL *sdio,
 	/* Erase group size is 512Kbyte × HC_ERASE_GRP_SIZE so it's
 	 * 1024 x HC_ERASE_GRP_SIZE in sector count timeout is 300ms x
 	 * ERASE_TIMEOUT_MULT per erase group*/
-	*erase_grp_size = 1024 * ext_csd->HC_ERASE_GRP_SIZE;
-	*timeout = 300 * ext_csd->ERASE_TIMEOUT_MULT;
+	info->erase_grp_size = 1024 * ext_csd->HC_ERASE_GRP_SIZE;
+	info->erase_timeout = 300 * ext_csd->ERASE_TIMEOUT_MULT;
+	info->trim_timeout = 300 * ext_csd->TRIM_MULT;
+	info->trim = (ext_csd->SEC_FEATURE_SUPPORT & SEC_GB_CL_EN) != 0;
+	info->discard = info->trim && ext_csd->EXT_CSD_REV >= EXT_CSD_REV_1_6;
+	info->erased_zero = ext_csd->ERASED_MEM_CONT == 0;
 
 	debug(L"eMMC parameter: erase grp size %d sectors, timeout %d ms",
-	      *erase_grp_size, *timeout);
+	      info->erase_grp_size, info->erase_timeout);
 
 out:
 	FreePool(rawbuffer);
@@ -144,14 +161,12 @@ static BOOLEAN is_emmc(EFI_DEVICE_PATH *p)
 	return EFI_ERROR(ret) || type == MMCCard;
 }
 
-static EFI_STATUS mmc_erase_blocks(EFI_HANDLE handle, EFI_BLOCK_IO *bio,
-				   EFI_LBA start, EFI_LBA end)
+static EFI_STATUS mmc_get_sdio_info(EFI_HANDLE handle, EFI_SD_HOST_IO_PROTOCOL **sdio,
+				    struct mmc_info *info)
 {
 	EFI_STATUS ret;
-	EFI_SD_HOST_IO_PROTOCOL *sdio;
 	EFI_HANDLE sdio_handle = NULL;
 	EFI_DEVICE_PATH *dev_path;
-	UINTN erase_grp_size = 0, timeout = 0;
 
 	dev_path = DevicePathFromHandle(handle);
 	if (!dev_path) {
@@ -159,55 +174,85 @@ static EFI_STATUS mmc_erase_blocks(EFI_HANDLE handle, EFI_BLOCK_IO *bio,
 		return EFI_UNSUPPORTED;
 	}
 
-	ret = sdio_get(dev_path, &sdio_handle, &sdio);
+	ret = sdio_get(dev_path, &sdio_handle, sdio);
 	if (EFI_ERROR(ret)) {
 		efi_perror(ret, L"Failed to get SDIO protocol");
 		return ret;
 	}
 
-	ret = get_mmc_info(sdio, &erase_grp_size, &timeout);
-	if (EFI_ERROR(ret)) {
+	ret = get_mmc_info(*sdio, info);
+	if (EFI_ERROR(ret))
 		efi_perror(ret, L"Failed to get erase group size");
+
+	return ret;
+}
+
+static EFI_STATUS mmc_erase_blocks(EFI_HANDLE handle, EFI_BLOCK_IO *bio,
+				   EFI_LBA start, EFI_LBA end)
+{
+	EFI_STATUS ret;
+	EFI_SD_HOST_IO_PROTOCOL *sdio;
+	struct mmc_info info;
+
+	ret = mmc_get_sdio_info(handle, &sdio, &info);
+	if (EFI_ERROR(ret))
 		return ret;
-	}
 
 	return sdio_erase(sdio, bio, start, end,
-			  CARD_ADDRESS, erase_grp_size, timeout, TRUE);
+			  CARD_ADDRESS, info.erase_grp_size, info.erase_timeout, TRUE);
 }
 
-static EFI_STATUS mmc_get_erase_block_size(EFI_HANDLE handle, UINTN *erase_blk_size)
+static EFI_STATUS mmc_discard_blocks(EFI_HANDLE handle, __attribute__((unused)) EFI_BLOCK_IO *bio,
+				     EFI_LBA start, EFI_LBA end, BOOLEAN *zeroed)
 {
 	EFI_STATUS ret;
 	EFI_SD_HOST_IO_PROTOCOL *sdio;
-	EFI_HANDLE sdio_handle = NULL;
-	EFI_DEVICE_PATH *dev_path;
-	UINTN erase_grp_size = 0, timeout = 0;
+	struct mmc_info info;
+	UINTN timeout;
+	UINT32 arg;
 
-	dev_path = DevicePathFromHandle(handle);
-	if (!dev_path) {
-		error(L"Failed to get device path");
+	ret = mmc_get_sdio_info(handle, &sdio, &info);
+	if (EFI_ERROR(ret))
+		return ret == EFI_NOT_FOUND ? EFI_UNSUPPORTED : ret;
+
+	if (!info.trim || !info.erase_grp_size)
 		return EFI_UNSUPPORTED;
-	}
 
-	ret = sdio_get(dev_path, &sdio_handle, &sdio);
-	if (EFI_ERROR(ret)) {
-		efi_perror(ret, L"Failed to get SDIO protocol");
+	/* TRIM leaves the blocks in the erased state which reads back
+	 * as zero on most parts.  Otherwise DISCARD is cheaper and the
+	 * content is undetermined anyway. */
+	if (info.erased_zero || !info.discard)
+		arg = SDIO_ERASE_ARG_TRIM;
+	else
+		arg = SDIO_ERASE_ARG_DISCARD;
+
+	timeout = info.trim_timeout * (end / info.erase_grp_size - start / info.erase_grp_size + 1);
+	ret = sdio_discard(sdio, start, end, CARD_ADDRESS, timeout, arg);
+	if (EFI_ERROR(ret))
 		return ret;
-	}
 
-	ret = get_mmc_info(sdio, &erase_grp_size, &timeout);
-	if (EFI_ERROR(ret)) {
-		efi_perror(ret, L"Failed to get erase group size");
+	*zeroed = arg == SDIO_ERASE_ARG_TRIM && info.erased_zero;
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS mmc_get_erase_block_size(EFI_HANDLE handle, UINTN *erase_blk_size)
+{
+	EFI_STATUS ret;
+	EFI_SD_HOST_IO_PROTOCOL *sdio;
+	struct mmc_info info;
+
+	ret = mmc_get_sdio_info(handle, &sdio, &info);
+	if (EFI_ERROR(ret))
 		return ret;
-	}
 
-	*erase_blk_size = erase_grp_size;
+	*erase_blk_size = info.erase_grp_size;
 
 	return EFI_SUCCESS;
 }
 
 struct storage STORAGE(STORAGE_EMMC) = {
 	.erase_blocks = mmc_erase_blocks,
+	.discard_blocks = mmc_discard_blocks,
 	.check_logical_unit = mmc_check_logical_unit,
 	.get_erase_block_size = mmc_get_erase_block_size,
 	.probe = is_emmc,
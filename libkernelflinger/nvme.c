@@ -41,10 +41,13 @@
 #define NVME_GENERIC_TIMEOUT                  (EFI_TIMER_PERIOD_SECONDS(5))
 #define NVME_MAX_WRITE_ZEROS_BLOCKS           0x10000
 
+#define NVME_CTRL_ONCS_DSM                    (1 << 2)
 #define NVME_CTRL_ONCS_WRITE_ZEROES           (1 << 3)
 
 #define NVME_RW_FUA               (1 << 14)
 #define NVME_CMD_WRITE_ZEROS      0x08
+#define NVME_CMD_DSM              0x09
+#define NVME_DSM_ATTR_DEALLOCATE  (1 << 2)
 #define NVME_CONTROLLER_ID        0
 
 #define MSG_NVME_NAMESPACE_DP     0x17
@@ -57,6 +60,13 @@ typedef struct {
 	UINT64                          NamespaceUuid;
 } NVME_NAMESPACE_DEVICE_PATH;
 
+/* Dataset Management range, see NVM Express 1.3 Figure 207 */
+typedef struct {
+	UINT32                          ContextAttributes;
+	UINT32                          Length;
+	UINT64                          StartingLba;
+} __attribute__((packed)) NVME_DSM_RANGE;
+
 
 EFI_STATUS get_nvme_passthru(EFI_DEVICE_PATH *FilePath, VOID **Interface)
 {
@@ -87,14 +97,12 @@ static NVME_NAMESPACE_DEVICE_PATH *get_nvme_device_path(EFI_DEVICE_PATH *p)
 	return NULL;
 }
 
-static BOOLEAN is_nvme_supported_write_zeros(EFI_NVM_EXPRESS_PASS_THRU_PROTOCOL *NvmePassthru)
+static EFI_STATUS nvme_identify(EFI_NVM_EXPRESS_PASS_THRU_PROTOCOL *NvmePassthru,
+				UINT32 NamespaceId, VOID *Data, UINT32 DataLength)
 {
-	NVME_ADMIN_CONTROLLER_DATA CtrlData;
-
 	EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET CommandPacket;
 	EFI_NVM_EXPRESS_COMMAND                  Command;
 	EFI_NVM_EXPRESS_COMPLETION               Completion;
-	EFI_STATUS                               Status;
 
 	ZeroMem(&CommandPacket, sizeof(EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET));
 	ZeroMem(&Command, sizeof(EFI_NVM_EXPRESS_COMMAND));
@@ -105,27 +113,37 @@ static BOOLEAN is_nvme_supported_write_zeros(EFI_NVM_EXPRESS_PASS_THRU_PROTOCOL
 	/* According to Nvm Express 1.1 spec Figure 38, When not used, the field shall be cleared to 0h.
 	 * For the Identify command, the Namespace Identifier is only used for the Namespace data structure.
 	 */
-	Command.Nsid        = 0;
+	Command.Nsid        = NamespaceId;
 
 	CommandPacket.NvmeCmd        = &Command;
 	CommandPacket.NvmeCompletion = &Completion;
-	CommandPacket.TransferBuffer = (VOID *) &CtrlData;
-	CommandPacket.TransferLength = sizeof(NVME_ADMIN_CONTROLLER_DATA);
+	CommandPacket.TransferBuffer = Data;
+	CommandPacket.TransferLength = DataLength;
 	CommandPacket.CommandTimeout = NVME_GENERIC_TIMEOUT;
 	CommandPacket.QueueType      = NVME_ADMIN_QUEUE;
 
-	/* Set bit 0 (Cns bit) to 1 to identify a controller */
-	Command.Cdw10                = 1;
+	/* Cns bit set to 1 identifies the controller, cleared to 0 the namespace */
+	Command.Cdw10                = NamespaceId == 0 ? 1 : 0;
 	Command.Flags                = CDW10_VALID;
 
-	Status = NvmePassthru->PassThru(NvmePassthru, NVME_CONTROLLER_ID, &CommandPacket, NULL);
+	return NvmePassthru->PassThru(NvmePassthru, NVME_CONTROLLER_ID, &CommandPacket, NULL);
+}
+
+static UINT16 nvme_get_oncs(EFI_NVM_EXPRESS_PASS_THRU_PROTOCOL *NvmePassthru)
+{
+	NVME_ADMIN_CONTROLLER_DATA CtrlData;
+	EFI_STATUS                 Status;
+
+	Status = nvme_identify(NvmePassthru, 0, &CtrlData, sizeof(CtrlData));
 	if (EFI_ERROR(Status))
-		return FALSE;
+		return 0;
 
-	if (CtrlData.Oncs & NVME_CTRL_ONCS_WRITE_ZEROES)
-		return TRUE;
+	return CtrlData.Oncs;
+}
 
-	return FALSE;
+static BOOLEAN is_nvme_supported_write_zeros(EFI_NVM_EXPRESS_PASS_THRU_PROTOCOL *NvmePassthru)
+{
+	return (nvme_get_oncs(NvmePassthru) & NVME_CTRL_ONCS_WRITE_ZEROES) != 0;
 }
 
 EFI_STATUS nvme_erase_blocks_impl(
@@ -230,6 +248,142 @@ static EFI_STATUS nvme_erase_blocks(
 	return ret;
 }
 
+/* The controller and namespace capabilities do not change during the
+ * life of kernelflinger, they are looked up on the first discard and
+ * reused for the following slices.
+ */
+static struct {
+	EFI_NVM_EXPRESS_PASS_THRU_PROTOCOL *passthru;
+	UINT32 nsid;
+	BOOLEAN dsm;
+	BOOLEAN read_zeroes;
+} nvme_discard_info;
+
+static EFI_STATUS nvme_get_discard_info(EFI_HANDLE handle)
+{
+	EFI_NVM_EXPRESS_PASS_THRU_PROTOCOL *NvmePassthru;
+	NVME_NAMESPACE_DEVICE_PATH *nvme_dp;
+	NVME_ADMIN_NAMESPACE_DATA *NsData;
+	EFI_DEVICE_PATH *dp;
+	EFI_STATUS ret;
+	UINT32 NamespaceId = 0;
+
+	dp = DevicePathFromHandle(handle);
+	if (!dp) {
+		error(L"Failed to get device path from handle");
+		return EFI_INVALID_PARAMETER;
+	}
+
+	ret = get_nvme_passthru(dp, (VOID **) &NvmePassthru);
+	if (EFI_ERROR(ret))
+		return ret;
+
+	nvme_dp = get_nvme_device_path(dp);
+	ret = NvmePassthru->GetNamespace(NvmePassthru, (EFI_DEVICE_PATH_PROTOCOL *)nvme_dp, &NamespaceId);
+	if (EFI_ERROR(ret)) {
+		efi_perror(ret, L"Failed to get NVMe namespace");
+		return ret;
+	}
+
+	if (nvme_discard_info.passthru == NvmePassthru && nvme_discard_info.nsid == NamespaceId)
+		return EFI_SUCCESS;
+
+	nvme_discard_info.passthru = NvmePassthru;
+	nvme_discard_info.nsid = NamespaceId;
+	nvme_discard_info.dsm = (nvme_get_oncs(NvmePassthru) & NVME_CTRL_ONCS_DSM) != 0;
+	nvme_discard_info.read_zeroes = FALSE;
+
+	NsData = AllocateZeroPool(sizeof(*NsData));
+	if (!NsData)
+		return EFI_OUT_OF_RESOURCES;
+
+	ret = nvme_identify(NvmePassthru, NamespaceId, NsData, sizeof(*NsData));
+	if (!EFI_ERROR(ret))
+		nvme_discard_info.read_zeroes =
+			(NsData->Dlfeat & DLFEAT_READ_MASK) == DLFEAT_READ_ZEROES;
+	FreePool(NsData);
+
+	debug(L"NVMe namespace %d: DSM %a, deallocated blocks read %a", NamespaceId,
+	      nvme_discard_info.dsm ? "supported" : "unsupported",
+	      nvme_discard_info.read_zeroes ? "zeroes" : "undefined");
+
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS nvme_discard_blocks(
+	EFI_HANDLE handle,
+	ATTR_UNUSED EFI_BLOCK_IO *bio,
+	EFI_LBA start,
+	EFI_LBA end,
+	BOOLEAN *zeroed
+)
+{
+	EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET CommandPacket;
+	EFI_NVM_EXPRESS_COMMAND                  Command;
+	EFI_NVM_EXPRESS_COMPLETION               Completion;
+	EFI_NVM_EXPRESS_PASS_THRU_PROTOCOL       *NvmePassthru;
+	NVME_DSM_RANGE                           *range;
+	VOID                                     *buf;
+	EFI_STATUS                               ret;
+
+	/* Deallocated ranges are described by 32 bits lengths */
+	if (end - start + 1 > 0xFFFFFFFF)
+		return EFI_INVALID_PARAMETER;
+
+	ret = nvme_get_discard_info(handle);
+	if (EFI_ERROR(ret))
+		return ret;
+
+	if (!nvme_discard_info.dsm)
+		return EFI_UNSUPPORTED;
+
+	NvmePassthru = nvme_discard_info.passthru;
+	ret = alloc_aligned(&buf, (VOID **)&range, sizeof(*range),
+			    NvmePassthru->Mode->IoAlign);
+	if (EFI_ERROR(ret))
+		return ret;
+
+	ZeroMem(range, sizeof(*range));
+	range->Length = end - start + 1;
+	range->StartingLba = start;
+
+	ZeroMem(&CommandPacket, sizeof(EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET));
+	ZeroMem(&Command, sizeof(EFI_NVM_EXPRESS_COMMAND));
+	ZeroMem(&Completion, sizeof(EFI_NVM_EXPRESS_COMPLETION));
+
+	CommandPacket.NvmeCmd        = &Command;
+	CommandPacket.NvmeCompletion = &Completion;
+	CommandPacket.TransferBuffer = range;
+	CommandPacket.TransferLength = sizeof(*range);
+	CommandPacket.CommandTimeout = NVME_GENERIC_TIMEOUT;
+	CommandPacket.QueueType      = NVME_IO_QUEUE;
+
+	Command.Cdw0.Opcode = NVME_CMD_DSM;
+	Command.Nsid        = nvme_discard_info.nsid;
+	/* Number of ranges is a 0's based value */
+	Command.Cdw10       = 0;
+	Command.Cdw11       = NVME_DSM_ATTR_DEALLOCATE;
+	Command.Flags       = CDW10_VALID | CDW11_VALID;
+
+	ret = NvmePassthru->PassThru(NvmePassthru, nvme_discard_info.nsid, &CommandPacket, NULL);
+	FreePool(buf);
+	if (EFI_ERROR(ret)) {
+		efi_perror(ret, L"NvmePassthru(NVME_CMD_DSM) failed");
+		return ret;
+	}
+
+	*zeroed = nvme_discard_info.read_zeroes;
+	return EFI_SUCCESS;
+}
+
+static BOOLEAN nvme_discard_zeroes(EFI_HANDLE handle, ATTR_UNUSED EFI_BLOCK_IO *bio)
+{
+	if (EFI_ERROR(nvme_get_discard_info(handle)))
+		return FALSE;
+
+	return nvme_discard_info.dsm && nvme_discard_info.read_zeroes;
+}
+
 static EFI_STATUS nvme_check_logical_unit(ATTR_UNUSED EFI_DEVICE_PATH *p, logical_unit_t log_unit)
 {
 	return log_unit == LOGICAL_UNIT_USER ? EFI_SUCCESS : EFI_UNSUPPORTED;
@@ -242,6 +396,8 @@ static BOOLEAN is_nvme(EFI_DEVICE_PATH *p)
 
 struct storage STORAGE(STORAGE_NVME) = {
 	.erase_blocks = nvme_erase_blocks,
+	.discard_blocks = nvme_discard_blocks,
+	.discard_zeroes = nvme_discard_zeroes,
 	.check_logical_unit = nvme_check_logical_unit,
 	.probe = is_nvme,
 	.name = L"NVME"
@@ -40,12 +40,157 @@ enum vartype {
 	VAR_TYPE_BLOB
 };
 
+/* A variable parsed from the oemvars file, written once the whole
+ * file has been parsed. */
+typedef struct oemvar {
+	EFI_GUID guid;
+	CHAR16 *name;
+	UINT32 hash;
+	uint32_t attributes;
+	UINTN size;
+	VOID *data;
+} oemvar_t;
+
 typedef struct oemvars_ctx {
 	EFI_GUID guid;
 	const EFI_GUID *restricted_guid;
 	BOOLEAN silent_write_error;
+	oemvar_t *vars;
+	UINTN nb_vars;
+	UINTN max_vars;
 } oemvars_ctx_t;
 
+#define OEMVARS_MIN_STAGED	32
+
+static UINT32 oemvar_hash(const CHAR16 *name)
+{
+	UINT32 hash = 2166136261U;
+
+	while (*name) {
+		hash ^= *name++;
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+static void free_oemvar(oemvar_t *var)
+{
+	FreePool(var->name);
+	if (var->data)
+		FreePool(var->data);
+}
+
+/* Stage the NAME variable, which is owned by the staging area from
+ * now on.  The writes are staged in file order.  A staged write which
+ * is overwritten by a later definition of the same variable with the
+ * same attributes is dropped.  A delete, or a write with other
+ * attributes, is kept: the firmware rejects a change of attributes
+ * unless the variable has been deleted first. */
+static EFI_STATUS stage_oemvar(oemvars_ctx_t *ctx, CHAR16 *name,
+			       uint32_t attributes, char *val, UINTN vallen)
+{
+	oemvar_t *var, *vars;
+	UINT32 hash = oemvar_hash(name);
+	VOID *data = NULL;
+	UINTN i, max_vars;
+
+	if (vallen) {
+		data = AllocatePool(vallen);
+		if (!data)
+			goto err;
+		memcpy(data, val, vallen);
+	}
+
+	for (i = ctx->nb_vars; i > 0; i--) {
+		var = &ctx->vars[i - 1];
+		if (var->hash != hash ||
+		    memcmp(&var->guid, &ctx->guid, sizeof(ctx->guid)) ||
+		    StrCmp(var->name, name))
+			continue;
+
+		if (var->attributes != attributes || var->size == 0) {
+			debug(L"oemvar %s is defined again, writing both in order", name);
+			break;
+		}
+
+		debug(L"oemvar %s is defined again, dropping the previous value", name);
+		free_oemvar(var);
+		memmove(var, var + 1, (ctx->nb_vars - i) * sizeof(*var));
+		ctx->nb_vars--;
+		break;
+	}
+
+	if (ctx->nb_vars == ctx->max_vars) {
+		max_vars = ctx->max_vars ? ctx->max_vars * 2 : OEMVARS_MIN_STAGED;
+		vars = AllocatePool(max_vars * sizeof(*vars));
+		if (!vars)
+			goto err;
+		if (ctx->vars) {
+			memcpy(vars, ctx->vars, ctx->nb_vars * sizeof(*vars));
+			FreePool(ctx->vars);
+		}
+		ctx->vars = vars;
+		ctx->max_vars = max_vars;
+	}
+
+	var = &ctx->vars[ctx->nb_vars++];
+	var->guid = ctx->guid;
+	var->name = name;
+	var->hash = hash;
+	var->attributes = attributes;
+	var->size = vallen;
+	var->data = data;
+	return EFI_SUCCESS;
+
+err:
+	error(L"Failed to stage oemvar %s", name);
+	if (data)
+		FreePool(data);
+	FreePool(name);
+	return EFI_OUT_OF_RESOURCES;
+}
+
+static void free_staged_oemvars(oemvars_ctx_t *ctx)
+{
+	UINTN i;
+
+	for (i = 0; i < ctx->nb_vars; i++)
+		free_oemvar(&ctx->vars[i]);
+	if (ctx->vars)
+		FreePool(ctx->vars);
+	ctx->vars = NULL;
+	ctx->nb_vars = ctx->max_vars = 0;
+}
+
+/* Write the staged variables, in the order of the oemvars file. */
+static EFI_STATUS commit_oemvars(oemvars_ctx_t *ctx)
+{
+	EFI_STATUS ret;
+	oemvar_t *var;
+	UINTN i;
+
+	debug(L"Setting %ld oemvars", ctx->nb_vars);
+	for (i = 0; i < ctx->nb_vars; i++) {
+		var = &ctx->vars[i];
+		debug(L"Setting oemvar: %s", var->name);
+		ret = uefi_call_wrapper(RT->SetVariable, 5, var->name,
+					&var->guid, var->attributes,
+					var->size, var->data);
+		/* Delete a non-existent variable is permitted.  */
+		if (EFI_ERROR(ret) && !(ret == EFI_NOT_FOUND && var->size == 0)) {
+			if (!ctx->silent_write_error) {
+				efi_perror(ret, L"EFI variable setting failed");
+				return ret;
+			}
+			debug(L"EFI variable setting failed: %r", ret);
+			debug(L"silent error is on, continue anyway");
+		}
+	}
+
+	return EFI_SUCCESS;
+}
+
 static BOOLEAN parse_oemvar_guid_line(char *line, EFI_GUID *g)
 {
 	EFI_STATUS ret;
@@ -167,7 +312,6 @@ static int parse_oemvar_attributes(char **linep, uint32_t *attributesp, enum var
 
 static EFI_STATUS parse_line(char *line, VOID *context)
 {
-	EFI_STATUS ret;
 	uint32_t attributes = 0;
 	enum vartype type;
 	CHAR16 *varname;
@@ -235,22 +379,7 @@ static EFI_STATUS parse_line(char *line, VOID *context)
 		return EFI_ACCESS_DENIED;
 	}
 
-	debug(L"Setting oemvar: %a", var);
-	ret = uefi_call_wrapper(RT->SetVariable, 5, varname,
-				&ctx->guid, attributes,
-				vallen, val);
-	FreePool(varname);
-	/* Delete a non-existent variable is permitted.  */
-	if (EFI_ERROR(ret) && !(ret == EFI_NOT_FOUND && vallen == 0)) {
-		if (!ctx->silent_write_error) {
-			efi_perror(ret, L"EFI variable setting failed");
-			return ret;
-		}
-		debug(L"EFI variable setting failed: %r", ret);
-		debug(L"silent error is on, continue anyway");
-	}
-
-	return EFI_SUCCESS;
+	return stage_oemvar(ctx, varname, attributes, val, vallen);
 }
 
 /*
@@ -288,11 +417,18 @@ static EFI_STATUS parse_line(char *line, VOID *context)
  *   GUID = xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
  *
  * will change the GUID used for subsequent lines.
+ *
+ * The variables are only written once the whole file has been
+ * parsed, so a syntax error or a variable under the fastboot GUID
+ * leaves the variables untouched.  The writes are done in file order.
+ * A variable defined several times is written once, with the last
+ * value, unless it is deleted or its attributes change in between.
  */
 static EFI_STATUS _flash_oemvars(VOID *data, UINTN size,
 				 const EFI_GUID *restricted_guid,
 				 BOOLEAN silent_error)
 {
+	EFI_STATUS ret;
 	oemvars_ctx_t ctx = {
 		.guid = loader_guid,
 		.restricted_guid = restricted_guid,
@@ -300,7 +436,12 @@ static EFI_STATUS _flash_oemvars(VOID *data, UINTN size,
 	};
 
 	debug(L"Parsing and setting values from oemvars file");
-	return parse_text_buffer(data, size, parse_line, &ctx);
+	ret = parse_text_buffer(data, size, parse_line, &ctx);
+	if (!EFI_ERROR(ret))
+		ret = commit_oemvars(&ctx);
+
+	free_staged_oemvars(&ctx);
+	return ret;
 }
 
 EFI_STATUS flash_oemvars_silent_write_error(VOID *data, UINTN size,
@@ -79,3 +79,22 @@ EFI_STATUS get_pci_ids(IN EFI_PCI_IO *pciio, OUT pci_device_ids_t *ids)
 	return uefi_call_wrapper(pciio->Pci.Read, 5, pciio, EfiPciIoWidthUint16,
 				 0, 2, ids);
 }
+
+EFI_STATUS get_pci_class(IN EFI_PCI_IO *pciio, OUT UINT8 *class, OUT UINT8 *subclass)
+{
+	EFI_STATUS ret;
+	UINT8 class_code[3];
+
+	if (!pciio || !class || !subclass)
+		return EFI_INVALID_PARAMETER;
+
+	/* Programming interface, sub-class and base class at 0x09 */
+	ret = uefi_call_wrapper(pciio->Pci.Read, 5, pciio, EfiPciIoWidthUint8,
+				0x09, sizeof(class_code), class_code);
+	if (EFI_ERROR(ret))
+		return ret;
+
+	*subclass = class_code[1];
+	*class = class_code[2];
+	return EFI_SUCCESS;
+}
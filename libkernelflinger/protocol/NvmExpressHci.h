@@ -421,7 +421,11 @@ typedef struct {
   UINT8  Dps;                 /* End-to-end Data Protection Type Settings */
   UINT8  Nmic;                /* Namespace Multi-path I/O and Namespace Sharing Capabilities */
   UINT8  Rescap;              /* Reservation Capabilities */
-  UINT8  Rsvd1[88];           /* Reserved as of Nvm Express 1.1 Spec */
+  UINT8  Fpi;                 /* Format Progress Indicator */
+  UINT8  Dlfeat;              /* Deallocate Logical Block Features */
+    #define DLFEAT_READ_ZEROES  0x01
+    #define DLFEAT_READ_MASK    0x07
+  UINT8  Rsvd1[86];           /* Reserved as of Nvm Express 1.1 Spec */
   UINT64 Eui64;               /* IEEE Extended Unique Identifier */
   //
   // LBA Format
@@ -37,7 +37,10 @@
 
 #define CDB_LENGTH			10
 #define BLOCK_TIMEOUT			10000	/* 100ns units => 1ms by block */
+#define UFS_INQUIRY			0x12
 #define UFS_UNMAP			0x42
+#define UFS_SERVICE_ACTION_IN_16	0x9e
+#define UFS_READ_CAPACITY_16		0x10
 #define UFS_SECURITY_PROTOCOL_IN	0xa2
 #define UFS_SECURITY_PROTOCOL_OUT	0xb5
 #define UFS_RPMB_LUN			0x44c1
@@ -61,9 +64,49 @@ struct unmap_block_descriptor {
 
 struct unmap_parameter {
 	__be16 data_length; /* length in bytes of the following data */
-	__be16 block_desc_length; /* length in bytes of the unmap block descriptor */
+	__be16 block_desc_length; /* length in bytes of the unmap block descriptors */
 	__be32 reserved;
-	struct unmap_block_descriptor block_desc;
+	struct unmap_block_descriptor block_desc[0];
+} __attribute__((packed));
+
+#define VPD_BLOCK_LIMITS		0xb0
+
+struct command_descriptor_block_inquiry {
+	__be8 op_code;		/* Operation Code (must be 0x12 for inquiry) */
+	__be8 evpd;		/* Enable Vital Product Data */
+	__be8 page_code;
+	__be16 allocation_length;
+	__be8 control;
+} __attribute__((packed));
+
+struct vpd_block_limits {
+	__be8 device_type;
+	__be8 page_code;	/* must be 0xb0 */
+	__be16 page_length;
+	__be8 reserved[16];
+	__be32 max_unmap_lba_count;
+	__be32 max_unmap_block_desc_count;
+	__be8 reserved2[36];
+} __attribute__((packed));
+
+struct command_descriptor_block_read_capacity_16 {
+	__be8 op_code;		/* Operation Code (must be 0x9e) */
+	__be8 service_action;	/* must be 0x10 for read capacity */
+	__be64 lba;
+	__be32 allocation_length;
+	__be8 reserved;
+	__be8 control;
+} __attribute__((packed));
+
+#define READ_CAPACITY_LBPRZ		(1 << 14)
+
+struct read_capacity_16_data {
+	__be64 last_lba;
+	__be32 block_length;
+	__be8 protection;
+	__be8 exponents;
+	__be16 provisioning;	/* LBPME, LBPRZ and lowest aligned LBA */
+	__be8 reserved[16];
 } __attribute__((packed));
 
 struct command_descriptor_block_security_protocol {
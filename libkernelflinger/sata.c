@@ -294,17 +294,13 @@ static EFI_STATUS ata_fill_zero(EFI_ATA_PASS_THRU_PROTOCOL *ata,
 	return ret;
 }
 
-static EFI_STATUS sata_erase_blocks(EFI_HANDLE handle,
-				    __attribute__((unused)) EFI_BLOCK_IO *bio,
-				    EFI_LBA start, EFI_LBA end)
+static EFI_STATUS sata_get_ata(EFI_HANDLE handle, EFI_ATA_PASS_THRU_PROTOCOL **ata,
+			       SATA_DEVICE_PATH **sata_dp)
 {
 	EFI_STATUS ret;
 	EFI_GUID AtaPassThruProtocolGuid = EFI_ATA_PASS_THRU_PROTOCOL_GUID;
 	EFI_DEVICE_PATH *dp;
 	EFI_HANDLE ata_handle;
-	SATA_DEVICE_PATH *sata_dp;
-	EFI_ATA_PASS_THRU_PROTOCOL *ata;
-	UINT16 max_dsm_block_nb;
 
 	dp = DevicePathFromHandle(handle);
 	if (!dp) {
@@ -312,28 +308,77 @@ static EFI_STATUS sata_erase_blocks(EFI_HANDLE handle,
 		return EFI_INVALID_PARAMETER;
 	}
 
-	sata_dp = (SATA_DEVICE_PATH *)dp;
+	*sata_dp = (SATA_DEVICE_PATH *)dp;
 	ret = uefi_call_wrapper(BS->LocateDevicePath, 3, &AtaPassThruProtocolGuid,
-				(EFI_DEVICE_PATH **)&sata_dp, &ata_handle);
+				(EFI_DEVICE_PATH **)sata_dp, &ata_handle);
 	if (EFI_ERROR(ret)) {
 		efi_perror(ret, L"Failed to locate ATA root device");
 		return ret;
 	}
 
-	sata_dp = get_sata_device_path(dp);
-	if (!sata_dp) {
+	*sata_dp = get_sata_device_path(dp);
+	if (!*sata_dp) {
 		error(L"Failed to get ATA device path");
 		return EFI_NOT_FOUND;
 	}
 
 	ret = uefi_call_wrapper(BS->HandleProtocol, 3, ata_handle,
-				&AtaPassThruProtocolGuid, (void *)&ata);
+				&AtaPassThruProtocolGuid, (void *)ata);
 	if (EFI_ERROR(ret)) {
 		efi_perror(ret, L"failed to get ATA protocol");
 		return ret;
 	}
 
-	ret = sata_identify_data(ata, sata_dp, &identify_data);
+	return sata_identify_data(*ata, *sata_dp, &identify_data);
+}
+
+static EFI_STATUS sata_discard_blocks(EFI_HANDLE handle,
+				      __attribute__((unused)) EFI_BLOCK_IO *bio,
+				      EFI_LBA start, EFI_LBA end, BOOLEAN *zeroed)
+{
+	EFI_STATUS ret;
+	SATA_DEVICE_PATH *sata_dp;
+	EFI_ATA_PASS_THRU_PROTOCOL *ata;
+	UINT16 max_dsm_block_nb;
+
+	ret = sata_get_ata(handle, &ata, &sata_dp);
+	if (EFI_ERROR(ret))
+		return ret;
+
+	if (!is_dsm_trim_supported(&max_dsm_block_nb))
+		return EFI_UNSUPPORTED;
+
+	ret = ata_dsm_trim(ata, sata_dp, start, end, max_dsm_block_nb);
+	if (EFI_ERROR(ret))
+		return ret;
+
+	*zeroed = is_rzat_supported();
+	return EFI_SUCCESS;
+}
+
+static BOOLEAN sata_discard_zeroes(EFI_HANDLE handle, __attribute__((unused)) EFI_BLOCK_IO *bio)
+{
+	SATA_DEVICE_PATH *sata_dp;
+	EFI_ATA_PASS_THRU_PROTOCOL *ata;
+	UINT16 max_dsm_block_nb;
+
+	/* Refreshes the identify data */
+	if (EFI_ERROR(sata_get_ata(handle, &ata, &sata_dp)))
+		return FALSE;
+
+	return is_dsm_trim_supported(&max_dsm_block_nb) && is_rzat_supported();
+}
+
+static EFI_STATUS sata_erase_blocks(EFI_HANDLE handle,
+				    __attribute__((unused)) EFI_BLOCK_IO *bio,
+				    EFI_LBA start, EFI_LBA end)
+{
+	EFI_STATUS ret;
+	SATA_DEVICE_PATH *sata_dp;
+	EFI_ATA_PASS_THRU_PROTOCOL *ata;
+	UINT16 max_dsm_block_nb;
+
+	ret = sata_get_ata(handle, &ata, &sata_dp);
 	if (EFI_ERROR(ret))
 		return ret;
 
@@ -368,6 +413,8 @@ static BOOLEAN is_sata(EFI_DEVICE_PATH *p)
 
 struct storage STORAGE(STORAGE_SATA) = {
 	.erase_blocks = sata_erase_blocks,
+	.discard_blocks = sata_discard_blocks,
+	.discard_zeroes = sata_discard_zeroes,
 	.check_logical_unit = sata_check_logical_unit,
 	.probe = is_sata,
 	.name = L"SATA"
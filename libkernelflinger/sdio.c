@@ -42,6 +42,9 @@
 #define SDCARD_ERASE_GROUP_START	32
 #define SDCARD_ERASE_GROUP_END		33
 #define STATUS_ERROR_MASK		0xFCFFA080
+/* Busy polling period after an erase command.  TRIM and DISCARD of a
+   slice usually complete in a few milliseconds. */
+#define ERASE_POLL_PERIOD_US		10000
 
 EFI_STATUS sdio_get(EFI_DEVICE_PATH *p,
 		    EFI_HANDLE *handle,
@@ -103,7 +106,7 @@ EFI_STATUS sdio_get_card_info(EFI_SD_HOST_IO_PROTOCOL *sdio,
 
 static EFI_STATUS sdio_erase_group(EFI_SD_HOST_IO_PROTOCOL *sdio, EFI_LBA start,
 				   EFI_LBA end, UINTN timeout, UINT16 card_address,
-				   BOOLEAN emmc)
+				   BOOLEAN emmc, UINT32 erase_arg)
 {
 	EFI_STATUS ret;
 	UINT32 status;
@@ -133,7 +136,7 @@ static EFI_STATUS sdio_erase_group(EFI_SD_HOST_IO_PROTOCOL *sdio, EFI_LBA start,
 		return ret;
 	}
 
-	ret = uefi_call_wrapper(sdio->SendCommand, 9, sdio, ERASE, 0x80000000,
+	ret = uefi_call_wrapper(sdio->SendCommand, 9, sdio, ERASE, erase_arg,
 				NoData, NULL, 0, ResponseR1, timeout, &status);
 	if (EFI_ERROR(ret)) {
 		efi_perror(ret, L"Erase command Failed");
@@ -145,7 +148,7 @@ static EFI_STATUS sdio_erase_group(EFI_SD_HOST_IO_PROTOCOL *sdio, EFI_LBA start,
 	}
 
 	do {
-		pause(1);
+		pause_us(ERASE_POLL_PERIOD_US);
 		ret = uefi_call_wrapper(sdio->SendCommand, 9, sdio, SEND_STATUS,
 					card_address << 16, NoData, NULL, 0,
 					ResponseR1, SDIO_DFLT_TIMEOUT,
@@ -206,5 +209,18 @@ EFI_STATUS sdio_erase(EFI_SD_HOST_IO_PROTOCOL *sdio, EFI_BLOCK_IO *bio,
 		return ret;
 
 	timeout = erase_timeout * ((end + 1 - start) / erase_grp_size);
-	return sdio_erase_group(sdio, start, end, timeout, card_address, emmc);
+	return sdio_erase_group(sdio, start, end, timeout, card_address, emmc,
+				SDIO_ERASE_ARG_SECURE);
+}
+
+EFI_STATUS sdio_discard(EFI_SD_HOST_IO_PROTOCOL *sdio, EFI_LBA start, EFI_LBA end,
+			UINT16 card_address, UINTN timeout, UINT32 erase_arg)
+{
+	if (!sdio || end < start)
+		return EFI_INVALID_PARAMETER;
+
+	/* TRIM and DISCARD operate on write blocks, no erase group
+	   alignment is required */
+	return sdio_erase_group(sdio, start, end, timeout, card_address, TRUE,
+				erase_arg);
 }
@@ -41,6 +41,11 @@
 
 #define SDIO_DFLT_TIMEOUT	3000
 
+/* CMD38 arguments */
+#define SDIO_ERASE_ARG_TRIM	0x00000001
+#define SDIO_ERASE_ARG_DISCARD	0x00000003
+#define SDIO_ERASE_ARG_SECURE	0x80000000
+
 EFI_STATUS sdio_get(EFI_DEVICE_PATH *p,
 		    EFI_HANDLE *handle,
 		    EFI_SD_HOST_IO_PROTOCOL **sdio);
@@ -52,5 +57,7 @@ EFI_STATUS sdio_erase(EFI_SD_HOST_IO_PROTOCOL *sdio, EFI_BLOCK_IO *bio,
 		      UINT64 start, UINT64 end, UINT16 card_address,
 		      UINTN erase_grp_size, UINTN erase_timeout,
 		      BOOLEAN emmc);
+EFI_STATUS sdio_discard(EFI_SD_HOST_IO_PROTOCOL *sdio, UINT64 start, UINT64 end,
+			UINT16 card_address, UINTN timeout, UINT32 erase_arg);
 
 #endif	/* _SDIO_H_ */
@@ -36,6 +36,7 @@
 #include <android.h>
 #include <slot.h>
 #include <endian.h>
+#include <digest_cache.h>
 
 /* Constants.  */
 const CHAR16 *SLOT_STORAGE_PART = MISC_LABEL;
@@ -62,6 +63,10 @@ static char *cur_suffix;	/* Point to one of the suffixes, or
 				   NULL if there is no active slot. */
 static boot_ctrl_t boot_ctrl;
 static slot_metadata_t *slots = boot_ctrl.slot_info;
+/* Set when BOOT_CTRL differs from the copy stored on disk.  Updates
+   are only written by slot_commit() so that a boot or a fastboot
+   command touching several slot attributes writes misc once. */
+static BOOLEAN boot_ctrl_dirty;
 
 static const CHAR16 *label_with_suffix(const CHAR16 *label, const char *suffix)
 {
@@ -166,6 +171,12 @@ static EFI_STATUS write_boot_ctrl(void)
 	return sync_boot_ctrl(FALSE);
 }
 
+static EFI_STATUS stage_boot_ctrl(void)
+{
+	boot_ctrl_dirty = TRUE;
+	return EFI_SUCCESS;
+}
+
 static BOOLEAN is_suffix(const char *suffix)
 {
 	UINTN i;
@@ -208,19 +219,13 @@ static slot_metadata_t *highest_priority_slot(void)
 
 static EFI_STATUS disable_slot(slot_metadata_t *slot, BOOLEAN store)
 {
-	EFI_STATUS ret;
-
 	memset_s(slot, sizeof(*slot), 0, sizeof(*slot));
 	cur_suffix = NULL;
 
 	if (!store)
 		return EFI_SUCCESS;
 
-	ret = write_boot_ctrl();
-	if (EFI_ERROR(ret))
-		efi_perror(ret, L"Failed to disable slot");
-
-	return ret;
+	return stage_boot_ctrl();
 }
 
 static EFI_STATUS select_highest_priority_slot(void)
@@ -371,6 +376,7 @@ static void lower_other_slots_priority(slot_metadata_t *except)
 
 EFI_STATUS slot_set_active(const char *suffix)
 {
+	EFI_STATUS ret;
 	slot_metadata_t *slot;
 	UINTN i;
 	const char *suffix_translate[] = {"_a", "_b"};
@@ -384,6 +390,10 @@ EFI_STATUS slot_set_active(const char *suffix)
 	if (!slot)
 		return EFI_NOT_FOUND;
 
+	ret = digest_cache_invalidate();
+	if (EFI_ERROR(ret))
+		return ret;
+
 	/* Lower priority of all other slots so they are all less than
 	   MAX_PRIORITY in a way that preserves existing order
 	   priority. */
@@ -398,7 +408,7 @@ EFI_STATUS slot_set_active(const char *suffix)
 
 	cur_suffix = suffixes[SUFFIX_INDEX(suffix)];
 
-	return write_boot_ctrl();
+	return stage_boot_ctrl();
 }
 
 UINTN slot_get_suffixes(char **suffixes_p[])
@@ -487,12 +497,11 @@ EFI_STATUS slot_set_verity_corrupted(BOOLEAN corrupted)
 		return EFI_SUCCESS;
 
 	slot->verity_corrupted = corrupted_val;
-	return write_boot_ctrl();
+	return stage_boot_ctrl();
 }
 
 EFI_STATUS slot_reset(void)
 {
-	EFI_STATUS ret;
 	UINTN nb_slot;
 
 	cur_suffix = NULL;
@@ -503,13 +512,7 @@ EFI_STATUS slot_reset(void)
 		 * partition with slots. Disable slot management. */
 		is_used = FALSE;
 		memset_s(&boot_ctrl, sizeof(boot_ctrl), 0, sizeof(boot_ctrl));
-		ret = write_boot_ctrl();
-		/* If the SLOT_STORAGE_PART does not exist anymore
-		   there is no need to clear the slot A/B data from
-		   that partition. */
-		if (ret == EFI_NOT_FOUND)
-			return EFI_SUCCESS;
-		return ret;
+		return stage_boot_ctrl();
 	}
 
 	if (nb_slot > MAX_NB_SLOT) {
@@ -523,12 +526,37 @@ EFI_STATUS slot_reset(void)
 	boot_ctrl.nb_slot = nb_slot;
 	is_used = TRUE;
 
-	return write_boot_ctrl();
+	return stage_boot_ctrl();
 }
 
 EFI_STATUS slot_restore(void)
 {
-	return use_slot() ? write_boot_ctrl() : EFI_SUCCESS;
+	if (!use_slot())
+		return EFI_SUCCESS;
+
+	boot_ctrl_dirty = TRUE;
+	return slot_commit();
+}
+
+EFI_STATUS slot_commit(void)
+{
+	EFI_STATUS ret;
+
+	if (!boot_ctrl_dirty)
+		return EFI_SUCCESS;
+
+	ret = write_boot_ctrl();
+	/* If the SLOT_STORAGE_PART does not exist anymore there is no
+	   need to clear the slot A/B data from that partition. */
+	if (ret == EFI_NOT_FOUND && !is_used)
+		ret = EFI_SUCCESS;
+	if (EFI_ERROR(ret)) {
+		efi_perror(ret, L"Failed to write A/B metadata");
+		return ret;
+	}
+
+	boot_ctrl_dirty = FALSE;
+	return EFI_SUCCESS;
 }
 
 EFI_STATUS slot_boot(enum boot_target target)
@@ -546,7 +574,7 @@ EFI_STATUS slot_boot(enum boot_target target)
 			return EFI_SUCCESS;
 
 		boot_ctrl.recovery_tries_remaining--;
-		return write_boot_ctrl();
+		return stage_boot_ctrl();
 	}
 
 	slot = get_slot(cur_suffix);
@@ -565,7 +593,7 @@ EFI_STATUS slot_boot(enum boot_target target)
 		slot->tries_remaining--;
 	boot_ctrl.recovery_tries_remaining = MAX_RETRIES;
 
-	return write_boot_ctrl();
+	return stage_boot_ctrl();
 }
 
 EFI_STATUS slot_boot_failed(enum boot_target target)
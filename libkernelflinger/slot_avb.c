@@ -37,6 +37,7 @@
 #include <android.h>
 #include <slot.h>
 #include <endian.h>
+#include <digest_cache.h>
 #include <libavb_ab.h>
 #include <libavb_user/uefi_avb_ops.h>
 
@@ -359,6 +360,7 @@ const char *slot_get_active(void)
 
 EFI_STATUS slot_set_active(const char *suffix)
 {
+	EFI_STATUS ret;
 	slot_metadata_t *slot;
 	const char *suffix_translate[] = {"_a", "_b"};
 
@@ -371,6 +373,10 @@ EFI_STATUS slot_set_active(const char *suffix)
 	if (!slot)
 		return EFI_NOT_FOUND;
 
+	ret = digest_cache_invalidate();
+	if (EFI_ERROR(ret))
+		return ret;
+
 	/*
 	 * Lower priority of all other slots so they are all less than
 	 * MAX_PRIORITY in a way that preserves existing order
@@ -498,6 +504,14 @@ EFI_STATUS slot_restore(void)
 	return use_slot() ? write_boot_ctrl() : EFI_SUCCESS;
 }
 
+EFI_STATUS slot_commit(void)
+{
+	/*
+	 * Metadata is written through by the avb A/B ops.
+	 */
+	return EFI_SUCCESS;
+}
+
 EFI_STATUS slot_boot(__attribute__((__unused__)) enum boot_target target)
 {
 	/*
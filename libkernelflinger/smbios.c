@@ -41,29 +41,160 @@ char *SMBIOS_UNDEFINED = "N/A";
 /* Allow cast to pointer from integer of different size.  */
 #pragma GCC diagnostic ignored "-Wint-to-pointer-cast"
 
-char *smbios_get_string(UINT8 type, UINT8 offset)
+/* SMBIOS 3.x 64-bit entry point */
+typedef struct {
+	UINT8 AnchorString[5];
+	UINT8 EntryPointStructureChecksum;
+	UINT8 EntryPointLength;
+	UINT8 MajorVersion;
+	UINT8 MinorVersion;
+	UINT8 DocRev;
+	UINT8 EntryPointRevision;
+	UINT8 Reserved;
+	UINT32 TableMaximumSize;
+	UINT64 TableAddress;
+} __attribute__((packed)) smbios3_entry_point_t;
+
+static EFI_GUID smbios3_guid = {
+	0xf2fd1544, 0x9794, 0x4a2c,
+	{ 0x99, 0x2e, 0xe5, 0xbb, 0xcf, 0x20, 0xe3, 0x94 }
+};
+
+#define SMBIOS_END_OF_TABLE	127
+
+typedef struct smbios_entry {
+	SMBIOS_HEADER *hdr;
+	CHAR8 **strings;
+	UINTN nb_strings;
+} smbios_entry_t;
+
+/* Index of the first structure of each type, built on first use so
+ * that looking up a string does not walk the firmware tables. */
+static struct {
+	BOOLEAN init;
+	smbios_entry_t *entries;
+	CHAR8 **strings;
+	smbios_entry_t *by_type[256];
+} smbios_index;
+
+static EFI_STATUS smbios_get_table(UINT8 **start, UINT8 **end)
 {
+	smbios3_entry_point_t *table3;
 	SMBIOS_STRUCTURE_TABLE *table;
 	EFI_STATUS ret;
-	SMBIOS_STRUCTURE_POINTER sm_struct;
-	UINT8 i;
-	CHAR8 *str;
 
-	ret = LibGetSystemConfigurationTable(&SMBIOSTableGuid, (VOID**)&table);
+	ret = LibGetSystemConfigurationTable(&smbios3_guid, (VOID **)&table3);
+	if (!EFI_ERROR(ret) && !CompareMem(table3->AnchorString, "_SM3_", 5) &&
+	    (UINTN)table3->TableAddress == table3->TableAddress) {
+		*start = (UINT8 *)(UINTN)table3->TableAddress;
+		*end = *start + table3->TableMaximumSize;
+		return EFI_SUCCESS;
+	}
+
+	ret = LibGetSystemConfigurationTable(&SMBIOSTableGuid, (VOID **)&table);
 	if (EFI_ERROR(ret))
-		return SMBIOS_UNDEFINED;
+		return ret;
+
+	*start = (UINT8 *)(UINTN)table->TableAddress;
+	*end = *start + table->TableLength;
+	return EFI_SUCCESS;
+}
+
+/* Return the structure following HDR or NULL if HDR overflows END.
+ * The NB_STRINGS strings of HDR are stored in STRINGS if not NULL. */
+static UINT8 *smbios_next(SMBIOS_HEADER *hdr, UINT8 *end,
+			  CHAR8 **strings, UINTN *nb_strings)
+{
+	UINT8 *p = (UINT8 *)hdr + hdr->Length;
+	UINTN n = 0;
+
+	if ((UINT8 *)hdr + sizeof(*hdr) > end || hdr->Length < sizeof(*hdr) ||
+	    p + 1 >= end)
+		return NULL;
+
+	/* The string-set is terminated by two NUL bytes, even if empty */
+	if (!p[0]) {
+		*nb_strings = 0;
+		return p[1] ? NULL : p + 2;
+	}
+
+	while (p < end && *p) {
+		if (strings)
+			strings[n] = (CHAR8 *)p;
+		n++;
+		while (p < end && *p)
+			p++;
+		p++;
+	}
+	if (p >= end)
+		return NULL;
+
+	*nb_strings = n;
+	return p + 1;
+}
+
+static EFI_STATUS smbios_build_index(void)
+{
+	EFI_STATUS ret;
+	UINT8 *start, *end, *p;
+	SMBIOS_HEADER *hdr;
+	UINTN nb_entries, nb_strings, n, i, j;
+
+	ret = smbios_get_table(&start, &end);
+	if (EFI_ERROR(ret))
+		return ret;
 
-	sm_struct.Hdr = (SMBIOS_HEADER *)table->TableAddress;
-	for (i = 0; i < table->TableLength; i++) {
-		if (sm_struct.Hdr->Type == type)
+	nb_entries = nb_strings = 0;
+	for (p = start; p && p < end; ) {
+		hdr = (SMBIOS_HEADER *)p;
+		p = smbios_next(hdr, end, NULL, &n);
+		if (!p)
+			break;
+		nb_entries++;
+		nb_strings += n;
+		if (hdr->Type == SMBIOS_END_OF_TABLE)
 			break;
-		LibGetSmbiosString(&sm_struct, -1);
 	}
 
-	if (i == table->TableLength)
+	if (!nb_entries)
+		return EFI_NOT_FOUND;
+
+	smbios_index.entries = AllocatePool(nb_entries * sizeof(*smbios_index.entries) +
+					    nb_strings * sizeof(*smbios_index.strings));
+	if (!smbios_index.entries)
+		return EFI_OUT_OF_RESOURCES;
+	smbios_index.strings = (CHAR8 **)(smbios_index.entries + nb_entries);
+
+	for (p = start, i = j = 0; i < nb_entries; i++) {
+		hdr = (SMBIOS_HEADER *)p;
+		smbios_index.entries[i].hdr = hdr;
+		smbios_index.entries[i].strings = smbios_index.strings + j;
+		p = smbios_next(hdr, end, smbios_index.strings + j,
+				&smbios_index.entries[i].nb_strings);
+		j += smbios_index.entries[i].nb_strings;
+		if (!smbios_index.by_type[hdr->Type])
+			smbios_index.by_type[hdr->Type] = &smbios_index.entries[i];
+	}
+
+	smbios_index.init = TRUE;
+	return EFI_SUCCESS;
+}
+
+char *smbios_get_string(UINT8 type, UINT8 offset)
+{
+	smbios_entry_t *entry;
+	UINT8 n;
+
+	if (!smbios_index.init && EFI_ERROR(smbios_build_index()))
+		return SMBIOS_UNDEFINED;
+
+	entry = smbios_index.by_type[type];
+	if (!entry || offset >= entry->hdr->Length)
 		return SMBIOS_UNDEFINED;
 
-	str = LibGetSmbiosString(&sm_struct, sm_struct.Raw[offset]);
+	n = ((UINT8 *)entry->hdr)[offset];
+	if (n == 0 || n > entry->nb_strings)
+		return SMBIOS_UNDEFINED;
 
-	return str ? (char *)str : SMBIOS_UNDEFINED;
+	return (char *)entry->strings[n - 1];
 }
@@ -37,6 +37,11 @@
 #include "pci.h"
 #include "protocol/EraseBlock.h"
 #include "timer.h"
+#include "vars.h"
+
+/* Type and device path of the last boot device selected by a full
+ * probe of the block devices */
+#define BOOT_DEVICE_VAR		L"BootDeviceCache"
 
 static struct storage *cur_storage;
 static PCI_DEVICE_PATH boot_device = { .Function = -1, .Device = -1 };
@@ -73,24 +78,25 @@ extern struct storage STORAGE(STORAGE_USB);
 extern struct storage STORAGE(STORAGE_GENERAL_BLOCK);
 
 
+static struct storage *supported_storage[STORAGE_ALL] = {
+	&STORAGE(STORAGE_EMMC)
+	, &STORAGE(STORAGE_UFS)
+	, &STORAGE(STORAGE_SDCARD)
+	, &STORAGE(STORAGE_SATA)
+	, &STORAGE(STORAGE_NVME)
+	, &STORAGE(STORAGE_VIRTUAL)
+#ifdef USB_STORAGE
+	, &STORAGE(STORAGE_USB)
+#endif
+	, &STORAGE(STORAGE_GENERAL_BLOCK)
+};
+
 static EFI_STATUS identify_storage(EFI_DEVICE_PATH *device_path,
 				   enum storage_type filter,
 				   struct storage **storage,
 				   enum storage_type *type)
 {
 	enum storage_type st;
-	static struct storage *supported_storage[STORAGE_ALL] = {
-		&STORAGE(STORAGE_EMMC)
-		, &STORAGE(STORAGE_UFS)
-		, &STORAGE(STORAGE_SDCARD)
-		, &STORAGE(STORAGE_SATA)
-		, &STORAGE(STORAGE_NVME)
-		, &STORAGE(STORAGE_VIRTUAL)
-#ifdef USB_STORAGE
-		, &STORAGE(STORAGE_USB)
-#endif
-		, &STORAGE(STORAGE_GENERAL_BLOCK)
-	};
 
 	for (st = STORAGE_EMMC; st < STORAGE_ALL; st++) {
 		if ((filter == st || filter == STORAGE_ALL) &&
@@ -143,7 +149,7 @@ BOOLEAN is_same_device(EFI_DEVICE_PATH *p, EFI_DEVICE_PATH *e)
 	return TRUE;
 }
 
-EFI_STATUS identify_boot_device(enum storage_type filter)
+static EFI_STATUS probe_boot_device(enum storage_type filter)
 {
 	EFI_STATUS ret;
 	EFI_HANDLE *handles;
@@ -230,6 +236,186 @@ EFI_STATUS identify_boot_device(enum storage_type filter)
 	return EFI_SUCCESS;
 }
 
+static BOOLEAN valid_device_path(EFI_DEVICE_PATH *p, UINTN size)
+{
+	UINTN len;
+
+	for (;;) {
+		if (size < sizeof(*p))
+			return FALSE;
+		len = DevicePathNodeLength(p);
+		if (len < sizeof(*p) || len > size)
+			return FALSE;
+		if (IsDevicePathEnd(p))
+			return len == size;
+		size -= len;
+		p = NextDevicePathNode(p);
+	}
+}
+
+/* Check that probe_boot_device() would still select the cached device
+ * of type TYPE on the PCI device PCI without ambiguity: no other PCI
+ * device is of a storage type with a higher or the same priority.
+ * Only the storage back-ends up to TYPE are probed. */
+static EFI_STATUS check_cached_boot_device(PCI_DEVICE_PATH *pci,
+					   enum storage_type type)
+{
+	EFI_STATUS ret;
+	EFI_HANDLE *handles;
+	UINTN nb_handle = 0;
+	UINTN i;
+	EFI_DEVICE_PATH *device_path;
+	PCI_DEVICE_PATH *other;
+	enum storage_type st;
+
+	ret = uefi_call_wrapper(BS->LocateHandleBuffer, 5, ByProtocol,
+				&BlockIoProtocol, NULL, &nb_handle, &handles);
+	if (EFI_ERROR(ret))
+		return ret;
+
+	for (i = 0; i < nb_handle; i++) {
+		device_path = DevicePathFromHandle(handles[i]);
+		if (!device_path)
+			continue;
+
+		other = get_pci_device_path(device_path);
+		if (!other)
+			continue;
+
+		if (other->Function == pci->Function &&
+		    other->Device == pci->Device)
+			continue;
+
+		if (is_same_device(device_path, exclude_device))
+			continue;
+
+		for (st = STORAGE_EMMC; st <= type; st++) {
+			if (!supported_storage[st] ||
+			    !supported_storage[st]->probe(device_path))
+				continue;
+			debug(L"Other %s storage found, full probe needed",
+			      supported_storage[st]->name);
+			FreePool(handles);
+			return EFI_NOT_FOUND;
+		}
+	}
+
+	FreePool(handles);
+	return EFI_SUCCESS;
+}
+
+/* Select the boot device recorded in CACHE by a previous boot if the
+ * same device is still present and the probe would select it again. */
+static EFI_STATUS use_cached_boot_device(VOID *cache, UINTN size)
+{
+	EFI_STATUS ret;
+	UINT32 type;
+	EFI_DEVICE_PATH *device_path, *remaining;
+	EFI_HANDLE handle;
+	PCI_DEVICE_PATH *pci;
+	struct storage *storage;
+	enum storage_type st;
+
+	if (size <= sizeof(type))
+		return EFI_COMPROMISED_DATA;
+
+	type = *(UINT32 *)cache;
+	device_path = (EFI_DEVICE_PATH *)((UINT8 *)cache + sizeof(type));
+	if (type >= STORAGE_ALL || !supported_storage[type] ||
+	    !valid_device_path(device_path, size - sizeof(type)))
+		return EFI_COMPROMISED_DATA;
+
+	if (is_same_device(device_path, exclude_device))
+		return EFI_NOT_FOUND;
+
+	pci = get_pci_device_path(device_path);
+	if (!pci)
+		return EFI_COMPROMISED_DATA;
+
+	remaining = device_path;
+	ret = uefi_call_wrapper(BS->LocateDevicePath, 3, &BlockIoProtocol,
+				&remaining, &handle);
+	if (EFI_ERROR(ret) || !IsDevicePathEnd(remaining))
+		return EFI_NOT_FOUND;
+
+	ret = identify_storage(device_path, STORAGE_ALL, &storage, &st);
+	if (EFI_ERROR(ret) || st != type)
+		return EFI_NOT_FOUND;
+
+	ret = check_cached_boot_device(pci, type);
+	if (EFI_ERROR(ret))
+		return ret;
+
+	ret = memcpy_s(&boot_device, sizeof(boot_device), pci, sizeof(boot_device));
+	if (EFI_ERROR(ret))
+		return ret;
+	cur_storage = supported_storage[type];
+	boot_device_type = type;
+	boot_device_handle = handle;
+
+	debug(L"%s storage selected from cache", cur_storage->name);
+	return EFI_SUCCESS;
+}
+
+static void save_boot_device(VOID *cache, UINTN cache_size)
+{
+	EFI_STATUS ret;
+	EFI_DEVICE_PATH *device_path;
+	UINT32 type = boot_device_type;
+	UINT8 *data;
+	UINTN size;
+
+	device_path = DevicePathFromHandle(boot_device_handle);
+	if (!device_path)
+		return;
+
+	size = sizeof(type) + DevicePathSize(device_path);
+	data = AllocatePool(size);
+	if (!data)
+		return;
+
+	*(UINT32 *)data = type;
+	CopyMem(data + sizeof(type), device_path, size - sizeof(type));
+
+	/* Only write the variable when the boot device changes */
+	if (!cache || size != cache_size || memcmp(data, cache, size)) {
+		ret = set_efi_variable(&fastboot_guid, BOOT_DEVICE_VAR,
+				       size, data, TRUE, FALSE);
+		if (EFI_ERROR(ret))
+			efi_perror(ret, L"Failed to save the boot device");
+	}
+
+	FreePool(data);
+}
+
+EFI_STATUS identify_boot_device(enum storage_type filter)
+{
+	EFI_STATUS ret;
+	VOID *cache = NULL;
+	UINTN cache_size = 0;
+	UINT32 flags;
+
+	if (filter != STORAGE_ALL)
+		return probe_boot_device(filter);
+
+	ret = get_efi_variable(&fastboot_guid, BOOT_DEVICE_VAR, &cache_size,
+			       &cache, &flags);
+	if (EFI_ERROR(ret))
+		cache = NULL;
+	else if (!EFI_ERROR(use_cached_boot_device(cache, cache_size))) {
+		FreePool(cache);
+		return EFI_SUCCESS;
+	}
+
+	ret = probe_boot_device(filter);
+	if (!EFI_ERROR(ret))
+		save_boot_device(cache, cache_size);
+
+	if (cache)
+		FreePool(cache);
+	return ret;
+}
+
 static BOOLEAN valid_storage(void)
 {
 	if (!initialized) {
@@ -317,9 +503,61 @@ EFI_STATUS storage_check_logical_unit(EFI_DEVICE_PATH *p, logical_unit_t log_uni
 	return cur_storage->check_logical_unit(p, log_unit);
 }
 
-EFI_STATUS storage_erase_blocks(EFI_HANDLE handle, EFI_BLOCK_IO *bio, EFI_LBA start, EFI_LBA end)
+EFI_STATUS storage_discard_blocks(EFI_HANDLE handle, EFI_BLOCK_IO *bio, EFI_LBA start, EFI_LBA end,
+				  BOOLEAN *zeroed)
 {
 	EFI_STATUS ret;
+	EFI_LBA lba, slice_end, total;
+	BOOLEAN slice_zeroed;
+	uint32_t print_sec = 0, print_prev = 0;
+
+	if (!zeroed || end < start)
+		return EFI_INVALID_PARAMETER;
+
+	if (!valid_storage() || !cur_storage->discard_blocks)
+		return EFI_UNSUPPORTED;
+
+	debug(L"Discard lba %ld -> %ld", start, end);
+	*zeroed = TRUE;
+	total = end - start + 1;
+	for (lba = start; lba <= end; lba = slice_end + 1) {
+		slice_end = min(end, lba + DISCARD_SLICE_BLOCKS - 1);
+
+		slice_zeroed = FALSE;
+		ret = cur_storage->discard_blocks(handle, bio, lba, slice_end, &slice_zeroed);
+		if (EFI_ERROR(ret)) {
+			if (lba != start) {
+				info_n(L"\n");
+				efi_perror(ret, L"Failed to discard block %ld", lba);
+			}
+			*zeroed = FALSE;
+			return ret;
+		}
+
+		if (lba == start) {
+			info_n(L"Discarding ");
+			print_sec = boottime_in_msec() / 1000;
+		}
+
+		*zeroed = *zeroed && slice_zeroed;
+		print_progress(slice_end + 1 - start, total, boottime_in_msec() / 1000,
+			       &print_sec, &print_prev);
+	}
+	print_progress(total, total, boottime_in_msec() / 1000, &print_sec, &print_prev);
+	info_n(L"\n");
+
+	debug(L"Discarded blocks %s read back as zero", *zeroed ? L"do" : L"do not");
+	return EFI_SUCCESS;
+}
+
+EFI_STATUS storage_erase_blocks(EFI_HANDLE handle, EFI_BLOCK_IO *bio, EFI_LBA start, EFI_LBA end,
+				BOOLEAN *zeroed)
+{
+	EFI_STATUS ret;
+
+	if (!zeroed)
+		return EFI_INVALID_PARAMETER;
+	*zeroed = FALSE;
 
 	if (!valid_storage())
 		return EFI_UNSUPPORTED;
@@ -332,6 +570,16 @@ EFI_STATUS storage_erase_blocks(EFI_HANDLE handle, EFI_BLOCK_IO *bio, EFI_LBA st
 		return ret;
 
 	debug(L"ERASE_BLOCK_PROTOCOL not supported");
+
+	/* A discard only replaces the erase if the content is
+	 * guaranteed to be gone afterwards. */
+	if (cur_storage->discard_zeroes && cur_storage->discard_zeroes(handle, bio)) {
+		ret = storage_discard_blocks(handle, bio, start, end, zeroed);
+		if (ret != EFI_UNSUPPORTED)
+			return ret;
+	}
+
+	*zeroed = FALSE;
 	return cur_storage->erase_blocks(handle, bio, start, end);
 }
 
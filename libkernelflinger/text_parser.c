@@ -42,51 +42,173 @@ void skip_whitespace(char **line)
 	*line = cur;
 }
 
-EFI_STATUS parse_text_buffer(VOID *data, UINTN size,
-			     EFI_STATUS (*parse_line)(char *line, VOID *ctx),
-			     VOID *context)
+#define LINE_BUFFER_MIN_SIZE	256
+
+void text_parser_init(struct text_parser *parser,
+		      EFI_STATUS (*parse_line)(char *line, VOID *ctx),
+		      VOID *context)
 {
-	EFI_STATUS ret = EFI_SUCCESS;
-	char *buf, *line, *eol, *p;
-	int lineno = 0;
-
-	/* Extra byte so we can always terminate the last line. */
-	buf = AllocatePool(size + 1);
-	if (!buf) {
-		error(L"Failed to allocate text copy buffer");
-		return EFI_OUT_OF_RESOURCES;
+	memset(parser, 0, sizeof(*parser));
+	parser->parse_line = parse_line;
+	parser->context = context;
+}
+
+/* Append LEN bytes of SRC to the line buffer, growing it if needed. */
+static EFI_STATUS line_append(struct text_parser *parser, const char *src, UINTN len)
+{
+	UINTN size;
+	char *line;
+
+	if (!len)
+		return EFI_SUCCESS;
+
+	if (parser->len + len + 1 > parser->size) {
+		size = max(parser->size * 2, (UINTN)LINE_BUFFER_MIN_SIZE);
+		while (size < parser->len + len + 1)
+			size *= 2;
+
+		line = AllocatePool(size);
+		if (!line) {
+			error(L"Failed to allocate text line buffer");
+			return EFI_OUT_OF_RESOURCES;
+		}
+		if (parser->line) {
+			memcpy(line, parser->line, parser->len);
+			FreePool(parser->line);
+		}
+		parser->line = line;
+		parser->size = size;
 	}
-	ret = memcpy_s(buf, size + 1, data, size);
+
+	memcpy(parser->line + parser->len, src, len);
+	parser->len += len;
+	return EFI_SUCCESS;
+}
+
+/* Strip the leading and trailing spaces of [*START, *END). */
+static BOOLEAN trim_span(const char **start, const char **end)
+{
+	while (*start < *end && isspace(**start))
+		(*start)++;
+	while (*end > *start && isspace(*(*end - 1)))
+		(*end)--;
+	return *start != *end;
+}
+
+/* Hand the trimmed line [LINE, END) of the line buffer to the
+ * callback. */
+static EFI_STATUS parse_buffered(struct text_parser *parser, char *line, char *end)
+{
+	EFI_STATUS ret;
+
+	*end = '\0';
+	parser->len = 0;
+
+	ret = parser->parse_line(line, parser->context);
+	if (EFI_ERROR(ret))
+		efi_perror(ret, L"Failed at line %d", parser->lineno);
+
+	return ret;
+}
+
+/* Parse the line [START, END) of the input.  Blank lines are never
+ * copied to the line buffer. */
+static EFI_STATUS parse_span(struct text_parser *parser, const char *start, const char *end)
+{
+	EFI_STATUS ret;
+
+	parser->lineno++;
+	if (!trim_span(&start, &end))
+		return EFI_SUCCESS;
+
+	ret = line_append(parser, start, end - start);
+	if (EFI_ERROR(ret))
+		return ret;
+
+	return parse_buffered(parser, parser->line, parser->line + parser->len);
+}
+
+/* Complete the line held by the line buffer with [START, END) and
+ * parse it. */
+static EFI_STATUS parse_pending(struct text_parser *parser, const char *start, const char *end)
+{
+	EFI_STATUS ret;
+	const char *line, *eol;
+
+	parser->lineno++;
+	ret = line_append(parser, start, end - start);
 	if (EFI_ERROR(ret))
 		return ret;
 
-	buf[size] = 0;
+	line = parser->line;
+	eol = parser->line + parser->len;
+	if (!trim_span(&line, &eol)) {
+		parser->len = 0;
+		return EFI_SUCCESS;
+	}
+
+	return parse_buffered(parser, (char *)line, (char *)eol);
+}
 
-	for (line = buf; line - buf < (ssize_t)size; line = eol + 1) {
-		lineno++;
+EFI_STATUS text_parser_feed(struct text_parser *parser, const VOID *data, UINTN size)
+{
+	EFI_STATUS ret;
+	const char *cur = data, *end = cur + size, *eol;
 
-		/* Detect line and terminate. */
-		eol = (char *)strchr((CHAR8 *)line, '\n');
-		if (!eol)
-			eol = line + strlen((CHAR8 *)line);
-		*eol = 0;
+	while (cur < end) {
+		/* A NUL byte terminates a line, as a newline does. */
+		for (eol = cur; eol < end && *eol != '\n' && *eol != '\0'; eol++)
+			;
 
-		/* Snip space character for sanity. */
-		p = line + strlen((CHAR8 *)line);
-		while (p > line && isspace(*(p-1)))
-			*(--p) = 0;
+		if (eol == end)
+			return line_append(parser, cur, end - cur);
 
-		skip_whitespace(&line);
-		if (*line == '\0')
-			continue;
+		if (parser->len)
+			ret = parse_pending(parser, cur, eol);
+		else
+			ret = parse_span(parser, cur, eol);
+		if (EFI_ERROR(ret))
+			return ret;
 
-		ret = parse_line(line, context);
-		if (EFI_ERROR(ret)) {
-			efi_perror(ret, L"Failed at line %d", lineno);
-			break;
-		}
+		cur = eol + 1;
 	}
 
-	FreePool(buf);
+	return EFI_SUCCESS;
+}
+
+EFI_STATUS text_parser_finish(struct text_parser *parser)
+{
+	EFI_STATUS ret = EFI_SUCCESS;
+
+	if (parser->len)
+		ret = parse_pending(parser, NULL, NULL);
+
+	text_parser_free(parser);
 	return ret;
 }
+
+void text_parser_free(struct text_parser *parser)
+{
+	if (parser->line)
+		FreePool(parser->line);
+	parser->line = NULL;
+	parser->len = parser->size = 0;
+}
+
+EFI_STATUS parse_text_buffer(VOID *data, UINTN size,
+			     EFI_STATUS (*parse_line)(char *line, VOID *ctx),
+			     VOID *context)
+{
+	struct text_parser parser;
+	EFI_STATUS ret;
+
+	text_parser_init(&parser, parse_line, context);
+
+	ret = text_parser_feed(&parser, data, size);
+	if (EFI_ERROR(ret)) {
+		text_parser_free(&parser);
+		return ret;
+	}
+
+	return text_parser_finish(&parser);
+}
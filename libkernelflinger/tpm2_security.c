@@ -839,6 +839,18 @@ EFI_STATUS tpm2_init(void)
 	return ret;
 }
 
+static void tpm2_log_latency(void)
+{
+	const TPM2_COMMAND_LATENCY *latency;
+	UINTN i, nb;
+
+	nb = Tpm2GetCommandLatency(&latency);
+	for (i = 0; i < nb; i++)
+		debug(L"TPM2 command 0x%x: %d calls, %ld us total, %d us max",
+		      latency[i].CommandCode, latency[i].Count,
+		      latency[i].TotalUs, latency[i].MaxUs);
+}
+
 EFI_STATUS tpm2_end(void)
 {
 	/* Maybe set read/write lock again */
@@ -846,21 +858,36 @@ EFI_STATUS tpm2_end(void)
 	tpm2_read_lock_nvindex(NV_INDEX_BOOTLOADER);
 	tpm2_write_lock_nvindex(NV_INDEX_BOOTLOADER);
 
+	tpm2_log_latency();
 	return EFI_SUCCESS;
 }
 
 #else //USE_IVSHMEM
 ////////////////////////////TPM Requests are forwared to OPTEE/////////////////////////////
 
+/* Forward REQ to the host and return its status, or the error which
+ * prevented it from being handled. */
+static EFI_STATUS tpm2_request(struct tpm2_int_req *req)
+{
+	EFI_STATUS ret;
+
+	ret = ivshmem_rollback_index_interrupt(req);
+	if (EFI_ERROR(ret))
+		return ret;
+
+	return req->ret;
+}
+
 EFI_STATUS tpm2_init(void)
 {
+	EFI_STATUS ret;
 	struct tpm2_int_req req = {0};
 	req.cmd = TEE_TPM2_INIT;
-	ivshmem_rollback_index_interrupt(&req);
+	ret = tpm2_request(&req);
 
-	if (EFI_ERROR(req.ret)) {
-		efi_perror(req.ret, L"TPM init failed.");
-		return req.ret;
+	if (EFI_ERROR(ret)) {
+		efi_perror(ret, L"TPM init failed.");
+		return ret;
 	}
 
 	if (is_platform_secure_boot_enabled())
@@ -868,16 +895,14 @@ EFI_STATUS tpm2_init(void)
 	else
 		debug(L"TPM init OK. Secure boot DISABLED.");
 
-	return req.ret;
+	return ret;
 }
 
 EFI_STATUS tpm2_end(void)
 {
 	struct tpm2_int_req req = {0};
 	req.cmd = TEE_TPM2_END;
-	ivshmem_rollback_index_interrupt(&req);
-
-	return req.ret;
+	return tpm2_request(&req);
 }
 
 EFI_STATUS read_device_state_tpm2(UINT8 *state)
@@ -889,10 +914,9 @@ EFI_STATUS read_device_state_tpm2(UINT8 *state)
 	req->cmd = TEE_TPM2_READ_DEVICE_STATE;
 	req->size = sizeof(*state);
 
-	ivshmem_rollback_index_interrupt(req);
-
-	EFI_STATUS ret = req->ret;
-	*state = *(UINT8 *)(req->payload);
+	EFI_STATUS ret = tpm2_request(req);
+	if (!EFI_ERROR(ret))
+		*state = *(UINT8 *)(req->payload);
 
 	FreePool(req);
 	return ret;
@@ -908,27 +932,103 @@ EFI_STATUS write_device_state_tpm2(UINT8 state)
 	req->size = sizeof(state);
 	*(UINT8 *)(req->payload) = state;
 
-	ivshmem_rollback_index_interrupt(req);
-	EFI_STATUS ret = req->ret;
+	EFI_STATUS ret = tpm2_request(req);
 
 	FreePool(req);
 	return ret;
 }
 
-EFI_STATUS read_rollback_index_tpm2(size_t rollback_index_slot, uint64_t *out_rollback_index)
+/* Rollback index request payload: the slot followed by the index. */
+#define ROLLBACK_INDEX_PAYLOAD_LEN	(sizeof(size_t) + sizeof(uint64_t))
+
+/* When the host takes batched requests, the first ROLLBACK_INDEX_PREFETCH
+ * rollback indexes are read with a single doorbell and libavb lookups are
+ * then served from this cache. */
+#define ROLLBACK_INDEX_PREFETCH		8
+
+static struct {
+	BOOLEAN valid;
+	EFI_STATUS ret[ROLLBACK_INDEX_PREFETCH];
+	uint64_t index[ROLLBACK_INDEX_PREFETCH];
+} rollback_cache;
+
+static struct tpm2_int_req *rollback_index_req(UINT32 cmd, size_t rollback_index_slot,
+					       uint64_t rollback_index)
 {
-	uint32_t payload_len = sizeof(rollback_index_slot) + sizeof(*out_rollback_index);
-	struct tpm2_int_req *req = (struct tpm2_int_req *)AllocateZeroPool(sizeof(struct tpm2_int_req) + payload_len);
+	struct tpm2_int_req *req;
+
+	req = AllocateZeroPool(sizeof(struct tpm2_int_req) + ROLLBACK_INDEX_PAYLOAD_LEN);
 	if (!req)
-		return EFI_OUT_OF_RESOURCES;
+		return NULL;
+
+	req->cmd = cmd;
+	req->size = ROLLBACK_INDEX_PAYLOAD_LEN;
+	memcpy(req->payload, &rollback_index_slot, sizeof(rollback_index_slot));
+	memcpy(req->payload + sizeof(rollback_index_slot), &rollback_index,
+	       sizeof(rollback_index));
+
+	return req;
+}
+
+static uint64_t rollback_index_of(struct tpm2_int_req *req)
+{
+	uint64_t rollback_index;
+
+	memcpy(&rollback_index, req->payload + sizeof(size_t), sizeof(rollback_index));
+	return rollback_index;
+}
+
+static void prefetch_rollback_indexes(void)
+{
+	struct tpm2_int_req *reqs[ROLLBACK_INDEX_PREFETCH] = { NULL };
+	EFI_STATUS ret = EFI_OUT_OF_RESOURCES;
+	size_t i;
+
+	for (i = 0; i < ROLLBACK_INDEX_PREFETCH; i++) {
+		reqs[i] = rollback_index_req(TEE_TPM2_READ_ROLLBACK_INDEX, i, 0);
+		if (!reqs[i])
+			goto out;
+	}
 
-	req->cmd = TEE_TPM2_READ_ROLLBACK_INDEX;
-	req->size = payload_len;
+	ret = ivshmem_rollback_index_batch(reqs, ROLLBACK_INDEX_PREFETCH);
+	if (EFI_ERROR(ret))
+		goto out;
+
+	for (i = 0; i < ROLLBACK_INDEX_PREFETCH; i++) {
+		rollback_cache.ret[i] = reqs[i]->ret;
+		rollback_cache.index[i] = rollback_index_of(reqs[i]);
+	}
+	rollback_cache.valid = TRUE;
 
-	ivshmem_rollback_index_interrupt(req);
+out:
+	if (EFI_ERROR(ret))
+		efi_perror(ret, L"Failed to prefetch the rollback indexes");
+	for (i = 0; i < ROLLBACK_INDEX_PREFETCH; i++)
+		if (reqs[i])
+			FreePool(reqs[i]);
+}
 
-	*out_rollback_index = *(uint64_t*)((req->payload)+sizeof(rollback_index_slot));
-	EFI_STATUS ret = req->ret;
+EFI_STATUS read_rollback_index_tpm2(size_t rollback_index_slot, uint64_t *out_rollback_index)
+{
+	struct tpm2_int_req *req;
+	EFI_STATUS ret;
+
+	if (rollback_index_slot < ROLLBACK_INDEX_PREFETCH && ivshmem_batch_supported()) {
+		if (!rollback_cache.valid)
+			prefetch_rollback_indexes();
+		if (rollback_cache.valid) {
+			*out_rollback_index = rollback_cache.index[rollback_index_slot];
+			return rollback_cache.ret[rollback_index_slot];
+		}
+	}
+
+	req = rollback_index_req(TEE_TPM2_READ_ROLLBACK_INDEX, rollback_index_slot, 0);
+	if (!req)
+		return EFI_OUT_OF_RESOURCES;
+
+	ret = tpm2_request(req);
+	if (!EFI_ERROR(ret))
+		*out_rollback_index = rollback_index_of(req);
 
 	FreePool(req);
 
@@ -937,19 +1037,26 @@ EFI_STATUS read_rollback_index_tpm2(size_t rollback_index_slot, uint64_t *out_ro
 
 EFI_STATUS write_rollback_index_tpm2(size_t rollback_index_slot, uint64_t rollback_index)
 {
-	uint32_t payload_len = sizeof(rollback_index_slot) + sizeof(rollback_index);
-	struct tpm2_int_req *req = (struct tpm2_int_req *)AllocateZeroPool(sizeof(struct tpm2_int_req) + payload_len);
+	struct tpm2_int_req *req;
+	EFI_STATUS ret;
+
+	req = rollback_index_req(TEE_TPM2_WRITE_ROLLBACK_INDEX, rollback_index_slot,
+				 rollback_index);
 	if (!req)
 		return EFI_OUT_OF_RESOURCES;
 
-	req->cmd = TEE_TPM2_WRITE_ROLLBACK_INDEX;
-	req->size = payload_len;
-
-	ivshmem_rollback_index_interrupt(req);
-
-	EFI_STATUS ret = req->ret;
+	ret = tpm2_request(req);
 	FreePool(req);
 
+	if (rollback_index_slot < ROLLBACK_INDEX_PREFETCH) {
+		if (EFI_ERROR(ret)) {
+			rollback_cache.valid = FALSE;
+		} else {
+			rollback_cache.ret[rollback_index_slot] = EFI_SUCCESS;
+			rollback_cache.index[rollback_index_slot] = rollback_index;
+		}
+	}
+
 	return ret;
 }
 
@@ -957,7 +1064,8 @@ BOOLEAN tpm2_bootloader_need_init(void)
 {
 	struct tpm2_int_req req = {0};
 	req.cmd = TEE_TPM2_BOOTLOADER_NEED_INIT;
-	ivshmem_rollback_index_interrupt(&req);
+	if (EFI_ERROR(ivshmem_rollback_index_interrupt(&req)))
+		return FALSE;
 
 	return req.ret;
 }
@@ -979,9 +1087,7 @@ EFI_STATUS tpm2_fuse_lock_owner(void)
 {
 	struct tpm2_int_req req = {0};
 	req.cmd = TEE_TPM2_FUSE_LOCK_OWNER;
-	ivshmem_rollback_index_interrupt(&req);
-
-	return req.ret;
+	return tpm2_request(&req);
 }
 
 EFI_STATUS tpm2_fuse_provision_seed(void)
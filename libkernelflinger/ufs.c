@@ -52,20 +52,14 @@ static EFI_DEVICE_PATH *get_ufs_device_path(EFI_DEVICE_PATH *p)
 	return NULL;
 }
 
-static EFI_STATUS ufs_erase_blocks(EFI_HANDLE handle, __attribute__((unused)) EFI_BLOCK_IO *bio, EFI_LBA start, EFI_LBA end)
+static EFI_STATUS ufs_get_target(EFI_HANDLE handle, EFI_EXT_SCSI_PASS_THRU_PROTOCOL **scsi,
+				 UINT8 *target, UINT64 *lun)
 {
 	EFI_STATUS ret;
 	EFI_GUID ScsiPassThruProtocolGuid = EFI_EXT_SCSI_PASS_THRU_PROTOCOL_GUID;
-	EFI_EXT_SCSI_PASS_THRU_PROTOCOL *scsi;
-	EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET scsi_req;
-	struct unmap_parameter unmap;
-	struct command_descriptor_block_unmap cdb;
 	EFI_HANDLE scsi_handle;
 	EFI_DEVICE_PATH *dp = DevicePathFromHandle(handle);
 	EFI_DEVICE_PATH *scsi_dp = dp;
-	UINT8 target_bytes[TARGET_MAX_BYTES];
-	UINT8 *target = target_bytes;
-	UINT64 lun;
 
 	if (!dp) {
 		error(L"Failed to get device path from handle");
@@ -79,7 +73,7 @@ static EFI_STATUS ufs_erase_blocks(EFI_HANDLE handle, __attribute__((unused)) EF
 	}
 
 	ret = uefi_call_wrapper(BS->HandleProtocol, 3, scsi_handle,
-				&ScsiPassThruProtocolGuid, (void *)&scsi);
+				&ScsiPassThruProtocolGuid, (void *)scsi);
 	if (EFI_ERROR(ret)) {
 		error(L"failed to get scsi protocol");
 		return ret;
@@ -91,35 +85,208 @@ static EFI_STATUS ufs_erase_blocks(EFI_HANDLE handle, __attribute__((unused)) EF
 		return EFI_NOT_FOUND;
 	}
 
-	ret = uefi_call_wrapper(scsi->GetTargetLun, 4, scsi, scsi_dp, (UINT8 **)&target, &lun);
-	if (EFI_ERROR(ret)) {
+	ret = uefi_call_wrapper((*scsi)->GetTargetLun, 4, *scsi, scsi_dp, (UINT8 **)&target, lun);
+	if (EFI_ERROR(ret))
 		error(L"Failed to get LUN of current device");
+
+	return ret;
+}
+
+static EFI_STATUS ufs_scsi_read(EFI_EXT_SCSI_PASS_THRU_PROTOCOL *scsi, UINT8 *target, UINT64 lun,
+				VOID *cdb, UINT8 cdb_length, VOID *data, UINT32 length)
+{
+	EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET scsi_req;
+	EFI_STATUS ret;
+	VOID *buf, *aligned_buf;
+
+	ret = alloc_aligned(&buf, &aligned_buf, length, scsi->Mode->IoAlign);
+	if (EFI_ERROR(ret))
 		return ret;
-	}
 
 	ZeroMem(&scsi_req, sizeof(scsi_req));
-	ZeroMem(&unmap, sizeof(unmap));
-	ZeroMem(&cdb, sizeof(cdb));
+	scsi_req.Timeout = BLOCK_TIMEOUT * 100;
+	scsi_req.InDataBuffer = aligned_buf;
+	scsi_req.InTransferLength = length;
+	scsi_req.Cdb = cdb;
+	scsi_req.CdbLength = cdb_length;
+	scsi_req.DataDirection = EFI_EXT_SCSI_DATA_DIRECTION_READ;
 
-	cdb.op_code = UFS_UNMAP;
-	cdb.param_length = htobe16(sizeof(unmap));
+	ret = uefi_call_wrapper(scsi->PassThru, 5, scsi, target, lun, &scsi_req, NULL);
+	if (!EFI_ERROR(ret))
+		ret = memcpy_s(data, length, aligned_buf, scsi_req.InTransferLength);
 
-	unmap.data_length = htobe16(sizeof(unmap) - sizeof(unmap.data_length));
-	unmap.block_desc_length = htobe16(sizeof(unmap.block_desc));
-	unmap.block_desc.lba = htobe64(start);
-	unmap.block_desc.count = htobe32(end - start + 1);
+	FreePool(buf);
+	return ret;
+}
 
-	scsi_req.Timeout = BLOCK_TIMEOUT * (end - start + 1);
-	scsi_req.OutDataBuffer = &unmap;
-	scsi_req.Cdb = &cdb;
-	scsi_req.OutTransferLength = sizeof(unmap);
-	scsi_req.CdbLength = sizeof(cdb);
-	scsi_req.DataDirection = EFI_EXT_SCSI_DATA_DIRECTION_WRITE;
+/* Bound the UNMAP parameter list to a single 1 KiB buffer */
+#define UFS_UNMAP_MAX_DESC	((1024 - sizeof(struct unmap_parameter)) \
+				 / sizeof(struct unmap_block_descriptor))
 
-	ret = uefi_call_wrapper(scsi->PassThru, 5, scsi, target, lun, &scsi_req, NULL);
+/* The UNMAP limits and the provisioning type of a logical unit do not
+ * change during the life of kernelflinger, they are looked up on the
+ * first discard and reused for the following slices.
+ */
+static struct {
+	EFI_EXT_SCSI_PASS_THRU_PROTOCOL *scsi;
+	UINT8 target[TARGET_MAX_BYTES];
+	UINT64 lun;
+	UINT32 max_lba_count;
+	UINT32 max_desc_count;
+	BOOLEAN read_zeroes;
+} ufs_unmap_info;
+
+static EFI_STATUS ufs_get_unmap_info(EFI_HANDLE handle)
+{
+	EFI_STATUS ret;
+	EFI_EXT_SCSI_PASS_THRU_PROTOCOL *scsi;
+	UINT8 target[TARGET_MAX_BYTES];
+	UINT64 lun;
+	struct command_descriptor_block_inquiry inquiry;
+	struct vpd_block_limits limits;
+	struct command_descriptor_block_read_capacity_16 read_capacity;
+	struct read_capacity_16_data capacity;
+
+	ret = ufs_get_target(handle, &scsi, target, &lun);
+	if (EFI_ERROR(ret))
+		return ret;
+
+	if (ufs_unmap_info.scsi == scsi && ufs_unmap_info.lun == lun &&
+	    !memcmp(ufs_unmap_info.target, target, sizeof(target)))
+		return EFI_SUCCESS;
+
+	ufs_unmap_info.scsi = scsi;
+	ufs_unmap_info.lun = lun;
+	ret = memcpy_s(ufs_unmap_info.target, sizeof(ufs_unmap_info.target),
+		       target, sizeof(target));
+	if (EFI_ERROR(ret))
+		return ret;
+
+	ufs_unmap_info.max_lba_count = DISCARD_SLICE_BLOCKS;
+	ufs_unmap_info.max_desc_count = 1;
+	ufs_unmap_info.read_zeroes = FALSE;
+
+	ZeroMem(&inquiry, sizeof(inquiry));
+	ZeroMem(&limits, sizeof(limits));
+	inquiry.op_code = UFS_INQUIRY;
+	inquiry.evpd = 1;
+	inquiry.page_code = VPD_BLOCK_LIMITS;
+	inquiry.allocation_length = htobe16(sizeof(limits));
+	ret = ufs_scsi_read(scsi, target, lun, &inquiry, sizeof(inquiry),
+			    &limits, sizeof(limits));
+	if (!EFI_ERROR(ret) && limits.page_code == VPD_BLOCK_LIMITS) {
+		if (limits.max_unmap_lba_count)
+			ufs_unmap_info.max_lba_count = be32toh(limits.max_unmap_lba_count);
+		if (limits.max_unmap_block_desc_count)
+			ufs_unmap_info.max_desc_count = be32toh(limits.max_unmap_block_desc_count);
+	}
+	ufs_unmap_info.max_desc_count = min(ufs_unmap_info.max_desc_count,
+					    (UINT32)UFS_UNMAP_MAX_DESC);
+
+	ZeroMem(&read_capacity, sizeof(read_capacity));
+	ZeroMem(&capacity, sizeof(capacity));
+	read_capacity.op_code = UFS_SERVICE_ACTION_IN_16;
+	read_capacity.service_action = UFS_READ_CAPACITY_16;
+	read_capacity.allocation_length = htobe32(sizeof(capacity));
+	ret = ufs_scsi_read(scsi, target, lun, &read_capacity, sizeof(read_capacity),
+			    &capacity, sizeof(capacity));
+	if (!EFI_ERROR(ret))
+		ufs_unmap_info.read_zeroes = (be16toh(capacity.provisioning) & READ_CAPACITY_LBPRZ) != 0;
+
+	debug(L"UFS unmap: %d blocks per descriptor, %d descriptors, unmapped blocks read %a",
+	      ufs_unmap_info.max_lba_count, ufs_unmap_info.max_desc_count,
+	      ufs_unmap_info.read_zeroes ? "zeroes" : "undefined");
+
+	return EFI_SUCCESS;
+}
+
+static EFI_STATUS ufs_unmap(EFI_LBA start, EFI_LBA end)
+{
+	EFI_STATUS ret;
+	EFI_EXT_SCSI_PASS_THRU_PROTOCOL *scsi = ufs_unmap_info.scsi;
+	EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET scsi_req;
+	struct command_descriptor_block_unmap cdb;
+	struct unmap_parameter *unmap;
+	VOID *buf;
+	UINTN i, length, buf_size;
+	UINT32 count;
+	UINT64 blocks;
+
+	buf_size = sizeof(*unmap) + ufs_unmap_info.max_desc_count * sizeof(unmap->block_desc[0]);
+	ret = alloc_aligned(&buf, (VOID **)&unmap, buf_size, scsi->Mode->IoAlign);
+	if (EFI_ERROR(ret))
+		return ret;
+
+	while (start <= end) {
+		ZeroMem(unmap, buf_size);
+		blocks = 0;
+		for (i = 0; i < ufs_unmap_info.max_desc_count && start <= end; i++) {
+			count = min(end - start + 1, (EFI_LBA)ufs_unmap_info.max_lba_count);
+			unmap->block_desc[i].lba = htobe64(start);
+			unmap->block_desc[i].count = htobe32(count);
+			start += count;
+			blocks += count;
+		}
+
+		length = sizeof(*unmap) + i * sizeof(unmap->block_desc[0]);
+		unmap->data_length = htobe16(length - sizeof(unmap->data_length));
+		unmap->block_desc_length = htobe16(i * sizeof(unmap->block_desc[0]));
+
+		ZeroMem(&cdb, sizeof(cdb));
+		cdb.op_code = UFS_UNMAP;
+		cdb.param_length = htobe16(length);
+
+		ZeroMem(&scsi_req, sizeof(scsi_req));
+		scsi_req.Timeout = BLOCK_TIMEOUT * blocks;
+		scsi_req.OutDataBuffer = unmap;
+		scsi_req.Cdb = &cdb;
+		scsi_req.OutTransferLength = length;
+		scsi_req.CdbLength = sizeof(cdb);
+		scsi_req.DataDirection = EFI_EXT_SCSI_DATA_DIRECTION_WRITE;
+
+		ret = uefi_call_wrapper(scsi->PassThru, 5, scsi, ufs_unmap_info.target,
+					ufs_unmap_info.lun, &scsi_req, NULL);
+		if (EFI_ERROR(ret)) {
+			efi_perror(ret, L"UNMAP command failed");
+			break;
+		}
+	}
+
+	FreePool(buf);
 	return ret;
 }
 
+static EFI_STATUS ufs_discard_blocks(EFI_HANDLE handle, __attribute__((unused)) EFI_BLOCK_IO *bio,
+				     EFI_LBA start, EFI_LBA end, BOOLEAN *zeroed)
+{
+	EFI_STATUS ret;
+
+	ret = ufs_get_unmap_info(handle);
+	if (EFI_ERROR(ret))
+		return ret;
+
+	ret = ufs_unmap(start, end);
+	if (EFI_ERROR(ret))
+		return ret;
+
+	*zeroed = ufs_unmap_info.read_zeroes;
+	return EFI_SUCCESS;
+}
+
+static BOOLEAN ufs_discard_zeroes(EFI_HANDLE handle, __attribute__((unused)) EFI_BLOCK_IO *bio)
+{
+	if (EFI_ERROR(ufs_get_unmap_info(handle)))
+		return FALSE;
+
+	return ufs_unmap_info.read_zeroes;
+}
+
+static EFI_STATUS ufs_erase_blocks(EFI_HANDLE handle, EFI_BLOCK_IO *bio, EFI_LBA start, EFI_LBA end)
+{
+	BOOLEAN zeroed;
+
+	return ufs_discard_blocks(handle, bio, start, end, &zeroed);
+}
 
 static UINT64 lun_factory = UFS_DEFAULT_FACTORY_LUN;
 static UINT64 lun_user = UFS_DEFAULT_USER_LUN;
@@ -257,6 +424,8 @@ static EFI_STATUS ufs_set_log_unit_lun(UINT64 new_lun_user, UINT64 new_lun_facto
 
 struct storage STORAGE(STORAGE_UFS) = {
 	.erase_blocks = ufs_erase_blocks,
+	.discard_blocks = ufs_discard_blocks,
+	.discard_zeroes = ufs_discard_zeroes,
 	.check_logical_unit = ufs_check_logical_unit,
 	.set_logical_unit = ufs_set_log_unit_lun,
 	.probe = is_ufs,
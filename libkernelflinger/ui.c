@@ -224,6 +224,8 @@ EFI_STATUS ui_display_vendor_splash(VOID)
 
 void ui_free(void)
 {
+	ui_font_free_glyph_cache();
+
 	if (!default_textarea)
 		return;
 
@@ -244,12 +246,29 @@ EFI_STATUS ui_clear_screen()
 	return ui_clear_area(0, 0, graphic.width, graphic.height);
 }
 
+/* The log area only redraws the lines which changed since its last
+ * draw.  Anything drawn over it forces a full redraw next time. */
+static void ui_damage_area(UINTN x, UINTN y, UINTN width, UINTN height)
+{
+	if (!default_textarea)
+		return;
+
+	if (x >= default_textarea_x + default_textarea->width
+	    || x + width <= default_textarea_x
+	    || y >= default_textarea_y + default_textarea->height
+	    || y + height <= default_textarea_y)
+		return;
+
+	ui_textarea_invalidate(default_textarea);
+}
+
 EFI_STATUS ui_fill_area(UINTN x, UINTN y, UINTN width, UINTN height,
 			EFI_GRAPHICS_OUTPUT_BLT_PIXEL *color)
 {
 	if (!ui_is_ready())
 		return EFI_UNSUPPORTED;
 
+	ui_damage_area(x, y, width, height);
 	return uefi_call_wrapper(graphic.output->Blt, 10, graphic.output,
 				 color, EfiBltVideoFill, 0, 0, x, y, width, height, 0);
 }
@@ -310,6 +329,7 @@ EFI_STATUS ui_draw_blt(EFI_GRAPHICS_OUTPUT_BLT_PIXEL *blt, UINTN x, UINTN y,
 	if (!graphic.output)
 		return EFI_UNSUPPORTED;
 
+	ui_damage_area(x, y, width, height);
 	ret = uefi_call_wrapper(graphic.output->Blt, 10, graphic.output, blt, EfiBltBufferToVideo,
 				0, 0, x, y, width, height, 0);
 	if (EFI_ERROR(ret))
@@ -318,6 +338,22 @@ EFI_STATUS ui_draw_blt(EFI_GRAPHICS_OUTPUT_BLT_PIXEL *blt, UINTN x, UINTN y,
 	return ret;
 }
 
+EFI_STATUS ui_move_area(UINTN src_x, UINTN src_y, UINTN x, UINTN y,
+			UINTN width, UINTN height)
+{
+	EFI_STATUS ret;
+
+	if (!graphic.output)
+		return EFI_UNSUPPORTED;
+
+	ret = uefi_call_wrapper(graphic.output->Blt, 10, graphic.output, NULL, EfiBltVideoToVideo,
+				src_x, src_y, x, y, width, height, 0);
+	if (EFI_ERROR(ret))
+		efi_perror(ret, L"Failed to move screen area");
+
+	return ret;
+}
+
 static char *build_str(CHAR16 *fmt, va_list args)
 {
 	CHAR16 buf[default_textarea ? default_textarea->row_nb : 200];
@@ -567,72 +603,3 @@ BOOLEAN ui_input_to_bool(UINTN timeout_secs, BOOLEAN timeout_true)
 		return FALSE;
 	}
 }
-
-UINT64 ui_get_blt_size(UINTN width, UINTN height)
-{
-	UINTN size = MultU64x32 ((UINT64) width, height);
-
-	if (size > DivU64x32((UINTN) ~0, sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL), NULL))
-		return 0;
-
-	return MultU64x32(size, sizeof(EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
-}
-
-void ui_get_scaled_dimension(UINTN orig_width, UINTN orig_height,
-			     UINTN max_width, UINTN max_height,
-			     UINTN *width, UINTN *height)
-{
-	if (max_width == 0 && max_height != 0) {
-		*width = orig_width * max_height / orig_height;
-		*height = max_height;
-		return;
-	}
-
-	if (max_height == 0 && max_width != 0) {
-		*height = orig_height * max_width / orig_width;
-		*width = max_width;
-		return;
-	}
-
-	*height = max_height;
-	*width = orig_width * max_height / orig_height;
-	if (*width <= max_width)
-		return;
-
-	*height = orig_height * max_width / orig_width;
-	*width = max_width;
-}
-
-/*
- * Bilinear interpolation:
- * f(x,y) = (1/(x2-x1)(y2-y1)) * (f(Q11)(x2-x)(y2-y) +
- *				f(Q21)(x-x1)(y2-y) +
- *				f(Q12)(x2-x)(y-y1) +
- *				f(Q22)(x-x1)(y-y1))
- */
-void ui_bilinear_scale(unsigned char *s, unsigned char *d,
-		       int sx, int sy, int dx, int dy,
-		       int depth)
-{
-	double ratio_x = (double)(sx - 1) / dx;
-	double ratio_y = (double)(sy - 1) / dy;
-	int i, j, k;
-	sx *= depth;
-	for (i = 0; i < dy; i++ )
-		for (j = 0; j < dx; j++) {
-			double x = j * ratio_x;
-			double y = i * ratio_y;
-			int x1 = x;
-			int x2 = x1 + 1;
-			int y1 = y;
-			int y2 = y1 + 1;
-			for (k = 0; k < depth; k++) {
-				d[j * depth + i * dx * depth + k] = (1 / ((x2 - x1) * (y2 - y1))) *
-					(s[x1 * depth + y1 * sx + k] * (x2 - x) * (y2 - y) +
-					 s[x2 * depth + y1 * sx + k] * (x - x1) * (y2 - y) +
-					 s[x1 * depth + y2 * sx + k] * (x2 - x) * (y - y1) +
-					 s[x2 * depth + y2 * sx + k] * (x - x1) * (y - y1));
-			}
-		}
-}
-
@@ -62,3 +62,170 @@ ui_font_t *ui_font_get(char *name)
 
 	return NULL;
 }
+
+/* Alpha blend the C glyph of FONT with the FG color on DST.  DST_WIDTH
+ * is the width in pixels of the DST buffer. */
+void ui_font_draw_glyph(ui_font_t *font, unsigned char c, BOOLEAN bold,
+			EFI_GRAPHICS_OUTPUT_BLT_PIXEL *fg,
+			EFI_GRAPHICS_OUTPUT_BLT_PIXEL *dst, UINTN dst_width)
+{
+	unsigned char *src = font->texture + ((c - 0x20) * font->cwidth)
+		+ (bold ? font->cheight * font->width : 0);
+	EFI_GRAPHICS_OUTPUT_BLT_PIXEL *px;
+	unsigned char a;
+	UINTN i, j;
+
+	for (j = 0; j < font->cheight; j++) {
+		px = dst + j * dst_width;
+		for (i = 0; i < font->cwidth; i++, px++) {
+			a = src[j * font->width + i];
+			if (a == 255) {
+				px->Blue = fg->Blue;
+				px->Green = fg->Green;
+				px->Red = fg->Red;
+			} else if (a > 0) {
+				px->Blue = (px->Blue * (255 - a) + fg->Blue * a) / 255;
+				px->Green = (px->Green * (255 - a) + fg->Green * a) / 255;
+				px->Red = (px->Red * (255 - a) + fg->Red * a) / 255;
+			}
+		}
+	}
+}
+
+/* Glyph cache
+ *
+ * Menus and logs keep drawing the same few glyphs with the same
+ * colors.  Glyphs already blended on their background are kept in a
+ * bounded cache, looked up by hash and evicted in least recently used
+ * order.
+ */
+#define GLYPH_CACHE_SIZE	128
+#define GLYPH_CACHE_BUCKETS	64
+
+typedef struct glyph {
+	ui_font_t *font;
+	unsigned char c;
+	BOOLEAN bold;
+	UINT32 fg;
+	UINT32 bg;
+	UINT64 last_use;
+	struct glyph *next;
+	EFI_GRAPHICS_OUTPUT_BLT_PIXEL *blt;
+	UINTN blt_size;
+} glyph_t;
+
+static glyph_t glyphs[GLYPH_CACHE_SIZE];
+static glyph_t *glyph_buckets[GLYPH_CACHE_BUCKETS];
+static UINTN glyph_nb;
+static UINT64 glyph_clock;
+
+static UINT32 pixel_value(EFI_GRAPHICS_OUTPUT_BLT_PIXEL *p)
+{
+	return p->Blue | (p->Green << 8) | (p->Red << 16) | ((UINT32)p->Reserved << 24);
+}
+
+static UINTN glyph_hash(ui_font_t *font, unsigned char c, BOOLEAN bold,
+			UINT32 fg, UINT32 bg)
+{
+	UINT32 h = (UINT32)(UINTN)font;
+
+	h = h * 31 + c;
+	h = h * 31 + bold;
+	h = h * 31 + fg;
+	h = h * 31 + bg;
+	return (h ^ (h >> 16)) % GLYPH_CACHE_BUCKETS;
+}
+
+static void glyph_unlink(glyph_t *glyph)
+{
+	glyph_t **p;
+
+	for (p = &glyph_buckets[glyph_hash(glyph->font, glyph->c, glyph->bold,
+					   glyph->fg, glyph->bg)];
+	     *p; p = &(*p)->next)
+		if (*p == glyph) {
+			*p = glyph->next;
+			break;
+		}
+}
+
+static glyph_t *glyph_alloc(void)
+{
+	glyph_t *lru;
+	UINTN i;
+
+	if (glyph_nb < GLYPH_CACHE_SIZE)
+		return &glyphs[glyph_nb++];
+
+	for (lru = &glyphs[0], i = 1; i < GLYPH_CACHE_SIZE; i++)
+		if (glyphs[i].last_use < lru->last_use)
+			lru = &glyphs[i];
+
+	glyph_unlink(lru);
+	return lru;
+}
+
+/* Return the C glyph of FONT blended with the FG color on the BG color
+ * as a FONT->cwidth x FONT->cheight blt buffer, or NULL on allocation
+ * failure.  The buffer belongs to the cache and stays valid until the
+ * next call. */
+EFI_GRAPHICS_OUTPUT_BLT_PIXEL *ui_font_get_glyph(ui_font_t *font, unsigned char c,
+						 BOOLEAN bold,
+						 EFI_GRAPHICS_OUTPUT_BLT_PIXEL *fg,
+						 EFI_GRAPHICS_OUTPUT_BLT_PIXEL *bg)
+{
+	UINT32 fg_value = pixel_value(fg), bg_value = pixel_value(bg);
+	UINTN hash = glyph_hash(font, c, bold, fg_value, bg_value);
+	UINTN i, size = font->cwidth * font->cheight;
+	glyph_t *glyph;
+
+	for (glyph = glyph_buckets[hash]; glyph; glyph = glyph->next)
+		if (glyph->font == font && glyph->c == c && glyph->bold == bold
+		    && glyph->fg == fg_value && glyph->bg == bg_value) {
+			glyph->last_use = ++glyph_clock;
+			return glyph->blt;
+		}
+
+	glyph = glyph_alloc();
+	if (glyph->blt_size < size) {
+		if (glyph->blt)
+			FreePool(glyph->blt);
+		glyph->blt = AllocatePool(size * sizeof(*glyph->blt));
+		glyph->blt_size = glyph->blt ? size : 0;
+	}
+	if (!glyph->blt) {
+		/* Leave the entry unused, it will be picked again */
+		glyph->last_use = 0;
+		glyph->font = NULL;
+		return NULL;
+	}
+
+	for (i = 0; i < size; i++)
+		glyph->blt[i] = *bg;
+	ui_font_draw_glyph(font, c, bold, fg, glyph->blt, font->cwidth);
+
+	glyph->font = font;
+	glyph->c = c;
+	glyph->bold = bold;
+	glyph->fg = fg_value;
+	glyph->bg = bg_value;
+	glyph->last_use = ++glyph_clock;
+	glyph->next = glyph_buckets[hash];
+	glyph_buckets[hash] = glyph;
+
+	return glyph->blt;
+}
+
+void ui_font_free_glyph_cache(void)
+{
+	UINTN i;
+
+	for (i = 0; i < glyph_nb; i++)
+		if (glyphs[i].blt)
+			FreePool(glyphs[i].blt);
+
+	ZeroMem(glyphs, sizeof(glyphs));
+	ZeroMem(glyph_buckets, sizeof(glyph_buckets));
+	glyph_nb = 0;
+	glyph_clock = 0;
+}
@@ -100,11 +100,13 @@ EFI_STATUS ui_image_draw_scale(ui_image_t *image, UINTN x, UINTN y, UINTN width,
 	to_draw.width = new_width;
 	to_draw.height = new_height;
 
-	ui_bilinear_scale((unsigned char *)image->blt,
-			  (unsigned char *)to_draw.blt,
-			  image->width, image->height,
-			  to_draw.width, to_draw.height,
-			  sizeof(EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
+	ret = ui_bilinear_scale(image->blt, to_draw.blt,
+				image->width, image->height,
+				to_draw.width, to_draw.height);
+	if (EFI_ERROR(ret)) {
+		efi_perror(ret, L"Failed to scale image");
+		goto out;
+	}
 
 	ret = ui_image_draw(&to_draw, x, y);
 
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <efi.h>
+#include <efilib.h>
+#include <lib.h>
+#include <ui.h>
+
+UINT64 ui_get_blt_size(UINTN width, UINTN height)
+{
+	UINTN size = MultU64x32 ((UINT64) width, height);
+
+	if (size > DivU64x32((UINTN) ~0, sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL), NULL))
+		return 0;
+
+	return MultU64x32(size, sizeof(EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
+}
+
+void ui_get_scaled_dimension(UINTN orig_width, UINTN orig_height,
+			     UINTN max_width, UINTN max_height,
+			     UINTN *width, UINTN *height)
+{
+	if (max_width == 0 && max_height != 0) {
+		*width = orig_width * max_height / orig_height;
+		*height = max_height;
+		return;
+	}
+
+	if (max_height == 0 && max_width != 0) {
+		*height = orig_height * max_width / orig_width;
+		*width = max_width;
+		return;
+	}
+
+	*height = max_height;
+	*width = orig_width * max_height / orig_height;
+	if (*width <= max_width)
+		return;
+
+	*height = orig_height * max_width / orig_width;
+	*width = max_width;
+}
+
+/*
+ * Bilinear interpolation:
+ * f(x,y) = (1/(x2-x1)(y2-y1)) * (f(Q11)(x2-x)(y2-y) +
+ *				f(Q21)(x-x1)(y2-y) +
+ *				f(Q12)(x2-x)(y-y1) +
+ *				f(Q22)(x-x1)(y-y1))
+ *
+ * Coordinates are computed in fixed point with SCALE_FRAC_BITS
+ * fractional bits.  Pixels are handled as two 64-bit words, one for
+ * the blue and red channels and one for the green and reserved
+ * channels, each channel in a 32-bit lane.  A lane holds at most
+ * 255 << (2 * SCALE_FRAC_BITS) after the two interpolation passes so
+ * it cannot overflow.  Source rows are interpolated horizontally once
+ * and cached as a destination row is built from two of them.
+ */
+#define SCALE_FRAC_BITS	12
+#define SCALE_ONE	(1 << SCALE_FRAC_BITS)
+
+typedef struct scale_row {
+	UINTN y;
+	UINT64 *br;
+	UINT64 *ga;
+} scale_row_t;
+
+static inline UINT64 pixel_br(UINT32 p)
+{
+	return (p & 0xff) | ((UINT64)(p & 0xff0000) << 16);
+}
+
+static inline UINT64 pixel_ga(UINT32 p)
+{
+	return ((p >> 8) & 0xff) | ((UINT64)(p & 0xff000000) << 8);
+}
+
+static void scale_row_fill(scale_row_t *row, UINT32 *src, UINTN y,
+			   UINTN dx, UINT32 *x1, UINT32 *x2, UINT32 *wx)
+{
+	UINTN j;
+	UINT32 a, b;
+
+	for (j = 0; j < dx; j++) {
+		a = src[x1[j]];
+		b = src[x2[j]];
+		row->br[j] = pixel_br(a) * (SCALE_ONE - wx[j]) + pixel_br(b) * wx[j];
+		row->ga[j] = pixel_ga(a) * (SCALE_ONE - wx[j]) + pixel_ga(b) * wx[j];
+	}
+	row->y = y;
+}
+
+static scale_row_t *scale_row_get(scale_row_t rows[2], UINTN y,
+				  scale_row_t *keep, UINT32 *src, UINTN sx,
+				  UINTN dx, UINT32 *x1, UINT32 *x2, UINT32 *wx)
+{
+	scale_row_t *row;
+
+	if (rows[0].y == y)
+		return &rows[0];
+	if (rows[1].y == y)
+		return &rows[1];
+
+	row = keep == &rows[0] ? &rows[1] : &rows[0];
+	scale_row_fill(row, src + y * sx, y, dx, x1, x2, wx);
+	return row;
+}
+
+EFI_STATUS ui_bilinear_scale(EFI_GRAPHICS_OUTPUT_BLT_PIXEL *s,
+			     EFI_GRAPHICS_OUTPUT_BLT_PIXEL *d,
+			     UINTN sx, UINTN sy, UINTN dx, UINTN dy)
+{
+	UINT32 *src = (UINT32 *)s, *dst = (UINT32 *)d;
+	UINT32 *x1, *x2, *wx;
+	scale_row_t rows[2], *r1, *r2;
+	UINT64 br, ga, pos;
+	UINT32 y1, y2, wy;
+	UINTN i, j;
+	void *mem;
+
+	if (!s || !d || !sx || !sy || !dx || !dy)
+		return EFI_INVALID_PARAMETER;
+
+	/* Column tables, then two cached rows of two words per pixel */
+	mem = AllocatePool(dx * (3 * sizeof(UINT32) + 4 * sizeof(UINT64)));
+	if (!mem)
+		return EFI_OUT_OF_RESOURCES;
+
+	rows[0].br = mem;
+	rows[0].ga = rows[0].br + dx;
+	rows[1].br = rows[0].ga + dx;
+	rows[1].ga = rows[1].br + dx;
+	rows[0].y = rows[1].y = (UINTN)-1;
+	x1 = (UINT32 *)(rows[1].ga + dx);
+	x2 = x1 + dx;
+	wx = x2 + dx;
+
+	for (j = 0; j < dx; j++) {
+		pos = DivU64x32((UINT64)j * (sx - 1) << SCALE_FRAC_BITS, dx, NULL);
+		x1[j] = pos >> SCALE_FRAC_BITS;
+		x2[j] = min(x1[j] + 1, (UINT32)sx - 1);
+		wx[j] = pos & (SCALE_ONE - 1);
+	}
+
+	for (i = 0; i < dy; i++) {
+		pos = DivU64x32((UINT64)i * (sy - 1) << SCALE_FRAC_BITS, dy, NULL);
+		y1 = pos >> SCALE_FRAC_BITS;
+		y2 = min(y1 + 1, (UINT32)sy - 1);
+		wy = pos & (SCALE_ONE - 1);
+
+		r1 = scale_row_get(rows, y1, NULL, src, sx, dx, x1, x2, wx);
+		r2 = scale_row_get(rows, y2, r1, src, sx, dx, x1, x2, wx);
+
+		for (j = 0; j < dx; j++) {
+			br = r1->br[j] * (SCALE_ONE - wy) + r2->br[j] * wy;
+			ga = r1->ga[j] * (SCALE_ONE - wy) + r2->ga[j] * wy;
+			dst[j] = ((br >> 24) & 0xff) | ((ga >> 16) & 0xff00) |
+				((br >> 40) & 0xff0000) | ((ga >> 32) & 0xff000000);
+		}
+		dst += dx;
+	}
+
+	FreePool(mem);
+	return EFI_SUCCESS;
+}
@@ -83,93 +83,82 @@ ui_textarea_t *ui_textarea_create(UINTN line_nb, UINTN row_nb, ui_font_t *font,
 		return NULL;
 	}
 
+	textarea->dirty = AllocateZeroPool(sizeof(*textarea->dirty) * line_nb);
+	if (!textarea->dirty) {
+		FreePool(textarea->text);
+		FreePool(textarea->blt);
+		FreePool(textarea);
+		return NULL;
+	}
+
 	textarea->current = -1;
 	textarea->color = color;
 	textarea->bg_color = bg_color;
+	textarea->scroll = 0;
+	textarea->drawn = FALSE;
 
 	return textarea;
 }
 
-static void ui_textarea_copy_char(unsigned char *src_p, UINTN src_row_bytes,
-				  unsigned char *dst_p, UINTN dst_row_bytes,
-				  int width, int height,
-				  EFI_GRAPHICS_OUTPUT_BLT_PIXEL *color)
+/* Index in TEXTAREA->text of the line displayed at ROW. */
+static UINTN ui_textarea_row_line(ui_textarea_t *textarea, UINTN row)
 {
-	int i, j;
-
-	for (j = 0; j < height; ++j) {
-		unsigned char* sx = src_p;
-		unsigned char* px = dst_p;
-		for (i = 0; i < width; ++i) {
-			unsigned char a = *sx++;
-			if (a == 255) {
-				*px++ = color->Blue;
-				*px++ = color->Green;
-				*px++ = color->Red;
-				px++;
-			} else if (a > 0) {
-				*px = (*px * (255-a) + color->Blue * a) / 255;
-				++px;
-				*px = (*px * (255-a) + color->Green * a) / 255;
-				++px;
-				*px = (*px * (255-a) + color->Red * a) / 255;
-				++px;
-				++px;
-			} else {
-				px += 4;
-			}
-		}
-		src_p += src_row_bytes;
-		dst_p += dst_row_bytes;
-	}
+	return (textarea->current + 1 + row) % textarea->line_nb;
 }
 
-static void ui_textarea_refresh_blt(ui_textarea_t *textarea)
+static void ui_textarea_render_row(ui_textarea_t *textarea, UINTN row)
 {
-	UINTN cur, i, j, x, y = 0;
+	static EFI_GRAPHICS_OUTPUT_BLT_PIXEL no_bg_color;
+	UINTN cur, i, j, k, x;
 	ui_font_t *font = textarea->font;
 	UINTN pixel_size = sizeof(*textarea->blt);
-	UINTN row_size = textarea->width * pixel_size;
-	EFI_GRAPHICS_OUTPUT_BLT_PIXEL *color;
-	EFI_GRAPHICS_OUTPUT_BLT_PIXEL *bg_color = textarea->bg_color;
-
-	ZeroMem(textarea->blt,
-		textarea->width * textarea->height * sizeof(*textarea->blt));
-
-	for (i = 1; i <= textarea->line_nb; i++) {
-		cur = (textarea->current + i) % textarea->line_nb;
-
-		color = textarea->color;
-		if (textarea->text[cur].color)
-			color = textarea->text[cur].color;
-
-		if (bg_color) {
-			UINTN x1;
-			for (x1 = 0; x1 < textarea->height * textarea->width; x1++)
-				CopyMem(textarea->blt + x1, bg_color,
-					sizeof(bg_color));
+	UINTN band = textarea->width * font->cheight;
+	EFI_GRAPHICS_OUTPUT_BLT_PIXEL *dst = textarea->blt + row * band;
+	EFI_GRAPHICS_OUTPUT_BLT_PIXEL *color, *glyph;
+	EFI_GRAPHICS_OUTPUT_BLT_PIXEL *bg_color = &no_bg_color;
+
+	cur = ui_textarea_row_line(textarea, row);
+
+	color = textarea->color;
+	if (textarea->text[cur].color)
+		color = textarea->text[cur].color;
+
+	if (textarea->bg_color) {
+		bg_color = textarea->bg_color;
+		for (i = 0; i < band; i++)
+			dst[i] = *bg_color;
+	} else
+		ZeroMem(dst, band * pixel_size);
+
+	unsigned char *s = (unsigned char *)textarea->text[cur].str;
+	for (x = 0, j = 0; s && *s && j < textarea->row_nb; s++, x += font->cwidth, j++) {
+		if (*s <= 0x20 || *s > 0x7E)
+			continue;
+		if (*s == '\n')
+			break;
+
+		glyph = ui_font_get_glyph(font, *s, textarea->text[cur].bold,
+					  color, bg_color);
+		if (!glyph) {
+			ui_font_draw_glyph(font, *s, textarea->text[cur].bold,
+					   color, dst + x, textarea->width);
+			continue;
 		}
 
-		unsigned char *s = (unsigned char *)textarea->text[cur].str;
-		for (x = 0, j = 0; s && *s && j < textarea->row_nb; s++, x += font->cwidth, j++) {
-			if (*s <= 0x20 || *s > 0x7E)
-				continue;
-			if (*s == '\n')
-				break;
-
-			unsigned char* src_p = font->texture + ((*s - 0x20) * font->cwidth)
-				+ (textarea->text[cur].bold ? font->cheight * font->width : 0);
-			unsigned char* dst_p = ((unsigned char *)textarea->blt)
-				+ (y * row_size)
-				+ (x * pixel_size);
-
-			ui_textarea_copy_char(src_p, font->width, dst_p, row_size,
-					      font->cwidth, font->cheight, color);
-		}
-		y += font->cheight;
+		for (k = 0; k < font->cheight; k++)
+			CopyMem(dst + k * textarea->width + x, glyph + k * font->cwidth,
+				font->cwidth * pixel_size);
 	}
 }
 
+static void ui_textarea_refresh_blt(ui_textarea_t *textarea)
+{
+	UINTN row;
+
+	for (row = 0; row < textarea->line_nb; row++)
+		ui_textarea_render_row(textarea, row);
+}
+
 EFI_STATUS ui_textarea_display_text(const ui_textline_t *text, ui_font_t *font,
 				    UINTN x, UINTN *y, UINTN width, UINTN height,
 				    EFI_GRAPHICS_OUTPUT_BLT_PIXEL *bg_color)
@@ -189,6 +178,7 @@ EFI_STATUS ui_textarea_display_text(const ui_textline_t *text, ui_font_t *font,
 	if (!line_nb || !row_nb)
 		return EFI_INVALID_PARAMETER;
 
+	ZeroMem(&textarea, sizeof(textarea));
 	textarea.line_nb = line_nb;
 	textarea.row_nb = row_nb;
 	textarea.text = (ui_textline_t *)text;
@@ -211,6 +201,7 @@ void ui_textarea_free(ui_textarea_t *textarea)
 	ui_textarea_clear(textarea);
 	FreePool(textarea->blt);
 	FreePool(textarea->text);
+	FreePool(textarea->dirty);
 	FreePool(textarea);
 }
 
@@ -225,6 +216,12 @@ void ui_textarea_clear(ui_textarea_t *textarea)
 		}
 
 	textarea->current = -1;
+	ui_textarea_invalidate(textarea);
+}
+
+void ui_textarea_invalidate(ui_textarea_t *textarea)
+{
+	textarea->drawn = FALSE;
 }
 
 void ui_textarea_set_line(ui_textarea_t *textarea, UINTN line_nb, char *str,
@@ -233,6 +230,7 @@ void ui_textarea_set_line(ui_textarea_t *textarea, UINTN line_nb, char *str,
 	textarea->text[line_nb].str = str;
 	textarea->text[line_nb].color = color;
 	textarea->text[line_nb].bold = bold;
+	textarea->dirty[line_nb] = TRUE;
 }
 
 void ui_textarea_set_line_n(ui_textarea_t *textarea, UINTN line_nb, char *str,
@@ -267,12 +265,14 @@ void ui_textarea_set_line_n(ui_textarea_t *textarea, UINTN line_nb, char *str,
 	textarea->text[line_nb].str = newbuf;
 	textarea->text[line_nb].color = color;
 	textarea->text[line_nb].bold = bold;
+	textarea->dirty[line_nb] = TRUE;
 }
 
 void ui_textarea_newline(ui_textarea_t *textarea, char *str,
 			 EFI_GRAPHICS_OUTPUT_BLT_PIXEL *color, BOOLEAN bold)
 {
 	textarea->current = (textarea->current + 1) % textarea->line_nb;
+	textarea->scroll++;
 
 	if (textarea->text[textarea->current].str)
 		FreePool(textarea->text[textarea->current].str);
@@ -302,20 +302,81 @@ EFI_STATUS ui_textarea_draw_scale(ui_textarea_t *textarea, UINTN x, UINTN *y,
 	if (!scaled_blt)
 		return EFI_OUT_OF_RESOURCES;
 
-	ui_bilinear_scale((unsigned char *)textarea->blt,
-			  (unsigned char *)scaled_blt,
-			  textarea->width, textarea->height,
-			  new_width, new_height,
-			  sizeof(EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
-	ret = ui_draw_blt(scaled_blt, x, *y, new_width, new_height);
+	ret = ui_bilinear_scale(textarea->blt, scaled_blt,
+				textarea->width, textarea->height,
+				new_width, new_height);
+	if (!EFI_ERROR(ret))
+		ret = ui_draw_blt(scaled_blt, x, *y, new_width, new_height);
 	FreePool(scaled_blt);
 	*y += new_height;
 
 	return ret;
 }
 
-EFI_STATUS ui_textarea_draw(ui_textarea_t *textarea, UINTN x, UINTN y)
+static EFI_STATUS ui_textarea_draw_full(ui_textarea_t *textarea, UINTN x, UINTN y)
 {
 	ui_textarea_refresh_blt(textarea);
 	return ui_draw_blt(textarea->blt, x, y, textarea->width, textarea->height);
 }
+
+/* Scroll the displayed area up by TEXTAREA->scroll lines, both in the
+ * blt buffer and on screen, so that only the new lines need to be
+ * rendered. */
+static EFI_STATUS ui_textarea_scroll(ui_textarea_t *textarea, UINTN x, UINTN y)
+{
+	UINTN shift = textarea->scroll * textarea->font->cheight;
+	UINTN height = textarea->height - shift;
+
+	memmove(textarea->blt, textarea->blt + shift * textarea->width,
+		height * textarea->width * sizeof(*textarea->blt));
+
+	return ui_move_area(x, y + shift, x, y, textarea->width, height);
+}
+
+EFI_STATUS ui_textarea_draw(ui_textarea_t *textarea, UINTN x, UINTN y)
+{
+	EFI_STATUS ret = EFI_SUCCESS;
+	UINTN cheight = textarea->font->cheight;
+	UINTN row, first;
+
+	if (!textarea->drawn || textarea->drawn_x != x || textarea->drawn_y != y
+	    || textarea->scroll >= textarea->line_nb) {
+		ret = ui_textarea_draw_full(textarea, x, y);
+		goto out;
+	}
+
+	if (textarea->scroll) {
+		ret = ui_textarea_scroll(textarea, x, y);
+		if (EFI_ERROR(ret)) {
+			ret = ui_textarea_draw_full(textarea, x, y);
+			goto out;
+		}
+	}
+
+	/* Render and draw each run of consecutive dirty lines with
+	 * a single blt. */
+	for (row = 0; row < textarea->line_nb; ) {
+		if (!textarea->dirty[ui_textarea_row_line(textarea, row)]) {
+			row++;
+			continue;
+		}
+
+		for (first = row; row < textarea->line_nb &&
+			     textarea->dirty[ui_textarea_row_line(textarea, row)]; row++)
+			ui_textarea_render_row(textarea, row);
+
+		ret = ui_draw_blt(textarea->blt + first * cheight * textarea->width,
+				  x, y + first * cheight, textarea->width,
+				  (row - first) * cheight);
+		if (EFI_ERROR(ret))
+			break;
+	}
+
+out:
+	ZeroMem(textarea->dirty, textarea->line_nb * sizeof(*textarea->dirty));
+	textarea->scroll = 0;
+	textarea->drawn = !EFI_ERROR(ret);
+	textarea->drawn_x = x;
+	textarea->drawn_y = y;
+	return ret;
+}
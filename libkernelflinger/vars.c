@@ -57,6 +57,7 @@
 #define REBOOT_REASON		L"LoaderEntryRebootReason"
 #ifndef USER
 #define SLOT_FALLBACK		L"SlotFallback"
+#define VB_DIGEST_CACHE		L"VbDigestCache"
 #endif
 #define ROLLBACK_INDEX_FMT		L"RollbackIndex_%04x"
 #define LOADED_SLOT		L"LoadedSlot"
@@ -103,6 +104,7 @@ static bool_value_t update_oemvars;
 static bool_value_t ui_display_splash;
 #ifndef USER
 static bool_value_t slot_fallback;
+static bool_value_t vb_digest_cache;
 #endif
 
 CHAR16 *boot_state_to_string(UINT8 boot_state)
@@ -230,6 +232,27 @@ EFI_STATUS set_slot_fallback(BOOLEAN enabled)
 #endif
 }
 
+BOOLEAN get_vb_digest_cache(void)
+{
+#ifndef USER
+	return get_current_boolean_var(&fastboot_guid, VB_DIGEST_CACHE,
+				       &vb_digest_cache, FALSE);
+#else
+	return FALSE;
+#endif
+}
+
+EFI_STATUS set_vb_digest_cache(BOOLEAN enabled)
+{
+#ifndef USER
+	return set_boolean_var(&fastboot_guid, VB_DIGEST_CACHE,
+			       &vb_digest_cache, enabled, FALSE);
+#else
+	(void)enabled;	/* Unused parameter.  */
+	return EFI_UNSUPPORTED;
+#endif
+}
+
 static void set_provisioning_mode(BOOLEAN provisioning)
 {
 	provisioning_mode = provisioning;
@@ -35,6 +35,10 @@ LOCAL_SRC_FILES := \
 	keymaster.c \
 	keymaster_serializable.c \
 
+ifneq ($(KERNELFLINGER_TRUSTY_IPC_BUFFER_PAGES),)
+LOCAL_CFLAGS += -DTRUSTY_QL_TIPC_BUFFER_PAGES=$(KERNELFLINGER_TRUSTY_IPC_BUFFER_PAGES)
+endif
+
 ifeq ($(KERNELFLINGER_TRUSTY_PLATFORM),vsbl)
 LOCAL_CFLAGS += -DHYPERVISOR_ACRN
 endif
@@ -40,6 +40,13 @@
 #endif
 #endif
 
-#define TRUSTY_QL_TIPC_MAX_BUFFER_LEN PAGE_SIZE
+/* Number of pages shared with the secure OS for IPC messages. Larger
+ * buffers let big requests such as attestation certificates be sent as a
+ * single multi-page message. */
+#ifndef TRUSTY_QL_TIPC_BUFFER_PAGES
+#define TRUSTY_QL_TIPC_BUFFER_PAGES 1
+#endif
+
+#define TRUSTY_QL_TIPC_MAX_BUFFER_LEN (TRUSTY_QL_TIPC_BUFFER_PAGES * PAGE_SIZE)
 
 #endif
@@ -206,6 +206,27 @@ int trusty_ipc_dev_send(struct trusty_ipc_dev* dev,
                         handle_t chan,
                         const struct trusty_ipc_iovec* iovs,
                         size_t iovs_cnt);
+/*
+ * Returns the payload area of the shared buffer of @dev and stores its
+ * capacity in @buf_len. Callers may serialize a message directly into it
+ * and pass it to trusty_ipc_dev_send_inplace without an intermediate copy.
+ * The contents are only valid until the next call into the secure OS.
+ *
+ * @dev:     Trusty IPC device
+ * @buf_len: pointer to output capacity of the payload area
+ */
+void* trusty_ipc_dev_send_buf(struct trusty_ipc_dev* dev, size_t* buf_len);
+/*
+ * Calls into secure OS to send the @msg_size bytes already written to the
+ * buffer returned by trusty_ipc_dev_send_buf. Returns a trusty_err.
+ *
+ * @dev:      Trusty IPC device
+ * @chan:     handle for connection
+ * @msg_size: number of payload bytes to be sent
+ */
+int trusty_ipc_dev_send_inplace(struct trusty_ipc_dev* dev,
+                                handle_t chan,
+                                size_t msg_size);
 /*
  * Calls into secure OS to receive message on channel. Returns number of bytes
  * received on success, trusty_err on failure.
@@ -260,6 +281,19 @@ int trusty_ipc_send(struct trusty_ipc_chan* chan,
                     const struct trusty_ipc_iovec* iovs,
                     size_t iovs_cnt,
                     bool wait);
+/*
+ * Calls trusty_ipc_dev_send_inplace to send a message serialized into the
+ * buffer returned by trusty_ipc_dev_send_buf. If the channel is blocked and
+ * @wait is set, the message is saved before waiting since polling for events
+ * reuses the shared buffer. Returns a trusty_err.
+ *
+ * @chan:     handle for connection
+ * @msg_size: number of payload bytes to be sent
+ * @wait:     flag to wait for send to complete
+ */
+int trusty_ipc_send_inplace(struct trusty_ipc_chan* chan,
+                            size_t msg_size,
+                            bool wait);
 /*
  * Calls trusty_ipc_dev_recv to receive a message. Return number of bytes
  * received on success, trusty_err on failure.
@@ -168,6 +168,35 @@ Again:
     return rc;
 }
 
+int trusty_ipc_send_inplace(struct trusty_ipc_chan* chan,
+                            size_t msg_size,
+                            bool wait) {
+    int rc;
+    size_t buf_len;
+    void* buf;
+    struct trusty_ipc_iovec iov;
+
+    trusty_assert(chan);
+    trusty_assert(chan->dev);
+    trusty_assert(chan->handle);
+
+    rc = trusty_ipc_dev_send_inplace(chan->dev, chan->handle, msg_size);
+    if (rc != TRUSTY_ERR_SEND_BLOCKED || !wait)
+        return rc;
+
+    /* waiting reuses the shared buffer, keep a copy of the message */
+    buf = trusty_ipc_dev_send_buf(chan->dev, &buf_len);
+    iov.len = msg_size;
+    iov.base = trusty_calloc(1, msg_size);
+    if (!iov.base)
+        return TRUSTY_ERR_NO_MEMORY;
+    trusty_memcpy(iov.base, buf, msg_size);
+
+    rc = trusty_ipc_send(chan, &iov, 1, true);
+    trusty_free(iov.base);
+    return rc;
+}
+
 int trusty_ipc_recv(struct trusty_ipc_chan* chan,
                     const struct trusty_ipc_iovec* iovs,
                     size_t iovs_cnt,
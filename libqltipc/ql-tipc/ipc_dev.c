@@ -421,17 +421,21 @@ int trusty_ipc_dev_get_event(struct trusty_ipc_dev* dev,
     return TRUSTY_ERR_NONE;
 }
 
-int trusty_ipc_dev_send(struct trusty_ipc_dev* dev,
-                        handle_t chan,
-                        const struct trusty_ipc_iovec* iovs,
-                        size_t iovs_cnt) {
+void* trusty_ipc_dev_send_buf(struct trusty_ipc_dev* dev, size_t* buf_len) {
+    trusty_assert(dev);
+    trusty_assert(buf_len);
+
+    *buf_len = dev->buf_size - sizeof(struct trusty_ipc_cmd_hdr);
+    return (uint8_t*)dev->buf_vaddr + sizeof(struct trusty_ipc_cmd_hdr);
+}
+
+int trusty_ipc_dev_send_inplace(struct trusty_ipc_dev* dev,
+                                handle_t chan,
+                                size_t msg_size) {
     int rc;
-    size_t msg_size;
     volatile struct trusty_ipc_cmd_hdr* cmd;
 
     trusty_assert(dev);
-    /* calc message length */
-    msg_size = iovec_size(iovs, iovs_cnt);
     if (msg_size > dev->buf_size - sizeof(*cmd)) {
         /* msg is too big to fit provided buffer */
         trusty_error("%s: chan %d: msg is too long (%zu)\n", __func__, chan,
@@ -439,17 +443,12 @@ int trusty_ipc_dev_send(struct trusty_ipc_dev* dev,
         return TRUSTY_ERR_MSG_TOO_BIG;
     }
 
-    /* prepare command */
+    /* prepare command, payload is already in place */
     cmd = dev->buf_vaddr;
     trusty_memset((void*)cmd, 0, sizeof(*cmd));
     cmd->opcode = QL_TIPC_DEV_SEND;
     cmd->handle = chan;
-
-    /* copy in message data */
     cmd->payload_len = (uint32_t)msg_size;
-    msg_size = iovec_to_buf(dev->buf_vaddr + sizeof(*cmd),
-                            dev->buf_size - sizeof(*cmd), iovs, iovs_cnt);
-    trusty_assert(msg_size == (size_t)cmd->payload_len);
 
     /* call into secure os */
     rc = trusty_dev_exec_ipc(dev->tdev, dev->buf_id,
@@ -467,6 +466,33 @@ int trusty_ipc_dev_send(struct trusty_ipc_dev* dev,
     return rc;
 }
 
+int trusty_ipc_dev_send(struct trusty_ipc_dev* dev,
+                        handle_t chan,
+                        const struct trusty_ipc_iovec* iovs,
+                        size_t iovs_cnt) {
+    size_t msg_size;
+    size_t copied;
+    size_t buf_len;
+    void* buf;
+
+    trusty_assert(dev);
+    /* calc message length */
+    msg_size = iovec_size(iovs, iovs_cnt);
+    buf = trusty_ipc_dev_send_buf(dev, &buf_len);
+    if (msg_size > buf_len) {
+        /* msg is too big to fit provided buffer */
+        trusty_error("%s: chan %d: msg is too long (%zu)\n", __func__, chan,
+                     msg_size);
+        return TRUSTY_ERR_MSG_TOO_BIG;
+    }
+
+    /* copy in message data */
+    copied = iovec_to_buf(buf, buf_len, iovs, iovs_cnt);
+    trusty_assert(copied == msg_size);
+
+    return trusty_ipc_dev_send_inplace(dev, chan, copied);
+}
+
 int trusty_ipc_dev_recv(struct trusty_ipc_dev* dev,
                         handle_t chan,
                         const struct trusty_ipc_iovec* iovs,
@@ -181,24 +181,16 @@ static int km_read_data_response(uint32_t cmd, int32_t *error,
 }
 
 /**
- * Convenience method to send a request to the secure side
- * and receive the response. If |resp_data| is not NULL, the
- * caller expects an additional data buffer to be returned from the secure
- * side.
+ * Reads the response to |cmd| and checks the keymaster error code. If
+ * |resp_data| is not NULL, the response carries an additional data buffer
+ * that is returned in |resp_data|.
  */
-static int km_do_tipc(uint32_t cmd, void* req,
-                      uint32_t req_len, void* resp_data,
-                      uint32_t* resp_data_len)
+static int km_read_response(uint32_t cmd, void* resp_data,
+                            uint32_t* resp_data_len)
 {
     int rc = TRUSTY_ERR_GENERIC;
     struct km_no_response resp_header  = { .error = 0 };
 
-    rc = km_send_request(cmd, req, req_len);
-    if (rc < 0) {
-        trusty_error("%s: failed (%d) to send km request\n", __func__, rc);
-        return rc;
-    }
-
     if (!resp_data) {
         rc = km_read_raw_response(cmd, &resp_header, sizeof(resp_header));
     } else {
@@ -218,6 +210,65 @@ static int km_do_tipc(uint32_t cmd, void* req,
     return TRUSTY_ERR_NONE;
 }
 
+/**
+ * Convenience method to send a request to the secure side
+ * and receive the response. If |resp_data| is not NULL, the
+ * caller expects an additional data buffer to be returned from the secure
+ * side.
+ */
+static int km_do_tipc(uint32_t cmd, void* req,
+                      uint32_t req_len, void* resp_data,
+                      uint32_t* resp_data_len)
+{
+    int rc = km_send_request(cmd, req, req_len);
+
+    if (rc < 0) {
+        trusty_error("%s: failed (%d) to send km request\n", __func__, rc);
+        return rc;
+    }
+    return km_read_response(cmd, resp_data, resp_data_len);
+}
+
+/**
+ * Returns a pointer to the request area of the shared IPC buffer, right after
+ * the keymaster_message header, if a request of |req_len| bytes fits in it.
+ * The caller serializes the request there and sends it with
+ * km_do_tipc_inplace(), avoiding the intermediate request allocation and
+ * the copy into the shared buffer. Returns NULL if the request does not fit.
+ */
+static uint8_t *km_request_buf(uint32_t req_len)
+{
+    size_t buf_len;
+    uint8_t *buf = trusty_ipc_dev_send_buf(km_chan.dev, &buf_len);
+
+    if (buf_len < sizeof(struct keymaster_message) ||
+        req_len > buf_len - sizeof(struct keymaster_message)) {
+        return NULL;
+    }
+    return buf + sizeof(struct keymaster_message);
+}
+
+/**
+ * Same as km_do_tipc() for a request of |req_len| bytes already serialized
+ * into the buffer returned by km_request_buf().
+ */
+static int km_do_tipc_inplace(uint32_t cmd, uint32_t req_len,
+                              void* resp_data, uint32_t* resp_data_len)
+{
+    size_t buf_len;
+    struct keymaster_message header = { .cmd = cmd };
+    uint8_t *buf = trusty_ipc_dev_send_buf(km_chan.dev, &buf_len);
+    int rc;
+
+    trusty_memcpy(buf, &header, sizeof(header));
+    rc = trusty_ipc_send_inplace(&km_chan, sizeof(header) + req_len, true);
+    if (rc < 0) {
+        trusty_error("%s: failed (%d) to send km request\n", __func__, rc);
+        return rc;
+    }
+    return km_read_response(cmd, resp_data, resp_data_len);
+}
+
 static int32_t MessageVersion(uint8_t major_ver, uint8_t minor_ver,
                               uint8_t subminor_ver) {
     UNUSED(subminor_ver);
@@ -468,9 +519,21 @@ static int trusty_send_attestation_data(uint32_t cmd, const uint8_t *data,
         .data = (uint8_t *)data,
     };
     uint8_t *req = NULL;
-    uint32_t req_size = 0;
-    int rc = km_attestation_data_serialize(&attestation_data, &req, &req_size);
+    uint32_t req_size = sizeof(attestation_data.algorithm) +
+                        sizeof(attestation_data.data_size) + data_size;
+    uint8_t *buf = km_request_buf(req_size);
+    int rc;
+
+    /* Certificates and keys are the bulk of the provisioning traffic,
+     * serialize them straight into the shared buffer when they fit.
+     */
+    if (buf) {
+        buf = append_uint32_to_buf(buf, attestation_data.algorithm);
+        append_sized_buf_to_buf(buf, attestation_data.data, data_size);
+        return km_do_tipc_inplace(cmd, req_size, NULL, NULL);
+    }
 
+    rc = km_attestation_data_serialize(&attestation_data, &req, &req_size);
     if (rc < 0) {
         trusty_error("failed (%d) to serialize request\n", rc);
         goto end;
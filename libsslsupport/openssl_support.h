@@ -20,4 +20,9 @@ typedef struct {
 
 struct tm;
 
+/* Largest number of bytes and chunks held at once through malloc()
+ * since the start or the last mem_stats_reset_peak() */
+void mem_stats_get_peak(UINTN *bytes, UINTN *chunks);
+void mem_stats_reset_peak(void);
+
 #endif 	/* _OPENSSL_SUPPORT_H_ */
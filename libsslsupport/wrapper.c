@@ -741,27 +741,67 @@ int tcgetattr(int fd, void *termios_p)
 }
 
 /* UEFI ReallocatePool needs the old size information, which we don't have.
- * These wrappers of malloc, free and realloc keeps track of allocated
- * memory to be able to get the old size information.
- * The static table mem might be too small.
- * When this code has been written, we have counted a maximun of 450
- * allocated chunks during a secure boot use case */
+ * These wrappers of malloc, free and realloc store the size in a header
+ * placed right before the returned pointer.  AllocatePool() only
+ * guarantees 8 bytes alignment: the header is padded to 16 bytes so the
+ * returned pointer keeps the alignment of the pool buffer, but it is
+ * not aligned on 16 bytes unless the pool buffer is. */
+#define MEM_CHUNK_MAGIC 0x4d454d43	/* MEMC */
+
 typedef struct mem_chunk {
-	void *addr;
 	size_t size;
-} mem_chunk_t;
-static mem_chunk_t mem[1024];
+	UINT32 magic;
+} __attribute__((aligned(16))) mem_chunk_t;
+
+static struct {
+	size_t used;
+	size_t peak;
+	size_t chunks;
+	size_t peak_chunks;
+} mem_stats;
 
-static inline mem_chunk_t *search_mem(void *addr)
+static inline mem_chunk_t *get_chunk(void *addr)
 {
-	unsigned int i;
+	mem_chunk_t *mc = (mem_chunk_t *)addr - 1;
 
-	for (i = 0; i < ARRAY_SIZE(mem) && mem[i].addr != addr; i++)
-		;
+	return mc->magic == MEM_CHUNK_MAGIC ? mc : NULL;
+}
 
-	if (i == ARRAY_SIZE(mem))
-		return NULL;
-	return &mem[i];
+static void mem_stats_add(size_t size)
+{
+	mem_stats.used += size;
+	mem_stats.chunks++;
+	if (mem_stats.used > mem_stats.peak)
+		mem_stats.peak = mem_stats.used;
+	if (mem_stats.chunks > mem_stats.peak_chunks) {
+		mem_stats.peak_chunks = mem_stats.chunks;
+		/* Report each power of two, this is mostly useful to
+		 * size the allocations of crypto heavy flows. */
+		if (!(mem_stats.peak_chunks & (mem_stats.peak_chunks - 1)))
+			debug(L"malloc peak: %ld chunks, %ld bytes",
+			      mem_stats.peak_chunks, mem_stats.peak);
+	}
+}
+
+static void mem_stats_del(size_t size)
+{
+	mem_stats.used -= size;
+	mem_stats.chunks--;
+}
+
+void mem_stats_get_peak(UINTN *bytes, UINTN *chunks)
+{
+	if (bytes)
+		*bytes = mem_stats.peak;
+	if (chunks)
+		*chunks = mem_stats.peak_chunks;
+}
+
+/* The peaks start again from what is currently allocated */
+void mem_stats_reset_peak(void)
+{
+	mem_stats.peak = mem_stats.used;
+	mem_stats.peak_chunks = mem_stats.chunks;
 }
 
 void *malloc(size_t size)
@@ -770,15 +810,19 @@ void *malloc(size_t size)
 {
 	mem_chunk_t *mc;
 
-	mc = search_mem(NULL);
+	if (size > (size_t)-1 - sizeof(*mc))
+		return NULL;
+
+	mc = AllocatePool(sizeof(*mc) + size);
 	if (!mc) {
-		error(L"malloc failed, wrapper allocator is full!");
+		error(L"malloc of %d bytes failed", size);
 		return NULL;
 	}
 
-	mc->addr = AllocatePool(size);
 	mc->size = size;
-	return mc->addr;
+	mc->magic = MEM_CHUNK_MAGIC;
+	mem_stats_add(size);
+	return mc + 1;
 }
 
 void free(void *addr)
@@ -790,31 +834,48 @@ void free(void *addr)
 	if (!addr)
 		return;
 
-	mc = search_mem(addr);
+	mc = get_chunk(addr);
 	if (!mc) {
 		error(L"Tried to free an unknown pointer");
 		return;
 	}
 
-	FreePool(addr);
-	mc->addr = NULL;
+	mem_stats_del(mc->size);
+	mc->magic = 0;
+	FreePool(mc);
 }
 
 void *realloc(void *ptr, size_t size)
 	__attribute__((weak));
 void *realloc(void *ptr, size_t size)
 {
-	mem_chunk_t *mc;
+	mem_chunk_t *mc, *new;
+	size_t old_size;
+
+	if (!ptr)
+		return malloc(size);
 
-	mc = search_mem(ptr);
+	mc = get_chunk(ptr);
 	if (!mc) {
 		error(L"Tried to realloc an unknown pointer");
 		return NULL;
 	}
 
-	mc->addr = ReallocatePool(ptr, (UINTN)mc->size, (UINTN) size);
-	mc->size = size;
-	return mc->addr;
+	if (size > (size_t)-1 - sizeof(*mc))
+		return NULL;
+
+	old_size = mc->size;
+	mem_stats_del(old_size);
+
+	/* ReallocatePool() frees the old buffer even on failure */
+	new = ReallocatePool(mc, (UINTN)(sizeof(*mc) + old_size),
+			     (UINTN)(sizeof(*mc) + size));
+	if (!new)
+		return NULL;
+
+	new->size = size;
+	mem_stats_add(size);
+	return new + 1;
 }
 
 void *memchr(const void *s, int c, size_t n)
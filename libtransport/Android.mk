@@ -11,6 +11,7 @@ LOCAL_STATIC_LIBRARIES := \
 LOCAL_EXPORT_C_INCLUDE_DIRS := $(LOCAL_PATH)/../include/libtransport
 LOCAL_C_INCLUDES := $(LOCAL_PATH)/../include/libtransport
 LOCAL_SRC_FILES := \
-	transport.c
+	transport.c \
+	loopback.c
 
 include $(BUILD_EFI_STATIC_LIBRARY)
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2026, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <lib.h>
+#include <transport.h>
+#include <loopback.h>
+
+static loopback_peer_t *peer;
+static BOOLEAN started;
+
+static start_callback_t start_callback;
+static data_callback_t rx_callback;
+static data_callback_t tx_callback;
+
+/* Buffer posted by the device with loopback_read() */
+static struct {
+	void *buf;
+	UINT32 size;
+	BOOLEAN posted;
+} rx;
+
+/* Buffer written by the device, completed at the next run */
+static struct {
+	void *buf;
+	UINT32 size;
+	BOOLEAN pending;
+} tx;
+
+/* Data sent by the peer and not consumed by the device yet.  It is
+ * delivered in pieces no bigger than the posted read buffer, like a
+ * USB bulk transfer. */
+static struct {
+	const UINT8 *data;
+	UINTN size;
+} in;
+
+EFI_STATUS loopback_attach(loopback_peer_t *p)
+{
+	if (!p || !p->poll || !p->receive)
+		return EFI_INVALID_PARAMETER;
+
+	peer = p;
+	return EFI_SUCCESS;
+}
+
+void loopback_detach(void)
+{
+	peer = NULL;
+}
+
+/* BUF must stay valid until the device consumed it, which is the case
+ * when the peer poll callback is called again. */
+EFI_STATUS loopback_send(const void *buf, UINTN size)
+{
+	if (!buf || !size)
+		return EFI_INVALID_PARAMETER;
+
+	if (in.size)
+		return EFI_NOT_READY;
+
+	in.data = buf;
+	in.size = size;
+	return EFI_SUCCESS;
+}
+
+EFI_STATUS loopback_start(start_callback_t start_cb,
+			  data_callback_t rx_cb,
+			  data_callback_t tx_cb)
+{
+	if (!peer)
+		return EFI_UNSUPPORTED;
+
+	start_callback = start_cb;
+	rx_callback = rx_cb;
+	tx_callback = tx_cb;
+
+	ZeroMem(&rx, sizeof(rx));
+	ZeroMem(&tx, sizeof(tx));
+	ZeroMem(&in, sizeof(in));
+	started = FALSE;
+
+	return EFI_SUCCESS;
+}
+
+EFI_STATUS loopback_stop(void)
+{
+	started = FALSE;
+	return EFI_SUCCESS;
+}
+
+EFI_STATUS loopback_run(void)
+{
+	EFI_STATUS ret;
+	UINT32 size;
+
+	if (!peer)
+		return EFI_NOT_STARTED;
+
+	if (!started) {
+		started = TRUE;
+		start_callback();
+		return EFI_SUCCESS;
+	}
+
+	if (tx.pending) {
+		tx.pending = FALSE;
+		tx_callback(tx.buf, tx.size);
+	}
+
+	if (!rx.posted)
+		return EFI_SUCCESS;
+
+	if (!in.size) {
+		ret = peer->poll();
+		if (ret == EFI_NOT_READY)
+			return EFI_SUCCESS;
+		if (EFI_ERROR(ret))
+			return ret;
+		if (!in.size)
+			return EFI_SUCCESS;
+	}
+
+	size = min((UINTN)rx.size, in.size);
+	ret = memcpy_s(rx.buf, rx.size, in.data, size);
+	if (EFI_ERROR(ret))
+		return ret;
+
+	in.data += size;
+	in.size -= size;
+	rx.posted = FALSE;
+	rx_callback(rx.buf, size);
+
+	return EFI_SUCCESS;
+}
+
+EFI_STATUS loopback_read(void *buf, UINT32 size)
+{
+	if (!buf || !size)
+		return EFI_INVALID_PARAMETER;
+
+	if (rx.posted)
+		return EFI_NOT_READY;
+
+	rx.buf = buf;
+	rx.size = size;
+	rx.posted = TRUE;
+	return EFI_SUCCESS;
+}
+
+EFI_STATUS loopback_write(void *buf, UINT32 size)
+{
+	if (!peer)
+		return EFI_NOT_STARTED;
+
+	if (tx.pending)
+		return EFI_NOT_READY;
+
+	peer->receive(buf, size);
+
+	tx.buf = buf;
+	tx.size = size;
+	tx.pending = TRUE;
+	return EFI_SUCCESS;
+}
@@ -19,14 +19,39 @@
 /*
  * Simple checksum for a buffer.
  *
+ * The bytes are summed a 64-bit word at a time: the even and odd bytes
+ * of each word are added to four 16-bit lanes, which are folded into
+ * the result before they can overflow.
+ *
  * @param addr pointer to the start of the buffer.
  * @param size size of the buffer in bytes.
  * @return check sum result.
  */
 static uint32_t checksum(const unsigned char* const buffer, uint32_t size) {
+    const uint64_t mask = 0x00ff00ff00ff00ffULL;
+    const unsigned char* p = buffer;
+    const unsigned char* end = buffer + size;
     uint32_t sum = 0;
-    for (uint32_t i = 0; i < size; i++) {
-        sum += buffer[i];
+
+    while (p < end && ((UINTN)p & (sizeof(uint64_t) - 1))) {
+        sum += *p++;
+    }
+
+    while ((UINTN)(end - p) >= sizeof(uint64_t)) {
+        uint64_t lanes = 0;
+        // each word adds at most 2 * 0xff to a lane
+        for (uint32_t n = 0; n < 128 && (UINTN)(end - p) >= sizeof(uint64_t);
+             n++, p += sizeof(uint64_t)) {
+            uint64_t word;
+            __builtin_memcpy(&word, p, sizeof(word));
+            lanes += (word & mask) + ((word >> 8) & mask);
+        }
+        sum += (uint32_t)((lanes & 0xffff) + ((lanes >> 16) & 0xffff) +
+                          ((lanes >> 32) & 0xffff) + (lanes >> 48));
+    }
+
+    while (p < end) {
+        sum += *p++;
     }
     return sum;
 }
@@ -43,37 +68,127 @@ static BOOLEAN isTrailerPresent(uint64_t bootconfig_end_addr) {
                     BOOTCONFIG_MAGIC, BOOTCONFIG_MAGIC_SIZE);
 }
 
+/*
+ * Write the trailer after the |size| bytes of parameters at |start|.
+ */
+static void writeTrailer(uint64_t start, uint32_t size, uint32_t sum) {
+    uint64_t end = start + size;
+
+    // size
+    memcpy_s((void *)(end), BOOTCONFIG_SIZE_SIZE, &size, BOOTCONFIG_SIZE_SIZE);
+
+    // checksum
+    memcpy_s((void *)(end + BOOTCONFIG_SIZE_SIZE), BOOTCONFIG_CHECKSUM_SIZE, &sum,
+        BOOTCONFIG_CHECKSUM_SIZE);
+
+    // magic
+    memcpy_s((void *)(end + BOOTCONFIG_SIZE_SIZE + BOOTCONFIG_CHECKSUM_SIZE),
+           BOOTCONFIG_MAGIC_SIZE, BOOTCONFIG_MAGIC, BOOTCONFIG_MAGIC_SIZE);
+}
+
+/*
+ * Start building a boot config section.
+ */
+int32_t initBootConfigBuilder(struct BootConfigBuilder* builder,
+    uint64_t bootconfig_start_addr, uint32_t bootconfig_size,
+    uint32_t capacity) {
+    if (!builder || !bootconfig_start_addr) {
+        return -1;
+    }
+    if (bootconfig_size > capacity) {
+        return -1;
+    }
+
+    builder->start = bootconfig_start_addr;
+    builder->size = bootconfig_size;
+    builder->capacity = capacity;
+
+    // the parameters of a finalized section are appended to
+    if (bootconfig_size >= BOOTCONFIG_TRAILER_SIZE &&
+        isTrailerPresent(bootconfig_start_addr + bootconfig_size)) {
+        memcpy_s(&builder->size, BOOTCONFIG_SIZE_SIZE,
+            (void *)(bootconfig_start_addr + bootconfig_size - BOOTCONFIG_TRAILER_SIZE),
+            BOOTCONFIG_SIZE_SIZE);
+        if (builder->size > bootconfig_size - BOOTCONFIG_TRAILER_SIZE) {
+            return -1;
+        }
+    }
+
+    builder->checksum = checksum((unsigned char*)bootconfig_start_addr,
+                                 builder->size);
+    return 0;
+}
+
+/*
+ * Append a string of boot config parameters to the section.
+ */
+int32_t appendBootConfigParameters(struct BootConfigBuilder* builder,
+    const char* params, uint32_t params_size) {
+    if (!builder || !params) {
+        return -1;
+    }
+    if (params_size > builder->capacity - builder->size ||
+        BOOTCONFIG_TRAILER_SIZE > builder->capacity - builder->size - params_size) {
+        return -1;
+    }
+
+    memcpy_s((void *)(builder->start + builder->size),
+        builder->capacity - builder->size, params, params_size);
+    builder->checksum += checksum((const unsigned char*)params, params_size);
+    builder->size += params_size;
+
+    return params_size;
+}
+
+/*
+ * Write the trailer of the section.
+ */
+int32_t finalizeBootConfig(struct BootConfigBuilder* builder) {
+    if (!builder) {
+        return -1;
+    }
+    if (builder->size == 0) {
+        return 0;
+    }
+    if (BOOTCONFIG_TRAILER_SIZE > builder->capacity - builder->size) {
+        return -1;
+    }
+
+    writeTrailer(builder->start, builder->size, builder->checksum);
+    return builder->size + BOOTCONFIG_TRAILER_SIZE;
+}
+
 /*
  * Add a string of boot config parameters to memory appended by the trailer.
  */
 int32_t addBootConfigParameters(char* params, uint32_t params_size,
     uint64_t bootconfig_start_addr, uint32_t bootconfig_size) {
+    struct BootConfigBuilder builder;
+    int32_t ret;
+
     if (!params || !bootconfig_start_addr) {
         return -1;
     }
     if (params_size == 0) {
         return 0;
     }
-    int32_t applied_bytes = 0;
-    int32_t new_size = 0;
-    uint64_t end = bootconfig_start_addr + bootconfig_size;
 
-    if (isTrailerPresent(end)) {
-      end -= BOOTCONFIG_TRAILER_SIZE;
-      applied_bytes -= BOOTCONFIG_TRAILER_SIZE;
-      memcpy_s(&new_size, BOOTCONFIG_SIZE_SIZE, (void *)end, BOOTCONFIG_SIZE_SIZE);
-    } else {
-      new_size = bootconfig_size;
+    // the caller guarantees the room for the parameters and the trailer
+    ret = initBootConfigBuilder(&builder, bootconfig_start_addr, bootconfig_size,
+        bootconfig_size + params_size + BOOTCONFIG_TRAILER_SIZE);
+    if (ret < 0) {
+        return ret;
+    }
+    ret = appendBootConfigParameters(&builder, params, params_size);
+    if (ret < 0) {
+        return ret;
+    }
+    ret = finalizeBootConfig(&builder);
+    if (ret < 0) {
+        return ret;
     }
 
-    // params
-    memcpy_s((void*)end, params_size, params, params_size);
-
-    applied_bytes += params_size;
-    applied_bytes += addBootConfigTrailer(bootconfig_start_addr,
-        bootconfig_size + applied_bytes);
-
-    return applied_bytes;
+    return ret - bootconfig_size;
 }
 
 /*
@@ -94,18 +209,8 @@ int32_t addBootConfigTrailer(uint64_t bootconfig_start_addr,
         return 0;
     }
 
-    // size
-    memcpy_s((void *)(end), BOOTCONFIG_SIZE_SIZE, &bootconfig_size, BOOTCONFIG_SIZE_SIZE);
-
-    // checksum
-    uint32_t sum =
-        checksum((unsigned char*)bootconfig_start_addr, bootconfig_size);
-    memcpy_s((void *)(end + BOOTCONFIG_SIZE_SIZE), BOOTCONFIG_CHECKSUM_SIZE, &sum,
-        BOOTCONFIG_CHECKSUM_SIZE);
-
-    // magic
-    memcpy_s((void *)(end + BOOTCONFIG_SIZE_SIZE + BOOTCONFIG_CHECKSUM_SIZE),
-           BOOTCONFIG_MAGIC_SIZE, BOOTCONFIG_MAGIC, BOOTCONFIG_MAGIC_SIZE);
+    writeTrailer(bootconfig_start_addr, bootconfig_size,
+        checksum((unsigned char*)bootconfig_start_addr, bootconfig_size));
 
     return BOOTCONFIG_TRAILER_SIZE;
 }
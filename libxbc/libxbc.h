@@ -24,9 +24,9 @@
 #define BOOTCONFIG_MAGIC_SIZE 12
 #define BOOTCONFIG_SIZE_SIZE 4
 #define BOOTCONFIG_CHECKSUM_SIZE 4
-#define BOOTCONFIG_TRAILER_SIZE BOOTCONFIG_MAGIC_SIZE + \
-                                BOOTCONFIG_SIZE_SIZE + \
-                                BOOTCONFIG_CHECKSUM_SIZE
+#define BOOTCONFIG_TRAILER_SIZE (BOOTCONFIG_MAGIC_SIZE + \
+                                 BOOTCONFIG_SIZE_SIZE + \
+                                 BOOTCONFIG_CHECKSUM_SIZE)
 
 /*
  * Add a string of boot config parameters to memory appended by the trailer.
@@ -64,4 +64,55 @@ int addBootConfigParameters(char *params, uint32_t params_size,
 int addBootConfigTrailer(uint64_t bootconfig_start_addr,
                          uint32_t bootconfig_size);
 
+/*
+ * Incremental boot config section builder. The parameters are appended in
+ * place with a running checksum and the trailer is written once, when the
+ * section is finalized.
+ */
+struct BootConfigBuilder {
+    uint64_t start;     // address of the boot config section
+    uint32_t size;      // size of the parameters, trailer excluded
+    uint32_t capacity;  // bytes available at start, trailer included
+    uint32_t checksum;  // checksum of the parameters
+};
+
+/*
+ * Start building a boot config section from the bootconfig_size bytes of
+ * parameters already at bootconfig_start_addr, usually the vendor boot config.
+ * If these bytes end with a trailer, it is dropped and rewritten when the
+ * section is finalized.
+ *
+ * @param builder builder to initialize.
+ * @param bootconfig_start_addr address that the boot config section is starting
+ *        at in memory.
+ * @param bootconfig_size size of the current bootconfig section in bytes.
+ * @param capacity number of bytes available at bootconfig_start_addr for the
+ *        parameters and the trailer.
+ * @return 0 on success. -1 for error.
+ */
+int initBootConfigBuilder(struct BootConfigBuilder *builder,
+                          uint64_t bootconfig_start_addr,
+                          uint32_t bootconfig_size,
+                          uint32_t capacity);
+
+/*
+ * Append a string of boot config parameters to the section, leaving room for
+ * the trailer.
+ *
+ * @param builder builder of the section.
+ * @param params pointer to string of boot config parameters
+ * @param params_size size of params string in bytes
+ * @return number of bytes added to the boot config section. -1 for error.
+ */
+int appendBootConfigParameters(struct BootConfigBuilder *builder,
+                               const char *params, uint32_t params_size);
+
+/*
+ * Write the boot config trailer after the parameters of the section.
+ *
+ * @param builder builder of the section.
+ * @return size of the boot config section, trailer included. -1 for error.
+ */
+int finalizeBootConfig(struct BootConfigBuilder *builder);
+
 #endif /* LIBXBC_H_ */
@@ -41,6 +41,28 @@
 #include "unittest.h"
 #include "blobstore.h"
 #include "watchdog.h"
+#include "timer.h"
+#include "cmdline.h"
+#include "text_parser.h"
+#include "transport.h"
+#include "loopback.h"
+#include "ivshmem.h"
+#include "libxbc.h"
+#include "digest_cache.h"
+#include "vars.h"
+#ifdef USE_UI
+#include "upng.h"
+#endif
+#ifndef HOST_BUILD
+#include "openssl_support.h"
+#endif
+#include <openssl/evp.h>
+
+#define AVB_COMPILATION
+#include "libavb/avb_crypto.h"
+#include "libavb/avb_rsa.h"
+#include "libavb/avb_sha.h"
+#include "libavb/avb_util.h"
 
 /*
  * This is the hardware second timeout value
@@ -84,6 +106,1027 @@ static VOID test_keys(VOID)
         }
 }
 
+static UINT64 ticks_to_us(UINT64 ticks)
+{
+        UINT32 cpu_freq = get_cpu_freq();
+
+        return cpu_freq ? DivU64x32(ticks, cpu_freq, NULL) : ticks;
+}
+
+static BOOLEAN check_cmdline(struct cmdline *cl, const CHAR8 *expected)
+{
+        if (!strcmp(cmdline_str(cl), (CHAR8 *)expected) &&
+            cmdline_len(cl) == strlen((CHAR8 *)expected))
+                return TRUE;
+
+        Print(L"Got '%a' instead of '%a', ", cmdline_str(cl), expected);
+        return FALSE;
+}
+
+/* Reference implementation the command line builder replaced */
+static EFI_STATUS legacy_prepend(CHAR16 **cmdline, CHAR16 *fmt, ...)
+{
+        va_list args;
+        CHAR16 *string, *new;
+
+        va_start(args, fmt);
+        string = VPoolPrint(fmt, args);
+        va_end(args);
+        if (!string)
+                return EFI_OUT_OF_RESOURCES;
+
+        new = PoolPrint(L"%s %s", string, *cmdline);
+        FreePool(string);
+        if (!new)
+                return EFI_OUT_OF_RESOURCES;
+
+        FreePool(*cmdline);
+        *cmdline = new;
+        return EFI_SUCCESS;
+}
+
+#define CMDLINE_BENCH_SIZE      4096
+#define CMDLINE_BENCH_LOOPS     100
+#define CMDLINE_BENCH_PARAM     L"androidboot.param%d=0123456789abcdef"
+
+static VOID test_cmdline(VOID)
+{
+        struct cmdline cl;
+        CHAR16 *legacy = NULL;
+        CHAR8 *str;
+        UINT64 start, builder_ticks = 0, legacy_ticks = 0;
+        UINTN i, n, len = 0;
+        BOOLEAN ok;
+
+        if (EFI_ERROR(cmdline_init(&cl, 0, ' '))) {
+                Print(L"Allocation failed, test Failed\n");
+                return;
+        }
+        cmdline_append_stra(&cl, (CHAR8 *)"b", 1);
+        cmdline_prepend(&cl, L"a=%d", 1);
+        cmdline_prepend_stra(&cl, (CHAR8 *)"", 0);
+        cmdline_append(&cl, L"c");
+        ok = check_cmdline(&cl, (CHAR8 *)"a=1 b c");
+        cmdline_remove(&cl, cmdline_str(&cl) + 4, 2);
+        cmdline_cat_stra(&cl, (CHAR8 *)"d", 1);
+        ok = ok && check_cmdline(&cl, (CHAR8 *)"a=1 cd");
+        str = cmdline_detach(&cl);
+        ok = ok && str && !strcmp(str, (CHAR8 *)"a=1 cd");
+        if (str)
+                FreePool(str);
+        if (!ok) {
+                Print(L"test Failed\n");
+                return;
+        }
+
+        for (i = 0; i < CMDLINE_BENCH_LOOPS; i++) {
+                start = rdtsc();
+                if (EFI_ERROR(cmdline_init(&cl, EFI_PAGE_SIZE, ' ')))
+                        break;
+                for (n = 0; cmdline_len(&cl) < CMDLINE_BENCH_SIZE; n++)
+                        if (EFI_ERROR(cmdline_prepend(&cl, CMDLINE_BENCH_PARAM, n)))
+                                break;
+                builder_ticks += rdtsc() - start;
+
+                start = rdtsc();
+                legacy = PoolPrint(CMDLINE_BENCH_PARAM, 0);
+                for (n = 1; legacy && StrLen(legacy) < CMDLINE_BENCH_SIZE; n++)
+                        if (EFI_ERROR(legacy_prepend(&legacy, CMDLINE_BENCH_PARAM, n)))
+                                break;
+                legacy_ticks += rdtsc() - start;
+
+                len = cmdline_len(&cl);
+                ok = legacy && StrLen(legacy) == len;
+                for (n = 0; ok && n < len; n++)
+                        ok = legacy[n] == cmdline_str(&cl)[n];
+                cmdline_free(&cl);
+                if (legacy)
+                        FreePool(legacy);
+                if (!ok) {
+                        Print(L"Builder and legacy command lines differ, test Failed\n");
+                        return;
+                }
+        }
+
+        Print(L"cmdline_bench size=%d loops=%d builder_us=%ld legacy_us=%ld\n",
+              len, i, ticks_to_us(builder_ticks), ticks_to_us(legacy_ticks));
+        Print(L"test %a\n", i == CMDLINE_BENCH_LOOPS ? "Succeeded" : "Failed");
+}
+
+#define BOOTCONFIG_BENCH_ENTRIES        400
+#define BOOTCONFIG_BENCH_GROUP          8
+#define BOOTCONFIG_BENCH_GROUPS         (BOOTCONFIG_BENCH_ENTRIES / BOOTCONFIG_BENCH_GROUP)
+#define BOOTCONFIG_BENCH_LOOPS          100
+#define BOOTCONFIG_BENCH_SIZE           (64 * 1024)
+#define BOOTCONFIG_BENCH_PARAM          "androidboot.vendor.param%d=0123456789abcdef\n"
+
+static BOOLEAN check_bootconfig(const UINT8 *section, UINT32 size)
+{
+        UINT32 stored_size, stored_sum, sum = 0;
+        UINT32 i;
+
+        if (size < BOOTCONFIG_TRAILER_SIZE)
+                return FALSE;
+        size -= BOOTCONFIG_TRAILER_SIZE;
+
+        memcpy(&stored_size, section + size, sizeof(stored_size));
+        memcpy(&stored_sum, section + size + BOOTCONFIG_SIZE_SIZE, sizeof(stored_sum));
+        for (i = 0; i < size; i++)
+                sum += section[i];
+
+        return stored_size == size && stored_sum == sum &&
+                !memcmp(section + size + BOOTCONFIG_SIZE_SIZE + BOOTCONFIG_CHECKSUM_SIZE,
+                        BOOTCONFIG_MAGIC, BOOTCONFIG_MAGIC_SIZE);
+}
+
+/*
+ * Build a boot config section from a vendor boot config of
+ * BOOTCONFIG_BENCH_ENTRIES parameters followed by as many parameters
+ * added BOOTCONFIG_BENCH_GROUP at a time, with the builder and with
+ * one addBootConfigParameters() call per group.
+ */
+static VOID test_bootconfig(VOID)
+{
+        struct BootConfigBuilder builder;
+        UINT8 *builder_section = NULL, *legacy_section = NULL;
+        CHAR8 *vendor = NULL, *params = NULL;
+        UINTN group_end[BOOTCONFIG_BENCH_GROUPS];
+        UINTN vendor_len = 0, params_len = 0, start_offset, i, g;
+        UINT64 start, builder_ticks = 0, legacy_ticks = 0;
+        INT32 builder_size = 0, legacy_size = 0, n;
+        BOOLEAN ok = TRUE;
+
+        vendor = AllocatePool(BOOTCONFIG_BENCH_SIZE);
+        params = AllocatePool(BOOTCONFIG_BENCH_SIZE);
+        builder_section = AllocatePool(2 * BOOTCONFIG_BENCH_SIZE);
+        legacy_section = AllocatePool(2 * BOOTCONFIG_BENCH_SIZE);
+        if (!vendor || !params || !builder_section || !legacy_section) {
+                Print(L"Allocation failed, test Failed\n");
+                goto out;
+        }
+
+        for (i = 0; ok && i < BOOTCONFIG_BENCH_ENTRIES; i++) {
+                n = efi_snprintf(vendor + vendor_len, BOOTCONFIG_BENCH_SIZE - vendor_len,
+                                 (CHAR8 *)BOOTCONFIG_BENCH_PARAM, i);
+                ok = n > 0;
+                vendor_len += n;
+        }
+        for (i = 0; ok && i < BOOTCONFIG_BENCH_ENTRIES; i++) {
+                n = efi_snprintf(params + params_len, BOOTCONFIG_BENCH_SIZE - params_len,
+                                 (CHAR8 *)BOOTCONFIG_BENCH_PARAM,
+                                 BOOTCONFIG_BENCH_ENTRIES + i);
+                ok = n > 0;
+                params_len += n;
+                if ((i + 1) % BOOTCONFIG_BENCH_GROUP == 0)
+                        group_end[i / BOOTCONFIG_BENCH_GROUP] = params_len;
+        }
+        if (!ok) {
+                Print(L"Failed to build the boot config corpus, test Failed\n");
+                goto out;
+        }
+
+        for (i = 0; ok && i < BOOTCONFIG_BENCH_LOOPS; i++) {
+                memcpy(builder_section, vendor, vendor_len);
+                start = rdtsc();
+                ok = initBootConfigBuilder(&builder, (UINTN)builder_section, vendor_len,
+                                           2 * BOOTCONFIG_BENCH_SIZE) == 0;
+                for (g = 0, start_offset = 0; ok && g < BOOTCONFIG_BENCH_GROUPS; g++) {
+                        ok = appendBootConfigParameters(&builder, (char *)params + start_offset,
+                                                        group_end[g] - start_offset) >= 0;
+                        start_offset = group_end[g];
+                }
+                builder_size = ok ? finalizeBootConfig(&builder) : -1;
+                builder_ticks += rdtsc() - start;
+
+                memcpy(legacy_section, vendor, vendor_len);
+                legacy_size = vendor_len;
+                start = rdtsc();
+                for (g = 0, start_offset = 0; ok && g < BOOTCONFIG_BENCH_GROUPS; g++) {
+                        n = addBootConfigParameters((char *)params + start_offset,
+                                                    group_end[g] - start_offset,
+                                                    (UINTN)legacy_section, legacy_size);
+                        ok = n >= 0;
+                        legacy_size += n;
+                        start_offset = group_end[g];
+                }
+                legacy_ticks += rdtsc() - start;
+
+                ok = ok && builder_size > 0 && builder_size == legacy_size &&
+                        !memcmp(builder_section, legacy_section, builder_size) &&
+                        check_bootconfig(builder_section, builder_size);
+        }
+
+        Print(L"bootconfig_bench entries=%d groups=%d size=%d loops=%d builder_us=%ld legacy_us=%ld\n",
+              2 * BOOTCONFIG_BENCH_ENTRIES, BOOTCONFIG_BENCH_GROUPS, builder_size, i,
+              ticks_to_us(builder_ticks), ticks_to_us(legacy_ticks));
+        Print(L"test %a\n", ok ? "Succeeded" : "Failed");
+out:
+        if (vendor)
+                FreePool(vendor);
+        if (params)
+                FreePool(params);
+        if (builder_section)
+                FreePool(builder_section);
+        if (legacy_section)
+                FreePool(legacy_section);
+}
+
+/*
+ * The digest cache returns a digest only for the partition, image size
+ * and digest it has been stored with, evicts the oldest entry once
+ * full and drops everything recorded before a write generation bump.
+ * The cache switch is restored and the cache emptied afterwards.
+ */
+static VOID digest_cache_name(char *name, UINTN i)
+{
+        efi_snprintf((CHAR8 *)name, DIGEST_CACHE_NAME_LEN, (CHAR8 *)"part%ld", i);
+}
+
+static VOID test_digest_cache(VOID)
+{
+        UINT8 digest[DIGEST_CACHE_DIGEST_LEN], other[DIGEST_CACHE_DIGEST_LEN];
+        char name[DIGEST_CACHE_NAME_LEN];
+        BOOLEAN enabled = get_vb_digest_cache();
+        BOOLEAN ok;
+        UINTN i;
+
+        memset(digest, 0xa5, sizeof(digest));
+        memset(other, 0xa5, sizeof(other));
+        other[sizeof(other) - 1] ^= 1;
+
+        ok = !EFI_ERROR(set_vb_digest_cache(TRUE)) &&
+                !EFI_ERROR(digest_cache_invalidate());
+
+        /* Lookup */
+        ok = ok && !digest_cache_lookup("boot", 4096, digest, sizeof(digest)) &&
+                !EFI_ERROR(digest_cache_store("boot", 4096, digest, sizeof(digest))) &&
+                digest_cache_lookup("boot", 4096, digest, sizeof(digest)) &&
+                !digest_cache_lookup("boot", 8192, digest, sizeof(digest)) &&
+                !digest_cache_lookup("boot", 4096, other, sizeof(other)) &&
+                !digest_cache_lookup("boot", 4096, digest, 32) &&
+                !digest_cache_lookup("system", 4096, digest, sizeof(digest));
+        if (!ok)
+                Print(L"Digest cache lookup failed\n");
+
+        /* Eviction of the oldest entry, "boot" */
+        for (i = 1; ok && i < DIGEST_CACHE_ENTRIES; i++) {
+                digest_cache_name(name, i);
+                ok = !EFI_ERROR(digest_cache_store(name, i, digest, sizeof(digest)));
+        }
+        ok = ok && digest_cache_lookup("boot", 4096, digest, sizeof(digest));
+        digest_cache_name(name, DIGEST_CACHE_ENTRIES);
+        ok = ok && !EFI_ERROR(digest_cache_store(name, DIGEST_CACHE_ENTRIES,
+                                                 digest, sizeof(digest))) &&
+                !digest_cache_lookup("boot", 4096, digest, sizeof(digest));
+        for (i = 1; ok && i <= DIGEST_CACHE_ENTRIES; i++) {
+                digest_cache_name(name, i);
+                ok = digest_cache_lookup(name, i, digest, sizeof(digest));
+        }
+        if (!ok)
+                Print(L"Digest cache eviction failed\n");
+
+        /* Generation mismatch: the saved digests are stale */
+        ok = ok && !EFI_ERROR(digest_cache_invalidate());
+        for (i = 1; ok && i <= DIGEST_CACHE_ENTRIES; i++) {
+                digest_cache_name(name, i);
+                ok = !digest_cache_lookup(name, i, digest, sizeof(digest));
+        }
+        if (!ok)
+                Print(L"Digest cache generation check failed\n");
+
+        digest_cache_invalidate();
+        set_vb_digest_cache(enabled);
+
+        Print(L"test %a\n", ok ? "Succeeded" : "Failed");
+}
+
+/*
+ * The lines of a text fed to the parser in two fragments, split at
+ * every offset, and one byte at a time, must be the lines of the same
+ * text parsed as a single buffer.
+ */
+#define TEXT_PARSER_RECORD_SIZE 512
+
+static const char text_parser_sample[] =
+        "GUID = 4a67b082-0a4c-41cf-b6c7-440b29bb8c4f\n"
+        "  MagicKeyTimeout   40  \n"
+        "\n"
+        " \t \n"
+        "[d]blob %00%01\r\n"
+        "nul\0terminated\n"
+        "\n\n"
+        "# comment\n"
+        "   \n"
+        "unterminated tail  ";
+
+struct text_parser_record {
+        char data[TEXT_PARSER_RECORD_SIZE];
+        UINTN len;
+};
+
+static EFI_STATUS text_parser_record_line(char *line, VOID *ctx)
+{
+        struct text_parser_record *record = ctx;
+        UINTN len = strlen((CHAR8 *)line);
+
+        if (record->len + len + 1 > sizeof(record->data))
+                return EFI_BUFFER_TOO_SMALL;
+
+        memcpy(record->data + record->len, line, len);
+        record->len += len;
+        record->data[record->len++] = '\n';
+        return EFI_SUCCESS;
+}
+
+static BOOLEAN text_parser_split(const char *text, UINTN size, UINTN split,
+                                 UINTN step, const struct text_parser_record *expected)
+{
+        struct text_parser_record record = { .len = 0 };
+        struct text_parser parser;
+        EFI_STATUS ret = EFI_SUCCESS;
+        UINTN offset, len;
+
+        text_parser_init(&parser, text_parser_record_line, &record);
+        for (offset = 0; !EFI_ERROR(ret) && offset < size; offset += len) {
+                len = offset < split ? split - offset : size - offset;
+                len = min(len, step);
+                ret = text_parser_feed(&parser, text + offset, len);
+        }
+        if (EFI_ERROR(ret)) {
+                text_parser_free(&parser);
+                return FALSE;
+        }
+        ret = text_parser_finish(&parser);
+
+        return !EFI_ERROR(ret) && record.len == expected->len &&
+                !memcmp(record.data, expected->data, record.len);
+}
+
+static VOID test_textparser(VOID)
+{
+        struct text_parser_record expected = { .len = 0 };
+        char text[sizeof(text_parser_sample)];
+        UINTN size = sizeof(text_parser_sample) - 1;
+        UINTN split;
+        BOOLEAN ok;
+
+        memcpy(text, text_parser_sample, sizeof(text));
+        ok = !EFI_ERROR(parse_text_buffer(text, size, text_parser_record_line,
+                                          &expected));
+        ok = ok && expected.len > 0 &&
+                expected.data[expected.len - 1] == '\n' &&
+                !memcmp(expected.data + expected.len - sizeof("unterminated tail"),
+                        "unterminated tail\n", sizeof("unterminated tail"));
+
+        for (split = 0; ok && split <= size; split++) {
+                ok = text_parser_split(text, size, split, size, &expected);
+                if (!ok)
+                        Print(L"Split at offset %ld differs\n", split);
+        }
+
+        if (ok) {
+                ok = text_parser_split(text, size, size, 1, &expected);
+                if (!ok)
+                        Print(L"Byte per byte feed differs\n");
+        }
+
+        Print(L"test %a\n", ok ? "Succeeded" : "Failed");
+}
+
+/*
+ * Micro-benchmarks of the code which does not depend on the hardware.
+ * Inputs are generated deterministically so that results can be
+ * compared between builds.  Each result is printed as a single line:
+ * "bench name=<name> bytes=<input size> loops=<n> us=<total> kbps=<rate>"
+ * On the device the peak of the OpenSSL allocations made by the suite
+ * is printed last, the host build does not have the libsslsupport
+ * allocator.
+ */
+#define BENCH_DATA_SIZE         (1024 * 1024)
+#define BENCH_TEXT_SIZE         (64 * 1024)
+#define BENCH_LOOPS             16
+#define BENCH_RSA_LOOPS         256
+
+/* Known CRC32 of the generated data */
+#define BENCH_DATA_CRC32        0x2063a001
+
+/* Throw-away RSA-2048 key in the libavb public key format and its
+ * PKCS#1 v1.5 signature of the SHA-256 digest of the generated data */
+static const UINT8 bench_rsa_key[] = {
+        0x00, 0x00, 0x08, 0x00, 0xe7, 0xd3, 0x39, 0xd3, 0xbf, 0x65, 0x3f, 0x36,
+        0xe4, 0x2d, 0xae, 0xcd, 0x42, 0xc0, 0x0e, 0x19, 0x53, 0x5b, 0x77, 0x0b,
+        0x76, 0xb7, 0x3a, 0x04, 0xb6, 0xf7, 0x36, 0xd4, 0x22, 0x9d, 0x4d, 0x84,
+        0x3f, 0xf0, 0x10, 0x36, 0xbe, 0x84, 0x46, 0x98, 0x96, 0xd8, 0x37, 0x2a,
+        0x47, 0x27, 0x1d, 0x48, 0x3f, 0xa5, 0xbf, 0xf1, 0x53, 0xcb, 0xb8, 0xe6,
+        0xef, 0x26, 0xf6, 0xa3, 0xef, 0xc1, 0x93, 0xec, 0x5c, 0xa9, 0x51, 0xed,
+        0x49, 0x47, 0xbf, 0xef, 0xd1, 0xf5, 0x2e, 0x9e, 0xce, 0x03, 0x41, 0x6f,
+        0xef, 0x05, 0xfc, 0x80, 0x28, 0x29, 0xff, 0x36, 0x14, 0xb8, 0xfb, 0x49,
+        0x62, 0x1b, 0x7a, 0x26, 0x89, 0x43, 0x38, 0x2a, 0xef, 0x48, 0x1d, 0xe6,
+        0xa2, 0xdc, 0x42, 0x6c, 0xa1, 0x1b, 0xf9, 0x0c, 0xd1, 0x3a, 0xfe, 0x93,
+        0x4b, 0x8d, 0xa1, 0xfb, 0x4e, 0x1b, 0xaf, 0xb2, 0x8a, 0x0a, 0xbe, 0xc0,
+        0x34, 0xa2, 0xd2, 0x42, 0x1e, 0xef, 0x5a, 0x91, 0x7d, 0x2d, 0x44, 0x2d,
+        0x03, 0x3f, 0x29, 0xba, 0xfc, 0x86, 0xc5, 0xf3, 0xca, 0x4b, 0x7e, 0x3e,
+        0x18, 0xa5, 0xa7, 0x50, 0x30, 0xe4, 0xc0, 0x12, 0xdd, 0x14, 0x5b, 0x3b,
+        0xd6, 0x21, 0x4e, 0xe2, 0x90, 0xac, 0x23, 0x11, 0xe2, 0xd4, 0x30, 0xa1,
+        0x10, 0x5a, 0x19, 0x36, 0x87, 0x82, 0xc8, 0x56, 0x63, 0xea, 0x7a, 0xe5,
+        0x0f, 0x99, 0x22, 0x4f, 0xd7, 0x86, 0x80, 0xf5, 0x0b, 0x88, 0x88, 0xfb,
+        0x1f, 0xe6, 0x41, 0xc6, 0x1e, 0x94, 0xc6, 0xae, 0x78, 0x8d, 0x39, 0x88,
+        0xae, 0x32, 0x76, 0x86, 0x50, 0x16, 0xe7, 0x8c, 0xd4, 0x12, 0x90, 0xda,
+        0x8e, 0x6a, 0x7e, 0x4f, 0x60, 0xc3, 0x0b, 0x22, 0xe7, 0xf1, 0xcd, 0xe4,
+        0x54, 0x96, 0x5c, 0x27, 0x29, 0x29, 0xe6, 0x82, 0x95, 0x7f, 0x79, 0x98,
+        0x84, 0xe8, 0x22, 0xca, 0x22, 0x57, 0xa4, 0x79, 0x63, 0xfd, 0x79, 0xa5,
+        0x78, 0x63, 0xd5, 0x8d, 0xfb, 0xc1, 0x00, 0x20, 0x54, 0x8f, 0x75, 0x9d,
+        0xd7, 0xff, 0x17, 0x86, 0x97, 0x74, 0x03, 0x2d, 0xda, 0x6f, 0x64, 0xcc,
+        0x33, 0x4e, 0xbb, 0x91, 0x77, 0xed, 0x80, 0x40, 0xec, 0xcc, 0x5c, 0x5e,
+        0x0a, 0xde, 0xe8, 0x47, 0x3d, 0xce, 0x45, 0xdf, 0x82, 0x9e, 0xfc, 0x02,
+        0x29, 0x53, 0x19, 0xff, 0x7f, 0xe7, 0x2e, 0xc0, 0x71, 0xda, 0x28, 0x33,
+        0xc0, 0xaa, 0x00, 0x52, 0x7e, 0x82, 0x30, 0xd5, 0x6f, 0xae, 0xe1, 0x81,
+        0x6a, 0x2b, 0x67, 0x13, 0xfc, 0x17, 0x2a, 0x25, 0x11, 0xa9, 0x33, 0xb4,
+        0x51, 0xb9, 0x80, 0xd8, 0x29, 0x3f, 0x87, 0x59, 0xce, 0x38, 0xb7, 0xaf,
+        0x84, 0xf8, 0x85, 0x3b, 0x9e, 0x68, 0x59, 0xab, 0xcc, 0x6d, 0x43, 0x4c,
+        0xf6, 0x7d, 0x28, 0xb8, 0xfd, 0x03, 0x49, 0x1b, 0x9a, 0xac, 0xcb, 0x87,
+        0xcf, 0xd3, 0x8c, 0x2a, 0xd9, 0x92, 0x1f, 0x32, 0xe5, 0x80, 0xfc, 0x01,
+        0xbf, 0x5a, 0x30, 0x76, 0x2c, 0xf8, 0x9c, 0xfc, 0x38, 0x52, 0xfd, 0xb4,
+        0x7c, 0x9d, 0xbb, 0x6e, 0x5c, 0xb2, 0x15, 0x25, 0x30, 0x48, 0x32, 0xf9,
+        0xee, 0x95, 0x08, 0xfd, 0xf2, 0xe9, 0xe6, 0xcd, 0x20, 0x06, 0x9e, 0x93,
+        0xc5, 0xdd, 0xc2, 0xf1, 0x22, 0xa8, 0xa7, 0x3e, 0x89, 0x11, 0xd0, 0x36,
+        0x91, 0xfb, 0x51, 0xcb, 0x81, 0x41, 0xde, 0xaa, 0x3d, 0x4f, 0x63, 0x45,
+        0x70, 0x80, 0xa2, 0x7a, 0x67, 0x7e, 0xfc, 0x2e, 0x89, 0x9f, 0xbc, 0xb7,
+        0x06, 0x1e, 0x0e, 0xb6, 0xcc, 0x02, 0xd2, 0x30, 0x3f, 0x5c, 0xd9, 0x50,
+        0x40, 0x78, 0xd9, 0x16, 0x76, 0xfc, 0x22, 0xff, 0x4d, 0xcd, 0xa3, 0x47,
+        0xab, 0x74, 0x13, 0xef, 0xd4, 0xb7, 0xa1, 0xf0, 0xb1, 0xb2, 0x88, 0x43,
+        0xb8, 0x28, 0xcb, 0x91, 0xa2, 0xbd, 0xd5, 0xf9, 0x85, 0x07, 0x7e, 0x9a,
+        0x0b, 0xb9, 0x21, 0x73
+};
+
+static const UINT8 bench_rsa_sig[] = {
+        0x6d, 0x25, 0x71, 0xb4, 0xca, 0x1a, 0x62, 0x6d, 0x7e, 0xc0, 0x0e, 0xe9,
+        0x0b, 0x62, 0x73, 0x57, 0x89, 0xd8, 0xe4, 0x15, 0x4a, 0x06, 0xbb, 0x1d,
+        0x05, 0xbd, 0x61, 0x14, 0x49, 0xc4, 0x37, 0xa3, 0x05, 0xef, 0xbe, 0x14,
+        0x66, 0x39, 0xf9, 0xc5, 0x77, 0xd3, 0x1f, 0x82, 0xa6, 0x87, 0x08, 0x35,
+        0xcb, 0x9a, 0x50, 0x8b, 0x2f, 0x4f, 0x1d, 0x97, 0xee, 0x8b, 0xbd, 0x6c,
+        0xa7, 0x4b, 0x18, 0x9f, 0xa3, 0x86, 0x80, 0xae, 0xdb, 0x9f, 0xf5, 0x58,
+        0x82, 0x73, 0xd3, 0x61, 0x8a, 0x5c, 0xc5, 0xe7, 0x93, 0xcc, 0x89, 0x34,
+        0x4e, 0x1a, 0x4d, 0xd5, 0x59, 0x87, 0xa0, 0xee, 0x4a, 0xc4, 0xe1, 0x14,
+        0x9b, 0x2f, 0x83, 0x5a, 0x12, 0x05, 0x28, 0x04, 0xc5, 0xa0, 0x58, 0xb1,
+        0x47, 0xac, 0xc6, 0xfa, 0x3d, 0xad, 0x3e, 0x18, 0x34, 0x12, 0x23, 0xb9,
+        0x0c, 0x8a, 0xf0, 0xbf, 0xc8, 0xdb, 0x35, 0xc5, 0xc8, 0x87, 0xc9, 0xbe,
+        0xbb, 0x35, 0xe5, 0xfd, 0x00, 0x06, 0x98, 0xaa, 0xa0, 0x8e, 0x48, 0x2b,
+        0x97, 0x3c, 0x42, 0xd7, 0xf7, 0x07, 0x2f, 0xce, 0x83, 0x36, 0xce, 0x10,
+        0x84, 0x24, 0x72, 0x64, 0x5e, 0x03, 0x55, 0xcf, 0x97, 0x82, 0xc8, 0xb5,
+        0xe7, 0xc0, 0x57, 0x3f, 0x95, 0x0a, 0xdd, 0x3f, 0x13, 0xb7, 0x20, 0xdc,
+        0x7f, 0x1e, 0xdf, 0x6e, 0xdf, 0xd1, 0x09, 0x37, 0x3b, 0x9d, 0x44, 0xd6,
+        0x76, 0xa5, 0x20, 0x36, 0x65, 0xb4, 0x41, 0x42, 0x18, 0x17, 0x66, 0x82,
+        0x5b, 0x20, 0x4d, 0x36, 0xa4, 0xc7, 0x94, 0xef, 0xdd, 0xa8, 0x3e, 0xac,
+        0x8e, 0x95, 0x4c, 0x3d, 0x48, 0x2d, 0xa7, 0x1d, 0xa4, 0x65, 0x44, 0x76,
+        0x5d, 0x6b, 0xd7, 0xe5, 0x74, 0x02, 0x8e, 0x62, 0x1c, 0x5a, 0x20, 0x6a,
+        0xbc, 0x4c, 0x92, 0xe9, 0x00, 0xa8, 0x2a, 0x2d, 0x79, 0x30, 0xdc, 0x4c,
+        0x91, 0x33, 0xe8, 0x11
+};
+
+static void bench_report(const char *name, UINTN bytes, UINTN loops, UINT64 ticks)
+{
+        UINT64 us = ticks_to_us(ticks);
+        UINT64 kbps = 0;
+
+        if (us)
+                kbps = DivU64x32(MultU64x32((UINT64)bytes * loops / 1024, 1000000),
+                                 (UINTN)us, NULL);
+
+        Print(L"bench name=%a bytes=%d loops=%d us=%ld kbps=%ld\n",
+              name, bytes, loops, us, kbps);
+}
+
+static EFI_STATUS bench_parse_line(char *line, VOID *ctx)
+{
+        (*(UINTN *)ctx)++;
+        return line[0] ? EFI_SUCCESS : EFI_INVALID_PARAMETER;
+}
+
+static VOID test_bench(VOID)
+{
+        UINT8 *data;
+        char *text;
+        UINT32 seed = 0x12345678;
+        UINT64 start, ticks;
+        UINTN i, len, lines;
+        AvbSHA256Ctx sha256;
+        AvbSHA512Ctx sha512;
+        const AvbAlgorithmData *algo;
+        UINT8 digest[AVB_SHA256_DIGEST_SIZE];
+        UINT8 evp_digest[EVP_MAX_MD_SIZE];
+        unsigned int evp_len;
+        EVP_MD_CTX evp;
+#ifndef HOST_BUILD
+        UINTN peak_bytes, peak_chunks;
+#endif
+        int n;
+        BOOLEAN ok = TRUE;
+
+        data = AllocatePool(BENCH_DATA_SIZE);
+        text = AllocatePool(BENCH_TEXT_SIZE);
+        if (!data || !text) {
+                Print(L"Allocation failed, test Failed\n");
+                goto out;
+        }
+
+        for (i = 0; i < BENCH_DATA_SIZE; i++) {
+                seed = seed * 1103515245 + 12345;
+                data[i] = seed >> 24;
+        }
+
+#ifndef HOST_BUILD
+        mem_stats_reset_peak();
+#endif
+
+        for (len = 0, i = 0; len + 64 < BENCH_TEXT_SIZE; i++) {
+                n = efi_snprintf((CHAR8 *)text + len, BENCH_TEXT_SIZE - len,
+                                 (CHAR8 *)"  oem.var%d = value_%d_0123456789 \n",
+                                 i, i);
+                if (n <= 0) {
+                        Print(L"Failed to build the text corpus, test Failed\n");
+                        goto out;
+                }
+                len += n;
+        }
+
+        start = rdtsc();
+        for (i = 0; i < BENCH_LOOPS; i++) {
+                avb_sha256_init(&sha256);
+                avb_sha256_update(&sha256, data, BENCH_DATA_SIZE);
+                memcpy(digest, avb_sha256_final(&sha256), sizeof(digest));
+        }
+        bench_report("avb_sha256", BENCH_DATA_SIZE, BENCH_LOOPS, rdtsc() - start);
+
+        EVP_MD_CTX_init(&evp);
+        start = rdtsc();
+        for (i = 0; ok && i < BENCH_LOOPS; i++) {
+                ok = EVP_DigestInit_ex(&evp, EVP_sha256(), NULL) &&
+                        EVP_DigestUpdate(&evp, data, BENCH_DATA_SIZE) &&
+                        EVP_DigestFinal_ex(&evp, evp_digest, &evp_len);
+        }
+        ticks = rdtsc() - start;
+        EVP_MD_CTX_cleanup(&evp);
+        if (!ok || evp_len != sizeof(digest) || memcmp(evp_digest, digest, sizeof(digest))) {
+                Print(L"EVP sha256 mismatch, test Failed\n");
+                goto out;
+        }
+        bench_report("evp_sha256", BENCH_DATA_SIZE, BENCH_LOOPS, ticks);
+
+        start = rdtsc();
+        for (i = 0; i < BENCH_LOOPS; i++) {
+                avb_sha512_init(&sha512);
+                avb_sha512_update(&sha512, data, BENCH_DATA_SIZE);
+                (void)avb_sha512_final(&sha512);
+        }
+        bench_report("avb_sha512", BENCH_DATA_SIZE, BENCH_LOOPS, rdtsc() - start);
+
+        ticks = 0;
+        for (i = 0; ok && i < BENCH_LOOPS; i++) {
+                start = rdtsc();
+                ok = avb_crc32(data, BENCH_DATA_SIZE) == BENCH_DATA_CRC32;
+                ticks += rdtsc() - start;
+        }
+        if (!ok) {
+                Print(L"avb_crc32 mismatch, test Failed\n");
+                goto out;
+        }
+        bench_report("avb_crc32", BENCH_DATA_SIZE, BENCH_LOOPS, ticks);
+
+        algo = avb_get_algorithm_data(AVB_ALGORITHM_TYPE_SHA256_RSA2048);
+        ticks = 0;
+        for (i = 0; ok && i < BENCH_RSA_LOOPS; i++) {
+                start = rdtsc();
+                ok = avb_rsa_verify(bench_rsa_key, sizeof(bench_rsa_key),
+                                    bench_rsa_sig, sizeof(bench_rsa_sig),
+                                    digest, sizeof(digest),
+                                    algo->padding, algo->padding_len);
+                ticks += rdtsc() - start;
+        }
+        if (!ok) {
+                Print(L"avb_rsa_verify failed, test Failed\n");
+                goto out;
+        }
+        bench_report("avb_rsa2048_verify", sizeof(bench_rsa_sig), BENCH_RSA_LOOPS, ticks);
+
+        ticks = 0;
+        for (i = 0; ok && i < BENCH_LOOPS; i++) {
+                lines = 0;
+                start = rdtsc();
+                ok = !EFI_ERROR(parse_text_buffer(text, len, bench_parse_line, &lines));
+                ticks += rdtsc() - start;
+        }
+        if (ok)
+                bench_report("parse_text_buffer", len, BENCH_LOOPS, ticks);
+
+#ifdef USE_UI
+        {
+                ui_image_t *img = ui_image_get("splash_intel");
+                EFI_GRAPHICS_OUTPUT_BLT_PIXEL *blt;
+                UINTN width, height;
+
+                ticks = 0;
+                for (i = 0; img && ok && i < BENCH_LOOPS; i++) {
+                        start = rdtsc();
+                        ok = !EFI_ERROR(upng_load((const char *)img->data, img->size,
+                                                  &blt, &width, &height));
+                        ticks += rdtsc() - start;
+                        if (ok)
+                                FreePool(blt);
+                }
+                if (img && ok)
+                        bench_report("upng_load", img->size, BENCH_LOOPS, ticks);
+        }
+#endif
+
+#ifndef HOST_BUILD
+        mem_stats_get_peak(&peak_bytes, &peak_chunks);
+        Print(L"malloc_bench peak_bytes=%ld peak_chunks=%ld\n", peak_bytes, peak_chunks);
+#endif
+
+        Print(L"test %a\n", ok ? "Succeeded" : "Failed");
+out:
+        if (data)
+                FreePool(data);
+        if (text)
+                FreePool(text);
+}
+
+/*
+ * The loopback peer sends a fixed chunk over and over and the device
+ * side echoes each chunk back, so the whole transport path is
+ * exercised in both directions.
+ */
+#define LOOPBACK_CHUNK          (16 * 1024)
+#define LOOPBACK_TOTAL          (64 * 1024 * 1024)
+
+static struct {
+        UINT8 *data;
+        UINT8 *rx_buf;
+        UINTN sent;
+        UINTN received;
+        BOOLEAN corrupted;
+} lb;
+
+static EFI_STATUS lb_peer_poll(void)
+{
+        if (lb.sent == LOOPBACK_TOTAL)
+                return EFI_NOT_READY;
+
+        lb.sent += LOOPBACK_CHUNK;
+        return loopback_send(lb.data, LOOPBACK_CHUNK);
+}
+
+static void lb_peer_receive(void *buf, UINT32 size)
+{
+        if (size != LOOPBACK_CHUNK || CompareMem(buf, lb.data, size))
+                lb.corrupted = TRUE;
+        lb.received += size;
+}
+
+static void lb_start_cb(void)
+{
+        transport_read(lb.rx_buf, LOOPBACK_CHUNK);
+}
+
+static void lb_rx_cb(void *buf, unsigned len)
+{
+        transport_write(buf, len);
+}
+
+static void lb_tx_cb(__attribute__((__unused__)) void *buf,
+                     __attribute__((__unused__)) unsigned len)
+{
+        transport_read(lb.rx_buf, LOOPBACK_CHUNK);
+}
+
+static VOID test_loopback(VOID)
+{
+        static loopback_peer_t peer = {
+                .poll = lb_peer_poll,
+                .receive = lb_peer_receive
+        };
+        static transport_t LOOPBACK_TRANSPORT[] = {
+                {
+                        .name = "Loopback for unittest",
+                        .start = loopback_start,
+                        .stop = loopback_stop,
+                        .run = loopback_run,
+                        .read = loopback_read,
+                        .write = loopback_write
+                }
+        };
+        EFI_STATUS ret;
+        UINT64 start, ticks;
+        UINTN i;
+
+        ZeroMem(&lb, sizeof(lb));
+        lb.data = AllocatePool(LOOPBACK_CHUNK);
+        lb.rx_buf = AllocatePool(LOOPBACK_CHUNK);
+        if (!lb.data || !lb.rx_buf) {
+                Print(L"Allocation failed, ");
+                ret = EFI_OUT_OF_RESOURCES;
+                goto out;
+        }
+        for (i = 0; i < LOOPBACK_CHUNK; i++)
+                lb.data[i] = i * 7;
+
+        ret = loopback_attach(&peer);
+        if (EFI_ERROR(ret))
+                goto out;
+
+        ret = transport_register(LOOPBACK_TRANSPORT, ARRAY_SIZE(LOOPBACK_TRANSPORT));
+        if (EFI_ERROR(ret))
+                goto detach;
+
+        ret = transport_start(lb_start_cb, lb_rx_cb, lb_tx_cb);
+        if (EFI_ERROR(ret))
+                goto unregister;
+
+        start = rdtsc();
+        while (!EFI_ERROR(ret) && !lb.corrupted && lb.received < LOOPBACK_TOTAL)
+                ret = transport_run();
+        ticks = rdtsc() - start;
+        transport_stop();
+
+        if (!EFI_ERROR(ret) && !lb.corrupted)
+                bench_report("loopback", LOOPBACK_CHUNK,
+                             LOOPBACK_TOTAL / LOOPBACK_CHUNK, ticks);
+        else if (lb.corrupted)
+                Print(L"Data corrupted, ");
+
+unregister:
+        transport_unregister();
+detach:
+        loopback_detach();
+out:
+        if (lb.data)
+                FreePool(lb.data);
+        if (lb.rx_buf)
+                FreePool(lb.rx_buf);
+        Print(L"test %a\n", !EFI_ERROR(ret) && !lb.corrupted ? "Succeeded" : "Failed");
+}
+
+/*
+ * The ivshmem peer plays the host side of the rollback index page: it
+ * handles the requests as soon as the doorbell rings and keeps the
+ * rollback indexes in memory.  The round trip of a batch of reads is
+ * measured with and without the request queue.
+ */
+#define IVSHMEM_BATCH_MAX       32
+#define IVSHMEM_LOOPS           1000
+
+static struct {
+        UINT8 *page;
+        UINT64 index[IVSHMEM_BATCH_MAX];
+} ivp;
+
+/* Like the host, report failures with a negative value */
+#define IVP_ERROR               (-1)
+
+static void ivp_handle(struct tpm2_int_req *req)
+{
+        size_t slot;
+
+        if (req->size < sizeof(slot) + sizeof(UINT64)) {
+                req->ret = IVP_ERROR;
+                return;
+        }
+
+        memcpy(&slot, req->payload, sizeof(slot));
+        if (slot >= IVSHMEM_BATCH_MAX) {
+                req->ret = IVP_ERROR;
+                return;
+        }
+
+        switch (req->cmd) {
+        case TEE_TPM2_READ_ROLLBACK_INDEX:
+                memcpy(req->payload + sizeof(slot), &ivp.index[slot], sizeof(UINT64));
+                break;
+        case TEE_TPM2_WRITE_ROLLBACK_INDEX:
+                memcpy(&ivp.index[slot], req->payload + sizeof(slot), sizeof(UINT64));
+                break;
+        default:
+                req->ret = IVP_ERROR;
+                return;
+        }
+        req->ret = EFI_SUCCESS;
+}
+
+static void ivp_doorbell(UINT32 vector)
+{
+        struct ivshmem_queue *queue = (struct ivshmem_queue *)ivp.page;
+        struct tpm2_int_req *req;
+        UINTN i, offset;
+
+        if (vector != IVSHMEM_BATCH_INTERRUPT) {
+                ivp_handle((struct tpm2_int_req *)ivp.page);
+                return;
+        }
+
+        for (i = 0, offset = 0; i < queue->count; i++) {
+                req = (struct tpm2_int_req *)(queue->reqs + offset);
+                ivp_handle(req);
+                offset += (sizeof(*req) + req->size + IVSHMEM_QUEUE_ALIGN - 1) &
+                        ~(IVSHMEM_QUEUE_ALIGN - 1);
+        }
+        queue->done = queue->seq;
+}
+
+static BOOLEAN ivp_run(BOOLEAN batched, struct tpm2_int_req **reqs, UINTN count)
+{
+        struct ivshmem_queue *queue = (struct ivshmem_queue *)ivp.page;
+        UINT64 start, value;
+        EFI_STATUS ret;
+        UINTN i, loop;
+
+        queue->magic = batched ? IVSHMEM_QUEUE_MAGIC : 0;
+        if (ivshmem_batch_supported() != batched) {
+                Print(L"Queue detection mismatch, ");
+                return FALSE;
+        }
+
+        start = rdtsc();
+        for (loop = 0; loop < IVSHMEM_LOOPS; loop++) {
+                ret = ivshmem_rollback_index_batch(reqs, count);
+                if (EFI_ERROR(ret)) {
+                        Print(L"Batch failed: %r, ", ret);
+                        return FALSE;
+                }
+        }
+        start = rdtsc() - start;
+
+        for (i = 0; i < count; i++) {
+                memcpy(&value, reqs[i]->payload + sizeof(size_t), sizeof(value));
+                if (reqs[i]->ret != EFI_SUCCESS || value != ivp.index[i]) {
+                        Print(L"Request %d got a wrong answer, ", i);
+                        return FALSE;
+                }
+        }
+
+        Print(L"ivshmem_bench mode=%a batch=%d loops=%d us=%ld\n",
+              batched ? "queue" : "single", count, IVSHMEM_LOOPS,
+              ticks_to_us(start));
+        return TRUE;
+}
+
+static VOID test_ivshmem(VOID)
+{
+        static ivshmem_peer_t peer = {
+                .doorbell = ivp_doorbell
+        };
+        struct tpm2_int_req *reqs[IVSHMEM_BATCH_MAX] = { NULL };
+        BOOLEAN ok = FALSE;
+        size_t slot;
+        UINTN i, count;
+
+        ZeroMem(&ivp, sizeof(ivp));
+        ivp.page = AllocateZeroPool(IVSHMEM_QUEUE_SIZE);
+        if (!ivp.page) {
+                Print(L"Allocation failed, ");
+                goto out;
+        }
+
+        for (slot = 0; slot < IVSHMEM_BATCH_MAX; slot++) {
+                ivp.index[slot] = slot * 3 + 1;
+                reqs[slot] = AllocateZeroPool(sizeof(*reqs[slot]) + sizeof(slot) +
+                                              sizeof(UINT64));
+                if (!reqs[slot]) {
+                        Print(L"Allocation failed, ");
+                        goto out;
+                }
+                reqs[slot]->cmd = TEE_TPM2_READ_ROLLBACK_INDEX;
+                reqs[slot]->size = sizeof(slot) + sizeof(UINT64);
+                memcpy(reqs[slot]->payload, &slot, sizeof(slot));
+        }
+
+        peer.page = ivp.page;
+        ivshmem_attach(&peer);
+        for (ok = TRUE, count = 1; ok && count <= IVSHMEM_BATCH_MAX; count *= 2)
+                ok = ivp_run(FALSE, reqs, count) && ivp_run(TRUE, reqs, count);
+        ivshmem_detach();
+
+out:
+        for (i = 0; i < IVSHMEM_BATCH_MAX; i++)
+                if (reqs[i])
+                        FreePool(reqs[i]);
+        if (ivp.page)
+                FreePool(ivp.page);
+        Print(L"test %a\n", ok ? "Succeeded" : "Failed");
+}
+
+/* Reference floating point implementation ui_bilinear_scale() replaced */
+static void legacy_bilinear_scale(unsigned char *s, unsigned char *d,
+                                  int sx, int sy, int dx, int dy,
+                                  int depth)
+{
+        double ratio_x = (double)(sx - 1) / dx;
+        double ratio_y = (double)(sy - 1) / dy;
+        int i, j, k;
+        sx *= depth;
+        for (i = 0; i < dy; i++ )
+                for (j = 0; j < dx; j++) {
+                        double x = j * ratio_x;
+                        double y = i * ratio_y;
+                        int x1 = x;
+                        int x2 = x1 + 1;
+                        int y1 = y;
+                        int y2 = y1 + 1;
+                        for (k = 0; k < depth; k++) {
+                                d[j * depth + i * dx * depth + k] = (1 / ((x2 - x1) * (y2 - y1))) *
+                                        (s[x1 * depth + y1 * sx + k] * (x2 - x) * (y2 - y) +
+                                         s[x2 * depth + y1 * sx + k] * (x - x1) * (y2 - y) +
+                                         s[x1 * depth + y2 * sx + k] * (x2 - x) * (y - y1) +
+                                         s[x2 * depth + y2 * sx + k] * (x - x1) * (y - y1));
+                        }
+                }
+}
+
+static const struct {
+        UINTN sx, sy, dx, dy;
+} SCALE_CASES[] = {
+        { 320, 240, 1280, 960 },        /* Upscale */
+        { 1280, 720, 427, 240 },        /* Downscale */
+        { 217, 61, 3840, 1080 },        /* Odd ratios, 4K width */
+        { 64, 64, 64, 64 }              /* Identity */
+};
+
+static VOID test_scale(VOID)
+{
+        EFI_GRAPHICS_OUTPUT_BLT_PIXEL *src = NULL, *fixed = NULL, *legacy = NULL;
+        UINT64 start, fixed_ticks, legacy_ticks;
+        UINT32 seed = 0x12345678;
+        UINTN i, n, size, max_diff;
+        INTN diff;
+        unsigned char *a, *b;
+        EFI_STATUS ret;
+
+        for (i = 0; i < ARRAY_SIZE(SCALE_CASES); i++) {
+                src = AllocatePool(ui_get_blt_size(SCALE_CASES[i].sx, SCALE_CASES[i].sy));
+                fixed = AllocatePool(ui_get_blt_size(SCALE_CASES[i].dx, SCALE_CASES[i].dy));
+                legacy = AllocatePool(ui_get_blt_size(SCALE_CASES[i].dx, SCALE_CASES[i].dy));
+                if (!src || !fixed || !legacy) {
+                        Print(L"Allocation failed, ");
+                        break;
+                }
+
+                a = (unsigned char *)src;
+                size = ui_get_blt_size(SCALE_CASES[i].sx, SCALE_CASES[i].sy);
+                for (n = 0; n < size; n++) {
+                        seed = seed * 1103515245 + 12345;
+                        a[n] = seed >> 24;
+                }
+
+                start = rdtsc();
+                ret = ui_bilinear_scale(src, fixed, SCALE_CASES[i].sx, SCALE_CASES[i].sy,
+                                        SCALE_CASES[i].dx, SCALE_CASES[i].dy);
+                fixed_ticks = rdtsc() - start;
+                if (EFI_ERROR(ret)) {
+                        Print(L"Scale failed: %r, ", ret);
+                        break;
+                }
+
+                start = rdtsc();
+                legacy_bilinear_scale((unsigned char *)src, (unsigned char *)legacy,
+                                      SCALE_CASES[i].sx, SCALE_CASES[i].sy,
+                                      SCALE_CASES[i].dx, SCALE_CASES[i].dy,
+                                      sizeof(*src));
+                legacy_ticks = rdtsc() - start;
+
+                a = (unsigned char *)fixed;
+                b = (unsigned char *)legacy;
+                size = ui_get_blt_size(SCALE_CASES[i].dx, SCALE_CASES[i].dy);
+                for (n = 0, max_diff = 0; n < size; n++) {
+                        diff = (INTN)a[n] - (INTN)b[n];
+                        if (diff < 0)
+                                diff = -diff;
+                        max_diff = max(max_diff, (UINTN)diff);
+                }
+
+                Print(L"scale_bench src=%dx%d dst=%dx%d fixed_us=%ld legacy_us=%ld max_diff=%d\n",
+                      SCALE_CASES[i].sx, SCALE_CASES[i].sy,
+                      SCALE_CASES[i].dx, SCALE_CASES[i].dy,
+                      ticks_to_us(fixed_ticks), ticks_to_us(legacy_ticks), max_diff);
+                if (max_diff > 1) {
+                        Print(L"Fixed point output differs by more than 1, ");
+                        break;
+                }
+
+                FreePool(src);
+                FreePool(fixed);
+                FreePool(legacy);
+                src = fixed = legacy = NULL;
+        }
+
+        if (src)
+                FreePool(src);
+        if (fixed)
+                FreePool(fixed);
+        if (legacy)
+                FreePool(legacy);
+        Print(L"test %a\n", i == ARRAY_SIZE(SCALE_CASES) ? "Succeeded" : "Failed");
+}
+
 #ifdef USE_UI
 static UINT8 fake_hash[] = {0x12, 0x34, 0x56, 0x78, 0x90, 0xAB};
 
@@ -114,7 +1157,15 @@ static struct test_suite {
 #ifdef USE_UI
         { L"ux", test_ux },
 #endif
+        { L"scale", test_scale },
         { L"keys", test_keys },
+        { L"cmdline", test_cmdline },
+        { L"bootconfig", test_bootconfig },
+        { L"bench", test_bench },
+        { L"textparser", test_textparser },
+        { L"digestcache", test_digest_cache },
+        { L"loopback", test_loopback },
+        { L"ivshmem", test_ivshmem },
         { L"watchdog", test_watchdog }
 };
 